@@ -64,6 +64,22 @@
 #include <task.h>
 #endif
 
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS)
+#include <semphr.h>
+#elif defined(MB_ARDUINO_PICO)
+#include <pico/mutex.h>
+#elif !defined(ARDUINO)
+#include <mutex>
+#include <pthread.h>
+#include <poll.h>
+#define FIREBASE_HOST_MUTEX
+// the stream task of host build is the thread that waits for the sockets with poll
+#define FIREBASE_HOST_STREAM_TASK
+#endif
+
 #if defined(ESP32)
 #if defined(ESP_ARDUINO_VERSION)
 #if ESP_ARDUINO_VERSION > ESP_ARDUINO_VERSION_VAL(2, 0, 1)
@@ -72,7 +88,10 @@
 #endif
 #endif
 
+// The port of RTDB and FCM servers, the host tests use the plain HTTP port
+#if !defined(FIREBASE_PORT)
 #define FIREBASE_PORT 443
+#endif
 
 #define MAX_REDIRECT 5
 
@@ -94,6 +113,22 @@
 #define MIN_RTDB_STREAM_RECONNECT_INTERVAL 1000
 #define MAX_RTDB_STREAM_RECONNECT_INTERVAL 60 * 1000
 
+// The longest time that the stream task waits for the stream data before checking the
+// stream timeout, reconnection and the token of the idle streams
+#if !defined(FIREBASE_STREAM_IDLE_CHECK_INTERVAL)
+#define FIREBASE_STREAM_IDLE_CHECK_INTERVAL 1000
+#endif
+
+// The time that the stream task waits for the free slot of the stream event queue with block policy
+#if !defined(FIREBASE_STREAM_QUEUE_BLOCK_TIMEOUT)
+#define FIREBASE_STREAM_QUEUE_BLOCK_TIMEOUT 5000
+#endif
+
+// The shortest time between the automatic writes of the changed TLS sessions to the session cache file
+#if !defined(FIREBASE_SSL_SESSION_CACHE_SAVE_INTERVAL)
+#define FIREBASE_SSL_SESSION_CACHE_SAVE_INTERVAL 60 * 1000
+#endif
+
 #define MIN_RTDB_STREAM_ERROR_NOTIFIED_INTERVAL 3 * 1000
 #define MAX_RTDB_STREAM_ERROR_NOTIFIED_INTERVAL 30 * 1000
 
@@ -116,9 +151,41 @@
 
 #define SD_CS_PIN 15
 
+#if defined(FIREBASE_HOST_STREAM_TASK)
+#define STREAM_TASK_STACK_SIZE (256 * 1024)
+#else
 #define STREAM_TASK_STACK_SIZE 8192
+#endif
 #define QUEUE_TASK_STACK_SIZE 8192
 #define MAX_BLOB_PAYLOAD_SIZE 1024
+#define MAX_DELETE_NODES_PER_QUERY 30
+#if !defined(FIREBASE_TCP_CORK_BUFFER_SIZE)
+#define FIREBASE_TCP_CORK_BUFFER_SIZE 2048
+#endif
+// The stack buffer for base64 encoding and decoding, multiple of 24 bytes
+#define FIREBASE_BASE64_BLOCK_SIZE 192
+// The binary bytes per chunk node of the chunked file storage, the encoded chunk should fit the response buffer
+#if !defined(FIREBASE_RTDB_FILE_CHUNK_SIZE)
+#define FIREBASE_RTDB_FILE_CHUNK_SIZE 3072
+#endif
+// The number of retries of the chunk download before the chunked file download fails
+#if !defined(FIREBASE_RTDB_FILE_CHUNK_RETRY)
+#define FIREBASE_RTDB_FILE_CHUNK_RETRY 3
+#endif
+// The smallest write size of the adaptive upload
+#define FIREBASE_RTDB_MIN_UPLOAD_CHUNK 256
+// The default total size and segment size of the offline journal files
+#if !defined(FIREBASE_RTDB_JOURNAL_MAX_SIZE)
+#define FIREBASE_RTDB_JOURNAL_MAX_SIZE 65536
+#endif
+#if !defined(FIREBASE_RTDB_JOURNAL_SEGMENT_SIZE)
+#define FIREBASE_RTDB_JOURNAL_SEGMENT_SIZE 8192
+#endif
+#define FIREBASE_RTDB_JOURNAL_MIN_SEGMENT_SIZE 512
+// The default memory size of all stream replicas
+#if !defined(FIREBASE_RTDB_REPLICA_MAX_SIZE)
+#define FIREBASE_RTDB_REPLICA_MAX_SIZE 16384
+#endif
 #define FIREBASE_DEFAULT_TS 1618971013
 #define FIREBASE_NON_TS -1000
 #define ESP_REPORT_PROGRESS_INTERVAL 2
@@ -767,6 +834,8 @@ struct server_response_data_t
     bool noContent = false;
     bool eventPathChanged = false;
     bool dataChanged = false;
+    // the hash of payload or event data, updated while the payload chunks were read
+    uint32_t dataHash = 0;
     bool redirect = false;
     MB_String location;
     MB_String contentType;
@@ -780,6 +849,29 @@ struct server_response_data_t
     MB_String transferEnc;
 };
 
+// The slice of data in the parsing buffer
+struct firebase_span_t
+{
+    int ofs = 0;
+    int len = 0;
+};
+
+// The server-sent event parsed from stream payload buffer
+struct firebase_sse_event_t
+{
+    // the value of event field e.g. put, patch, keep-alive
+    firebase_span_t type;
+    // the path in data field JSON
+    firebase_span_t path;
+    // the data in data field JSON or the whole data field value if it has no path
+    firebase_span_t data;
+    bool hasPath = false;
+    // the braces and brackets in data field are balanced
+    bool valid = false;
+    // the hash of data slice, computed while the data field was scanned
+    uint32_t hash = 0;
+};
+
 struct firebase_chunk_state_info
 {
     int state = 0;
@@ -870,6 +962,8 @@ typedef struct firebase_rtdb_upload_status_info_t
     MB_String remotePath;
     int size = 0;
     int elapsedTime = 0;
+    // the average upload throughput of the transfer in bytes per second
+    uint32_t throughput = 0;
     MB_String errorMsg;
 
 } RTDB_UploadStatusInfo;
@@ -889,6 +983,125 @@ typedef struct firebase_rtdb_download_status_info_t
 typedef void (*RTDB_UploadProgressCallback)(RTDB_UploadStatusInfo);
 typedef void (*RTDB_DownloadProgressCallback)(RTDB_DownloadStatusInfo);
 
+typedef struct firebase_rtdb_async_result_info_t
+{
+    // the request ID which is the value of FirebaseData::asyncRequestID() after the request was sent
+    uint32_t id = 0;
+    firebase_request_method method = http_put;
+    MB_String path;
+    // the HTTP status code or negative error code when the connection was lost before the response was received
+    int httpCode = 0;
+    MB_String errorMsg;
+
+} RTDB_AsyncResultInfo;
+
+typedef void (*RTDB_AsyncResultCallback)(RTDB_AsyncResultInfo);
+
+enum firebase_rtdb_pipeline_read_state
+{
+    firebase_rtdb_pipeline_read_status,
+    firebase_rtdb_pipeline_read_header,
+    firebase_rtdb_pipeline_read_body,
+    firebase_rtdb_pipeline_read_chunk_size,
+    firebase_rtdb_pipeline_read_chunk_data,
+    firebase_rtdb_pipeline_read_trailer
+};
+
+// The async requests that were sent on the keep-alive connection and waiting for their responses
+// which the server replies in the same order (HTTP/1.1 pipelining).
+struct firebase_rtdb_pipeline_info_t
+{
+    bool enable = false;
+    uint8_t max_in_flight = 4;
+    uint32_t last_id = 0;
+    MB_VECTOR<RTDB_AsyncResultInfo> pending;
+    RTDB_AsyncResultCallback cb = NULL;
+
+    // the response parser states
+    firebase_rtdb_pipeline_read_state state = firebase_rtdb_pipeline_read_status;
+    int http_code = 0;
+    int remaining = 0;
+    bool chunked = false;
+    bool close = false;
+    MB_String line;
+    MB_String body;
+};
+
+// The pre-rendered request header of the last request (method and path) which the
+// token is inserted between head and mid, and the per-request headers are appended after tail.
+struct firebase_rtdb_header_template_t
+{
+    // the key, gen 0 is not valid
+    uint16_t gen = 0;
+    firebase_request_method method = http_get;
+    bool async = false;
+    bool classic = false;
+    int read_tmo = -1;
+    MB_String path;
+    MB_String write_limit;
+
+    // 0 no token, 1 token in auth query parameter, 2 token in Authorization header
+    uint8_t auth = 0;
+    MB_String head;
+    MB_String mid;
+    MB_String tail;
+};
+
+// The adaptive write size of the upload
+struct firebase_rtdb_upload_rate_t
+{
+    // the allocated buffer size which is the largest write size
+    size_t max = 0;
+    size_t chunk = 0;
+    // the throughput of the last write in bytes per second
+    uint32_t rate = 0;
+};
+
+// The manifest node of the chunked file
+struct firebase_rtdb_file_manifest_t
+{
+    size_t size = 0;
+    size_t chunkSize = 0;
+    size_t count = 0;
+    uint32_t crc = 0;
+    // the hex string of SHA-256 digest
+    MB_String sha256;
+    bool complete = false;
+    // the manifest exists and its count matches the size and chunk size
+    bool valid = false;
+};
+
+// The policy of the full stream event queue
+enum firebase_rtdb_stream_queue_policy
+{
+    // remove the oldest event to add the new event
+    firebase_rtdb_stream_queue_policy_drop_oldest,
+    // remove the queued events of the put event path and its children, or the oldest event when none
+    firebase_rtdb_stream_queue_policy_coalesce,
+    // wait for the free slot, the new event is dropped when the wait timed out
+    firebase_rtdb_stream_queue_policy_block
+};
+
+// The record operation in the error queue file
+enum firebase_rtdb_queue_record_op
+{
+    firebase_rtdb_queue_record_add = 1,
+    firebase_rtdb_queue_record_remove = 2
+};
+
+// The offline journal segment file information
+struct firebase_rtdb_journal_segment_t
+{
+    uint32_t seq = 0;
+    size_t size = 0;
+    // the sequence numbers of the first and last written records
+    uint32_t minAdd = 0;
+    uint32_t maxAdd = 0;
+    // the sequence number of the last replayed record
+    uint32_t done = 0;
+    bool corrupted = false;
+};
+
 struct firebase_rtdb_request_info_t
 {
     MB_String path;
@@ -908,6 +1121,7 @@ struct firebase_rtdb_request_info_t
     uint8_t storageType = StorageType::UNDEFINED;
 #endif
     int progress = -1;
+    uint32_t throughput = 0;
     RTDB_UploadStatusInfo *uploadStatusInfo = nullptr;
     RTDB_DownloadStatusInfo *downloadStatusInfo = nullptr;
     RTDB_UploadProgressCallback uploadCallback = NULL;
@@ -981,6 +1195,28 @@ struct firebase_auth_cert_t
 #endif
 };
 
+struct firebase_ssl_session_cache_config_t
+{
+    // The file to keep the TLS sessions across reboot or deep sleep, the sessions are kept in memory only if not set.
+    MB_String file;
+#if defined(FIREBASE_ESP_CLIENT)
+    firebase_mem_storage_type file_storage = mem_storage_type_flash;
+#else
+    uint8_t file_storage = StorageType::FLASH;
+#endif
+};
+
+struct firebase_token_cache_config_t
+{
+    // The file to keep the OAuth2.0 access token and its expiry time across reboot or deep sleep.
+    MB_String file;
+#if defined(FIREBASE_ESP_CLIENT)
+    firebase_mem_storage_type file_storage = mem_storage_type_flash;
+#else
+    uint8_t file_storage = StorageType::FLASH;
+#endif
+};
+
 struct firebase_service_account_file_info_t
 {
     MB_String path;
@@ -1062,6 +1298,106 @@ struct firebase_stream_info_t
 };
 #endif
 
+/** The recursive mutex which protects the state that shared by the tasks.
+ *
+ * It is the FreeRTOS recursive mutex on ESP32 and Pico with FreeRTOS, the pico-sdk recursive mutex
+ * on Pico without FreeRTOS and the std::recursive_mutex on the host, the single task devices e.g. ESP8266
+ * have no lock.
+ */
+class firebase_mutex
+{
+public:
+    firebase_mutex() { create(); }
+    // the copy owns its new lock
+    firebase_mutex(const firebase_mutex &) { create(); }
+    ~firebase_mutex()
+    {
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+        if (handle)
+            vSemaphoreDelete(handle);
+        handle = NULL;
+#endif
+    }
+    firebase_mutex &operator=(const firebase_mutex &) { return *this; }
+
+    void lock()
+    {
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+        if (handle)
+            xSemaphoreTakeRecursive(handle, portMAX_DELAY);
+#elif defined(MB_ARDUINO_PICO)
+        recursive_mutex_enter_blocking(&handle);
+#elif defined(FIREBASE_HOST_MUTEX)
+        handle.lock();
+#endif
+    }
+
+    // take the lock only when it is free or already owned by the caller
+    bool tryLock()
+    {
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+        return !handle || xSemaphoreTakeRecursive(handle, 0) == pdTRUE;
+#elif defined(MB_ARDUINO_PICO)
+        return recursive_mutex_try_enter(&handle, NULL);
+#elif defined(FIREBASE_HOST_MUTEX)
+        return handle.try_lock();
+#else
+        return true;
+#endif
+    }
+
+    void unlock()
+    {
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+        if (handle)
+            xSemaphoreGiveRecursive(handle);
+#elif defined(MB_ARDUINO_PICO)
+        recursive_mutex_exit(&handle);
+#elif defined(FIREBASE_HOST_MUTEX)
+        handle.unlock();
+#endif
+    }
+
+private:
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+    SemaphoreHandle_t handle = NULL;
+#elif defined(MB_ARDUINO_PICO)
+    recursive_mutex_t handle;
+#elif defined(FIREBASE_HOST_MUTEX)
+    std::recursive_mutex handle;
+#endif
+
+    void create()
+    {
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+        handle = xSemaphoreCreateRecursiveMutex();
+#elif defined(MB_ARDUINO_PICO)
+        recursive_mutex_init(&handle);
+#endif
+    }
+};
+
+/** Hold the mutex until going out of scope, the mutex is not taken when locked is false.
+ */
+class firebase_mutex_guard
+{
+public:
+    firebase_mutex_guard(firebase_mutex &mutex, bool locked = true) : mutex(mutex), locked(locked)
+    {
+        if (locked)
+            mutex.lock();
+    }
+    ~firebase_mutex_guard()
+    {
+        if (locked)
+            mutex.unlock();
+    }
+
+private:
+    firebase_mutex &mutex;
+    bool locked;
+};
+
 struct firebase_session_info
 {
     uint32_t ptr = 0;
@@ -1078,6 +1414,7 @@ struct firebase_cfg_int_t
         base_time_type_user = 2
     };
 
+    // the processing state of the auth token and FCM requests which use the shared TCP client
     bool fb_processing = false;
     bool fb_rtoken_requested = false;
     uint8_t fb_stream_idx = 0;
@@ -1100,6 +1437,14 @@ struct firebase_cfg_int_t
     bool fb_auth_uri = false;
     MB_VECTOR<firebase_session_info> sessions;
     MB_VECTOR<firebase_session_info> queueSessions;
+    // protects the sessions and queueSessions lists
+    firebase_mutex session_mutex;
+    // protects the auth tokens
+    firebase_mutex token_mutex;
+    // held by the task that processes the token request, other tasks skip the processing
+    firebase_mutex token_task_mutex;
+    // held while a file is opened, MB_FS has only one file of each storage type
+    firebase_mutex file_mutex;
 
     MB_String auth_token;
     MB_String refresh_token;
@@ -1122,6 +1467,7 @@ struct firebase_cfg_int_t
 
     TaskHandle_t stream_task_handle = NULL;
     TaskHandle_t queue_task_handle = NULL;
+    TaskHandle_t stream_worker_task_handle = NULL;
 #endif
     size_t stream_task_stack_size = STREAM_TASK_STACK_SIZE;
     uint8_t stream_task_priority = 3;
@@ -1131,6 +1477,9 @@ struct firebase_cfg_int_t
 #else
     uint16_t stream_task_delay_ms = 100;
 #endif
+    size_t stream_worker_task_stack_size = STREAM_TASK_STACK_SIZE;
+    uint8_t stream_worker_task_priority = 2;
+    uint8_t stream_worker_task_cpu_core = 1;
     size_t queue_task_stack_size = QUEUE_TASK_STACK_SIZE;
     uint8_t queue_task_priority = 1;
     uint8_t queue_task_cpu_core = 1;
@@ -1139,13 +1488,21 @@ struct firebase_cfg_int_t
 #else
     uint16_t queue_task_delay_ms = 100;
 #endif
+#elif defined(FIREBASE_HOST_STREAM_TASK)
+    pthread_t stream_task_handle = pthread_t();
+    bool stream_task_running = false;
+    // the stack is allocated from heap as the other objects which addresses are kept in 32-bit
+    uint8_t *stream_task_stack = nullptr;
+    size_t stream_task_stack_size = STREAM_TASK_STACK_SIZE;
+    uint16_t stream_task_delay_ms = 10;
 #endif
 };
 
 struct firebase_rtdb_config_t
 {
     bool data_type_stricted = false;
-    size_t upload_buffer_size = 128;
+    // the largest write size of the upload, the write size adapts to the send buffer and the throughput
+    size_t upload_buffer_size = 2048;
 
     // unused, call fbdo.setResponseSize instead
     // size_t download_buffer_size = 256;
@@ -1339,6 +1696,8 @@ struct firebase_cfg_t
     uint8_t tcp_data_sending_retry = 1;
     size_t async_close_session_max_request = 100;
     struct firebase_auth_cert_t cert;
+    struct firebase_ssl_session_cache_config_t ssl_session_cache;
+    struct firebase_token_cache_config_t token_cache;
     struct firebase_token_signer_resources_t signer;
     TokenStatusCallback token_status_callback = NULL;
     // deprecated
@@ -1368,6 +1727,33 @@ public:
 };
 
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+// The stream event that copied from the session to the queue slot
+struct firebase_rtdb_stream_event_t
+{
+    struct firebase_stream_info_t info;
+    MB_VECTOR<uint8_t> blob;
+};
+
+// The ring of the stream events that are delivered to the stream callback by the worker
+struct firebase_rtdb_stream_queue_t
+{
+    MB_VECTOR<firebase_rtdb_stream_event_t> slots;
+    // the slot of the oldest event
+    size_t head = 0;
+    size_t count = 0;
+    firebase_rtdb_stream_queue_policy policy = firebase_rtdb_stream_queue_policy_drop_oldest;
+    uint32_t dropped = 0;
+    uint32_t coalesced = 0;
+    // the event that is being delivered, its buffers are swapped with the slot
+    firebase_rtdb_stream_event_t current;
+    FirebaseJson *json = nullptr;
+    FirebaseJsonArray *arr = nullptr;
+    // protects the ring state
+    firebase_mutex mutex;
+    // held by the worker while delivering the events
+    firebase_mutex worker;
+};
+
 struct firebase_rtdb_info_t
 {
     bool data_tmo = false;
@@ -1391,7 +1777,7 @@ struct firebase_rtdb_info_t
     firebase_request_method req_method = http_put;
     firebase_data_type req_data_type = firebase_data_type::d_any;
     firebase_data_type resp_data_type = firebase_data_type::d_any;
-    uint16_t data_crc = 0;
+    uint32_t data_hash = 0;
     MB_String path;
     MB_String raw;
     MB_String stream_path;
@@ -1401,6 +1787,8 @@ struct firebase_rtdb_info_t
     MB_String data_type_str;
     MB_String req_etag;
     MB_String resp_etag;
+    // the database secret that is used instead of the auth token e.g. for the rules requests of setQueryIndex
+    MB_String auth_secret;
     float priority;
 #if defined(FIREBASE_ESP_CLIENT)
     firebase_mem_storage_type storage_type = mem_storage_type_flash;
@@ -1414,9 +1802,13 @@ struct firebase_rtdb_info_t
     unsigned long stream_tmo_Millis = 0;
     unsigned long stream_resume_millis = 0;
     unsigned long data_millis = 0;
+    // the stream task reads the session when its socket is readable or the idle check is due
+    bool stream_ready = true;
+    unsigned long stream_check_millis = 0;
 
     MB_VECTOR<uint8_t> *blob = nullptr;
     int isBlobPtr = false;
+    FirebaseJsonStreamReader *json_reader = nullptr;
 
     bool priority_val_flag = false;
     bool priority_json_flag = false;
@@ -1428,6 +1820,7 @@ struct firebase_rtdb_info_t
     size_t file_size = 0;
 
     struct firebase_stream_info_t stream;
+    struct firebase_rtdb_stream_queue_t stream_queue;
 
 #if defined(ESP32) || defined(MB_ARDUINO_PICO)
     bool stream_loop_task_enable = false;
@@ -1435,6 +1828,9 @@ struct firebase_rtdb_info_t
 
     RTDB_UploadStatusInfo cbUploadInfo;
     RTDB_DownloadStatusInfo cbDownloadInfo;
+
+    struct firebase_rtdb_pipeline_info_t pipeline;
+    struct firebase_rtdb_header_template_t header_tmpl;
 };
 
 #endif
@@ -1999,6 +2395,9 @@ struct firebase_session_info_t
 
     uint16_t bssl_rx_size = 2048;
     uint16_t bssl_tx_size = 512;
+
+    // held by the task that uses this session, the independent sessions can be used in parallel
+    firebase_mutex mutex;
 };
 
 #if defined(ENABLE_FCM) || defined(FIREBASE_ENABLE_FCM)
@@ -2224,6 +2623,7 @@ static const char firebase_rtdb_pgm_str_37[] PROGMEM = "Keep-Alive: timeout=30,
 static const char firebase_rtdb_pgm_str_38[] PROGMEM = "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n";
 static const char firebase_rtdb_pgm_str_39[] PROGMEM = "{\".sv\": \"timestamp\"}";
 static const char firebase_rtdb_pgm_str_40[] PROGMEM = "object";
+static const char firebase_rtdb_pgm_str_41[] PROGMEM = "close";
 #endif
 
 // FCM class string
@@ -2645,6 +3045,11 @@ static const char firebase_rtdb_err_pgm_str_2[] PROGMEM = "path not exist";
 static const char firebase_rtdb_err_pgm_str_3[] PROGMEM = "data type mismatch";
 static const char firebase_rtdb_err_pgm_str_4[] PROGMEM = "security rules are not a valid JSON";
 static const char firebase_rtdb_err_pgm_str_5[] PROGMEM = "the FirebaseData object was paused";
+static const char firebase_rtdb_err_pgm_str_6[] PROGMEM = "invalid JSON data";
+static const char firebase_rtdb_err_pgm_str_7[] PROGMEM = "invalid or overlapped batch path";
+static const char firebase_rtdb_err_pgm_str_8[] PROGMEM = "file chunks are missing or incomplete";
+static const char firebase_rtdb_err_pgm_str_9[] PROGMEM = "file chunks CRC mismatch";
+static const char firebase_rtdb_err_pgm_str_10[] PROGMEM = "not enough memory for the file chunk";
 
 // FCM error string
 static const char firebase_fcm_err_pgm_str_1[] PROGMEM = "no ID token or registration token provided";
@@ -2661,5 +3066,26 @@ static const char firebase_functions_err_pgm_str_1[] PROGMEM = "missing autozip
 
 static const char firebase_boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 static const unsigned char firebase_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const unsigned char firebase_base64_url_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// The base64 decoding table, 0x40 for padding and 0x80 for the character that is not in the alphabet
+static const unsigned char firebase_base64_dec_table[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
 
 #endif
\ No newline at end of file
@@ -37,6 +37,7 @@
 #define FIREBASE_ERROR_HTTP_CODE_NO_CONTENT 204
 #define FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY 301
 #define FIREBASE_ERROR_HTTP_CODE_FOUND 302
+#define FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED 304
 #define FIREBASE_ERROR_HTTP_CODE_USE_PROXY 305
 #define FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT 307
 #define FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT 308
@@ -106,5 +107,10 @@
 #define FIREBASE_ERROR_USER_TIME_SETTING_REQUIRED /*          */ (FB_ERROR_RANGE - 38)
 #define FIREBASE_ERROR_SYS_TIME_IS_NOT_READY /*          */ (FB_ERROR_RANGE - 39)
 #define FIREBASE_ERROR_USER_PAUSE /*          */ (FB_ERROR_RANGE - 40)
+#define FIREBASE_ERROR_INVALID_JSON_DATA /*          */ (FB_ERROR_RANGE - 41)
+#define FIREBASE_ERROR_INVALID_BATCH_PATH /*          */ (FB_ERROR_RANGE - 42)
+#define FIREBASE_ERROR_FILE_CHUNKS_INCOMPLETE /*          */ (FB_ERROR_RANGE - 43)
+#define FIREBASE_ERROR_FILE_CHUNKS_CRC_MISMATCH /*          */ (FB_ERROR_RANGE - 44)
+#define FIREBASE_ERROR_FILE_CHUNKS_OUT_OF_MEMORY /*          */ (FB_ERROR_RANGE - 45)
 
 #endif
\ No newline at end of file
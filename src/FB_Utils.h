@@ -61,6 +61,57 @@ namespace FBUtils
         delay(0);
 #endif
     }
+
+    // The incremental CRC-32 (IEEE 802.3), pass 0 as crc for the first block
+    inline uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len)
+    {
+        // one table lookup per byte, the table is kept in flash
+        static const uint32_t table[256] PROGMEM = {
+            0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+            0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+            0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+            0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+            0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+            0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+            0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+            0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+            0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+            0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+            0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+            0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+            0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+            0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+            0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+            0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+            0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+            0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+            0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+            0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+            0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+            0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+            0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+            0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+            0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+            0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+            0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+            0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+            0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+            0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+            0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+            0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
+
+        crc = ~crc;
+        for (size_t i = 0; i < len; i++)
+            crc = pgm_read_dword(&table[(crc ^ data[i]) & 0xff]) ^ (crc >> 8);
+        return ~crc;
+    }
+
+    // The hash of data for the changes detection, the data can be fed in pieces,
+    // hashUpdate(hashUpdate(0, a), b) is equal to the hash of a and b joined.
+    inline uint32_t hashUpdate(uint32_t hash, const char *data, size_t len)
+    {
+        return crc32(hash, reinterpret_cast<const uint8_t *>(data), len);
+    }
 };
 
 class StringHelper
@@ -894,55 +945,193 @@ public:
                     response.fbError = d.stringValue.c_str();
             }
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
-            if (sh->compare(src, payloadOfs, firebase_rtdb_pgm_str_7 /* "\"blob,base64," */, true))
+            parseRespDataType(sh, src, payloadOfs, response, getOfs);
+#endif
+        }
+    }
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+    void parseRespDataType(StringHelper *sh, const MB_String &src, int payloadOfs,
+                           struct server_response_data_t &response, bool getOfs)
+    {
+        if (payloadOfs < 0 || src.length() < (size_t)payloadOfs)
+            return;
+
+        if (sh->compare(src, payloadOfs, firebase_rtdb_pgm_str_7 /* "\"blob,base64," */, true))
+        {
+            response.dataType = firebase_data_type::d_blob;
+            if ((response.isEvent && response.hasEventData) || getOfs)
             {
-                response.dataType = firebase_data_type::d_blob;
-                if ((response.isEvent && response.hasEventData) || getOfs)
+                if (response.eventData.length() > 0)
                 {
-                    if (response.eventData.length() > 0)
-                    {
-                        int dlen = response.eventData.length() - strlen_P(firebase_rtdb_pgm_str_7) - 1;
-                        response.payloadLen = dlen;
-                    }
-                    response.payloadOfs += strlen_P(firebase_rtdb_pgm_str_7);
-                    response.eventData.clear();
+                    int dlen = response.eventData.length() - strlen_P(firebase_rtdb_pgm_str_7) - 1;
+                    response.payloadLen = dlen;
                 }
+                response.payloadOfs += strlen_P(firebase_rtdb_pgm_str_7);
+                response.eventData.clear();
             }
-            else if (sh->compare(src, payloadOfs, firebase_rtdb_pgm_str_8 /* "\"file,base64," */, true))
+        }
+        else if (sh->compare(src, payloadOfs, firebase_rtdb_pgm_str_8 /* "\"file,base64," */, true))
+        {
+            response.dataType = firebase_data_type::d_file;
+            if ((response.isEvent && response.hasEventData) || getOfs)
             {
-                response.dataType = firebase_data_type::d_file;
-                if ((response.isEvent && response.hasEventData) || getOfs)
+                if (response.eventData.length() > 0)
                 {
-                    if (response.eventData.length() > 0)
-                    {
-                        int dlen = response.eventData.length() - strlen_P(firebase_rtdb_pgm_str_8) - 1;
-                        response.payloadLen = dlen;
-                    }
+                    int dlen = response.eventData.length() - strlen_P(firebase_rtdb_pgm_str_8) - 1;
+                    response.payloadLen = dlen;
+                }
+
+                response.payloadOfs += strlen_P(firebase_rtdb_pgm_str_8);
+                response.eventData.clear();
+            }
+        }
+        else if (sh->compare(src, payloadOfs, firebase_pgm_str_4 /* "\"" */))
+            response.dataType = firebase_data_type::d_string;
+        else if (sh->compare(src, payloadOfs, firebase_pgm_str_10 /* "{" */))
+            response.dataType = firebase_data_type::d_json;
+        else if (sh->compare(src, payloadOfs, firebase_pgm_str_6 /* "[" */))
+            response.dataType = firebase_data_type::d_array;
+        else if (sh->compare(src, payloadOfs, firebase_pgm_str_19 /* "false" */) ||
+                 sh->compare(src, payloadOfs, firebase_pgm_str_20 /* "true" */))
+        {
+            response.dataType = firebase_data_type::d_boolean;
+            response.boolData = sh->compare(src, payloadOfs, firebase_pgm_str_20 /* "true" */);
+        }
+        else if (sh->compare(src, payloadOfs, firebase_pgm_str_59 /* "null" */))
+            response.dataType = firebase_data_type::d_null;
+        else
+        {
+            // the event data is a slice of stream payload, look for decimal point inside the slice only
+            size_t len = response.isEvent && response.payloadLen > 0 ? response.payloadLen : src.length() - payloadOfs;
+            setNumDataType(src, payloadOfs, response, memchr(src.c_str() + payloadOfs, '.', len) != nullptr);
+        }
+    }
 
-                    response.payloadOfs += strlen_P(firebase_rtdb_pgm_str_8);
-                    response.eventData.clear();
+    // Parse the next server-sent event from buf, starting at ofs.
+    // The event fields are the slices of buf, no data was copied.
+    // Returns true when event found and ofs will be moved to the end of parsed event.
+    bool parseSSE(const char *buf, int len, int &ofs, struct firebase_sse_event_t &event)
+    {
+        event = firebase_sse_event_t();
+
+        bool hasData = false;
+        int typeLen = strlen_P(firebase_rtdb_pgm_str_12 /* "event: " */);
+        int dataLen = strlen_P(firebase_rtdb_pgm_str_13 /* "data: " */);
+
+        while (ofs < len)
+        {
+            const char *line = buf + ofs;
+            const char *nl = (const char *)memchr(line, '\n', len - ofs);
+            int lineLen = nl ? nl - line : len - ofs;
+            int lineOfs = ofs;
+            ofs += nl ? lineLen + 1 : lineLen;
+
+            if (lineLen > 0 && line[lineLen - 1] == '\r')
+                lineLen--;
+
+            // blank line, dispatch the event
+            if (lineLen == 0)
+            {
+                if (event.type.len > 0 && hasData)
+                    return true;
+                continue;
+            }
+
+            if (lineLen >= typeLen && strncmp_P(line, firebase_rtdb_pgm_str_12, typeLen) == 0)
+            {
+                // the new event without blank line separated
+                if (event.type.len > 0 && hasData)
+                {
+                    ofs = lineOfs;
+                    return true;
                 }
+
+                event.type.ofs = lineOfs + typeLen;
+                event.type.len = lineLen - typeLen;
+                hasData = false;
             }
-            else if (sh->compare(src, payloadOfs, firebase_pgm_str_4 /* "\"" */))
-                response.dataType = firebase_data_type::d_string;
-            else if (sh->compare(src, payloadOfs, firebase_pgm_str_10 /* "{" */))
-                response.dataType = firebase_data_type::d_json;
-            else if (sh->compare(src, payloadOfs, firebase_pgm_str_6 /* "[" */))
-                response.dataType = firebase_data_type::d_array;
-            else if (sh->compare(src, payloadOfs, firebase_pgm_str_19 /* "false" */) ||
-                     sh->compare(src, payloadOfs, firebase_pgm_str_20 /* "true" */))
+            else if (lineLen >= dataLen && strncmp_P(line, firebase_rtdb_pgm_str_13, dataLen) == 0)
             {
-                response.dataType = firebase_data_type::d_boolean;
-                response.boolData = sh->compare(src, payloadOfs, firebase_pgm_str_20 /* "true" */);
+                hasData = true;
+                parseSSEData(buf, lineOfs + dataLen, lineLen - dataLen, event);
             }
-            else if (sh->compare(src, payloadOfs, firebase_pgm_str_59 /* "null" */))
-                response.dataType = firebase_data_type::d_null;
-            else
-                setNumDataType(src, payloadOfs, response, src.find(pgm2Str(firebase_pgm_str_5 /* "." */), payloadOfs) != MB_String::npos);
-#endif
         }
+
+        return event.type.len > 0 && hasData;
+    }
+
+    // Parse the event data e.g. {"path":"/a","data":{"b":1}} for the path and data slices.
+    void parseSSEData(const char *buf, int ofs, int len, struct firebase_sse_event_t &event)
+    {
+        const char *p = buf + ofs;
+        int ob = 0, cb = 0, os = 0, cs = 0;
+        for (int i = 0; i < len; i++)
+        {
+            if (p[i] == '{')
+                ob++;
+            else if (p[i] == '}')
+                cb++;
+            else if (p[i] == '[')
+                os++;
+            else if (p[i] == ']')
+                cs++;
+        }
+
+        event.valid = ob == cb && os == cs;
+        event.hasPath = false;
+        event.path = firebase_span_t();
+        event.data.ofs = ofs;
+        event.data.len = len;
+
+        parseSSEPath(buf, ofs, len, event);
+
+        // hash the data slice in place, no copy of event data is needed for the changes detection
+        event.hash = FBUtils::hashUpdate(0, buf + event.data.ofs, event.data.len);
     }
 
+    // Parse the path and narrow the data slice of event data that starts with {"path":
+    void parseSSEPath(const char *buf, int ofs, int len, struct firebase_sse_event_t &event)
+    {
+        const char *p = buf + ofs;
+        int pathLen = strlen_P(firebase_pgm_str_54 /* "\"path\":\"" */);
+        int dataLen = strlen_P(firebase_pgm_str_55 /* "\"data\":" */);
+
+        if (len < pathLen + 1 || p[0] != '{' || strncmp_P(p + 1, firebase_pgm_str_54, pathLen) != 0)
+            return;
+
+        int i = 1 + pathLen;
+        int pathOfs = i;
+
+        // the path ends at unescaped quote
+        while (i < len && p[i] != '"')
+            i += p[i] == '\\' ? 2 : 1;
+
+        if (i >= len)
+            return;
+
+        event.path.ofs = ofs + pathOfs;
+        event.path.len = i - pathOfs;
+        event.hasPath = true;
+
+        // skip the closing quote and comma
+        i += 2;
+
+        if (i + dataLen <= len && strncmp_P(p + i, firebase_pgm_str_55, dataLen) == 0)
+        {
+            i += dataLen;
+            int end = len;
+            // exclude the closing brace of event data JSON
+            if (end > i && p[end - 1] == '}')
+                end--;
+            event.data.ofs = ofs + i;
+            event.data.len = end - i;
+        }
+    }
+
+#endif
+
     void getCustomHeaders(StringHelper *sh, MB_String &header, const MB_String &tokens)
     {
         if (tokens.length() > 0)
@@ -1024,63 +1213,23 @@ public:
         tcpHandler.payload = payload;
     }
 
-    int readLine(Client *client, char *buf, int bufLen)
+    // The client can be any type that provides the buffered readLine, i.e. Firebase_TCP_Client.
+    template <typename T>
+    int readLine(T *client, char *buf, int bufLen)
     {
         if (!client)
             return 0;
 
-        int res = -1;
-        char c = 0;
-        int idx = 0;
-        if (!client)
-            return idx;
-        while (client->available() && idx < bufLen)
-        {
-            if (!client)
-                break;
-
-            FBUtils::idle();
-
-            res = client->read();
-            if (res > -1)
-            {
-                c = (char)res;
-                buf[idx++] = c;
-                if (c == '\n')
-                    return idx;
-            }
-        }
-        return idx;
+        return client->readLine(buf, bufLen);
     }
 
-    int readLine(Client *client, MB_String &buf)
+    template <typename T>
+    int readLine(T *client, MB_String &buf)
     {
         if (!client)
             return 0;
 
-        int res = -1;
-        char c = 0;
-        int idx = 0;
-        if (!client)
-            return idx;
-        while (client->available())
-        {
-            if (!client)
-                break;
-
-            FBUtils::idle();
-
-            res = client->read();
-            if (res > -1)
-            {
-                c = (char)res;
-                buf += c;
-                idx++;
-                if (c == '\n')
-                    return idx;
-            }
-        }
-        return idx;
+        return client->readLine(buf);
     }
 
     uint32_t hex2int(const char *hex)
@@ -1104,7 +1253,8 @@ public:
     }
 
     // Returns -1 when complete
-    int readChunkedData(StringHelper *sh, MB_FS *mbfs, Client *client, char *out1, MB_String *out2,
+    template <typename T>
+    int readChunkedData(StringHelper *sh, MB_FS *mbfs, T *client, char *out1, MB_String *out2,
                         struct firebase_tcp_response_handler_t &tcpHandler)
     {
         if (!client)
@@ -1219,7 +1369,8 @@ public:
         return olen;
     }
 
-    bool readStatusLine(StringHelper *sh, MB_FS *mbfs, Client *client, struct firebase_tcp_response_handler_t &tcpHandler,
+    template <typename T>
+    bool readStatusLine(StringHelper *sh, MB_FS *mbfs, T *client, struct firebase_tcp_response_handler_t &tcpHandler,
                         struct server_response_data_t &response)
     {
         tcpHandler.chunkIdx++;
@@ -1249,7 +1400,8 @@ public:
         return true;
     }
 
-    bool readHeader(StringHelper *sh, MB_FS *mbfs, Client *client, struct firebase_tcp_response_handler_t &tcpHandler,
+    template <typename T>
+    bool readHeader(StringHelper *sh, MB_FS *mbfs, T *client, struct firebase_tcp_response_handler_t &tcpHandler,
                     struct server_response_data_t &response)
     {
         // do not check of the config here to allow legacy fcm to work
@@ -1309,18 +1461,6 @@ public:
         return (3 * (len / 4)) - pad;
     }
 
-    unsigned char *creatBase64EncBuffer(MB_FS *mbfs, bool isURL)
-    {
-        unsigned char *base64EncBuf = reinterpret_cast<unsigned char *>(mbfs->newP(65));
-        strcpy_P((char *)base64EncBuf, (char *)firebase_base64_table);
-        if (isURL)
-        {
-            base64EncBuf[62] = '-';
-            base64EncBuf[63] = '_';
-        }
-        return base64EncBuf;
-    }
-
     bool updateWrite(uint8_t *data, size_t len)
     {
 #if (defined(ENABLE_OTA_FIRMWARE_UPDATE) || defined(FIREBASE_ENABLE_OTA_FIRMWARE_UPDATE)) && (defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB) || defined(ENABLE_FB_STORAGE) || defined(ENABLE_GC_STORAGE) || defined(FIREBASE_ENABLE_GC_STORAGE))
@@ -1331,16 +1471,6 @@ public:
         return false;
     }
 
-    unsigned char *creatBase64DecBuffer(MB_FS *mbfs)
-    {
-        unsigned char *base64DecBuf = reinterpret_cast<unsigned char *>(mbfs->newP(256, false));
-        memset(base64DecBuf, 0x80, 256);
-        for (size_t i = 0; i < sizeof(firebase_base64_table) - 1; i++)
-            base64DecBuf[firebase_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
-        return base64DecBuf;
-    }
-
     template <typename T = uint8_t>
     bool writeOutput(MB_FS *mbfs, firebase_base64_io_t<T> &out)
     {
@@ -1362,161 +1492,226 @@ public:
         return false;
     }
 
+    // Append the block of bytes to output, the buffered output is written when it is full.
     template <typename T = uint8_t>
-    bool setOutput(MB_FS *mbfs, uint8_t val, firebase_base64_io_t<T> &out, T **pos)
+    bool setOutput(MB_FS *mbfs, const uint8_t *data, size_t len, firebase_base64_io_t<T> &out, T **pos)
     {
         if (out.outT)
         {
             if (out.ota || out.outC || out.filetype != mb_fs_mem_storage_type_undefined)
             {
-                out.outT[out.bufWrite++] = val;
-                if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
-                    return false;
+                while (len > 0)
+                {
+                    size_t n = out.bufLen - out.bufWrite;
+                    if (n > len)
+                        n = len;
+
+                    memcpy((uint8_t *)out.outT + out.bufWrite, data, n);
+                    out.bufWrite += n;
+                    data += n;
+                    len -= n;
+
+                    if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
+                        return false;
+                }
+            }
+            else if (sizeof(T) == 1)
+            {
+                memcpy(*pos, data, len);
+                *pos += len;
             }
             else
-                *(*pos)++ = (T)(val);
+            {
+                for (size_t i = 0; i < len; i++)
+                    *(*pos)++ = (T)(data[i]);
+            }
         }
         else if (out.outL)
-            out.outL->push_back(val);
+        {
+            for (size_t i = 0; i < len; i++)
+                out.outL->push_back(data[i]);
+        }
 
         return true;
     }
 
     template <typename T>
-    bool decode(MB_FS *mbfs, unsigned char *base64DecBuf, const char *src, size_t len, firebase_base64_io_t<T> &out)
+    bool decode(MB_FS *mbfs, const char *src, size_t len, firebase_base64_io_t<T> &out)
     {
         // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
-        bool ret = false;
-        unsigned char *block = reinterpret_cast<unsigned char *>(mbfs->newP(4, false));
-        unsigned char temp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
+        const uint8_t *in = (const uint8_t *)src;
+        const uint8_t *dec = firebase_base64_dec_table;
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
+        uint8_t buf[FIREBASE_BASE64_BLOCK_SIZE];
+        size_t n = 0, i = 0;
+        uint32_t acc = 0;
+        int count = 0, pad = 0;
+        bool valid = false;
+
         if (len == 0)
             len = strlen(src);
 
-        count = 0;
-
-        for (i = 0; i < len; i++)
+        while (i < len)
         {
-            if ((uint8_t)base64DecBuf[(uint8_t)src[i]] != 0x80)
-                count++;
-        }
-
-        if (count == 0)
-            goto skip;
+            if (n + 6 > sizeof(buf))
+            {
+                if (!setOutput(mbfs, buf, n, out, &pos))
+                    return false;
+                n = 0;
+            }
 
-        extra_pad = (4 - count % 4) % 4;
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
-        {
-            unsigned char val;
+            // the group of valid characters without padding, the most of input
+            if (count == 0 && len - i >= 8)
+            {
+                uint32_t c0 = dec[in[i]], c1 = dec[in[i + 1]], c2 = dec[in[i + 2]], c3 = dec[in[i + 3]];
+                uint32_t c4 = dec[in[i + 4]], c5 = dec[in[i + 5]], c6 = dec[in[i + 6]], c7 = dec[in[i + 7]];
 
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
+                // any of padding (0x40) and invalid (0x80) character falls to the slow path
+                if (((c0 | c1 | c2 | c3 | c4 | c5 | c6 | c7) & 0xc0) == 0)
+                {
+                    uint32_t v1 = c0 << 18 | c1 << 12 | c2 << 6 | c3;
+                    uint32_t v2 = c4 << 18 | c5 << 12 | c6 << 6 | c7;
+                    buf[n] = v1 >> 16;
+                    buf[n + 1] = v1 >> 8;
+                    buf[n + 2] = v1;
+                    buf[n + 3] = v2 >> 16;
+                    buf[n + 4] = v2 >> 8;
+                    buf[n + 5] = v2;
+                    n += 6;
+                    i += 8;
+                    valid = true;
+                    continue;
+                }
+            }
 
-            temp = base64DecBuf[val];
+            uint32_t c = dec[in[i++]];
 
-            if (temp == 0x80)
+            // skip the characters that are not in base64 alphabet e.g. new line
+            if (c & 0x80)
                 continue;
 
-            if (val == '=')
+            valid = true;
+
+            if (c == 0x40)
+            {
                 pad++;
+                c = 0;
+            }
 
-            block[count] = temp;
-            count++;
-            if (count == 4)
+            acc = acc << 6 | c;
+
+            if (++count == 4)
             {
+                if (pad > 2)
+                    return false;
 
-                setOutput(mbfs, (block[0] << 2) | (block[1] >> 4), out, &pos);
+                buf[n++] = acc >> 16;
+                if (pad < 2)
+                    buf[n++] = acc >> 8;
+                if (pad == 0)
+                    buf[n++] = acc;
 
                 count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    else if (pad > 2)
-                        goto skip;
+                acc = 0;
 
+                // the padding is the end of data
+                if (pad)
                     break;
-                }
-                else
-                {
-                    setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    setOutput(mbfs, (block[2] << 6) | block[3], out, &pos);
-                }
             }
         }
 
-        // write remaining
-        if (out.bufWrite > 0 && !writeOutput(mbfs, out))
-            goto skip;
-
-        ret = true;
-
-    skip:
-        mbfs->delP(&block);
-        return ret;
-    }
-
-    template <typename T>
-    bool encodeLast(MB_FS *mbfs, unsigned char *base64EncBuf, const unsigned char *in, size_t len,
-                    firebase_base64_io_t<T> &out, T **pos)
-    {
-        if (len > 2)
-            return false;
-
-        if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, pos))
+        if (!valid)
             return false;
 
-        if (len == 1)
-        {
-            if (!setOutput(mbfs, base64EncBuf[(in[0] & 0x03) << 4], out, pos))
-                return false;
-            if (!setOutput(mbfs, '=', out, pos))
-                return false;
-        }
-        else
+        // the incomplete group is padded
+        if (count > 0)
         {
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[(in[1] & 0x0f) << 2], out, pos))
+            pad += 4 - count;
+            acc <<= 6 * (4 - count);
+
+            if (pad > 2)
                 return false;
+
+            buf[n++] = acc >> 16;
+            if (pad < 2)
+                buf[n++] = acc >> 8;
         }
 
-        if (!setOutput(mbfs, '=', out, pos))
+        if (n > 0 && !setOutput(mbfs, buf, n, out, &pos))
+            return false;
+
+        // write remaining
+        if (out.bufWrite > 0 && !writeOutput(mbfs, out))
             return false;
 
         return true;
     }
 
     template <typename T>
-    bool encode(MB_FS *mbfs, unsigned char *base64EncBuf, uint8_t *src, size_t len,
-                firebase_base64_io_t<T> &out, bool writeAllRemaining = true)
+    bool encode(MB_FS *mbfs, uint8_t *src, size_t len, firebase_base64_io_t<T> &out, bool writeAllRemaining = true, bool isURL = false)
     {
-        const unsigned char *end, *in;
-
+        const uint8_t *enc = isURL ? firebase_base64_url_table : firebase_base64_table;
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
-        in = src;
-        end = src + len;
+        uint8_t buf[FIREBASE_BASE64_BLOCK_SIZE];
+        const uint8_t *in = src, *end = src + len;
+        size_t n = 0;
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+        // the 64-bit packing on the 64-bit host
+        while (end - in >= 6)
+        {
+            // 6 bytes (48 bits) into 8 characters
+            uint64_t v = (uint64_t)in[0] << 40 | (uint64_t)in[1] << 32 | (uint32_t)in[2] << 24 |
+                         (uint32_t)in[3] << 16 | (uint32_t)in[4] << 8 | in[5];
+            uint8_t *p = buf + n;
+            p[0] = enc[(v >> 42) & 0x3f];
+            p[1] = enc[(v >> 36) & 0x3f];
+            p[2] = enc[(v >> 30) & 0x3f];
+            p[3] = enc[(v >> 24) & 0x3f];
+            p[4] = enc[(v >> 18) & 0x3f];
+            p[5] = enc[(v >> 12) & 0x3f];
+            p[6] = enc[(v >> 6) & 0x3f];
+            p[7] = enc[v & 0x3f];
+            n += 8;
+            in += 6;
+
+            if (n + 8 > sizeof(buf))
+            {
+                if (!setOutput(mbfs, buf, n, out, &pos))
+                    return false;
+                n = 0;
+            }
+        }
+
+#endif
 
         while (end - in >= 3)
         {
-            if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[1] & 0x0f) << 2) | (in[2] >> 6)], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[in[2] & 0x3f], out, &pos))
-                return false;
+            if (n + 8 > sizeof(buf))
+            {
+                if (!setOutput(mbfs, buf, n, out, &pos))
+                    return false;
+                n = 0;
+            }
+
+            uint32_t v = (uint32_t)in[0] << 16 | (uint32_t)in[1] << 8 | in[2];
+            buf[n++] = enc[v >> 18];
+            buf[n++] = enc[(v >> 12) & 0x3f];
+            buf[n++] = enc[(v >> 6) & 0x3f];
+            buf[n++] = enc[v & 0x3f];
             in += 3;
         }
 
-        if (end - in && !encodeLast(mbfs, base64EncBuf, in, end - in, out, &pos))
+        if (end - in > 0)
+        {
+            uint32_t v = (uint32_t)in[0] << 16 | (end - in > 1 ? (uint32_t)in[1] << 8 : 0);
+            buf[n++] = enc[v >> 18];
+            buf[n++] = enc[(v >> 12) & 0x3f];
+            buf[n++] = end - in > 1 ? enc[(v >> 6) & 0x3f] : '=';
+            buf[n++] = '=';
+        }
+
+        if (n > 0 && !setOutput(mbfs, buf, n, out, &pos))
             return false;
 
         if (writeAllRemaining && out.bufWrite > 0 && !writeOutput(mbfs, out))
@@ -1524,15 +1719,14 @@ public:
 
         return true;
     }
+
     template <typename T>
     bool decodeToArray(MB_FS *mbfs, const MB_String &src, MB_VECTOR<T> &val)
     {
         firebase_base64_io_t<T> out;
         out.outL = &val;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<T>(mbfs, base64DecBuf, src.c_str(), src.length(), out);
-        mbfs->delP(&base64DecBuf);
-        return ret;
+        val.reserve(val.size() + (src.length() / 4) * 3);
+        return decode<T>(mbfs, src.c_str(), src.length(), out);
     }
 
     bool decodeToFile(MB_FS *mbfs, const char *src, size_t len, mbfs_file_type type)
@@ -1541,42 +1735,20 @@ public:
         out.filetype = type;
         uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
         out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out);
+        bool ret = decode<uint8_t>(mbfs, src, len, out);
         mbfs->delP(&buf);
-        mbfs->delP(&base64DecBuf);
         return ret;
     }
 
     void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
     {
-        size_t i;
-        char *p = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, true);
-
-        for (i = 0; i < len - 2; i += 3)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = base64EncBuf[string[i + 2] & 0x3F];
-        }
-
-        if (i < len)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            if (i == (len - 1))
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4)];
-            else
-            {
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2)];
-            }
-        }
-
-        *p++ = '\0';
+        firebase_base64_io_t<char> out;
+        out.outT = encoded;
+        encode<char>(mbfs, string, len, out, true, true);
 
-        mbfs->delP(&base64EncBuf);
+        // no padding in URL-safe encoding
+        size_t olen = (len / 3) * 4 + (len % 3 ? len % 3 + 1 : 0);
+        encoded[olen] = '\0';
     }
 
     MB_String encodeToString(MB_FS *mbfs, uint8_t *src, size_t len)
@@ -1585,11 +1757,9 @@ public:
         char *encoded = reinterpret_cast<char *>(mbfs->newP(encodedLength(len) + 1));
         firebase_base64_io_t<char> out;
         out.outT = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        if (encode<char>(mbfs, base64EncBuf, (uint8_t *)src, len, out))
+        if (encode<char>(mbfs, (uint8_t *)src, len, out))
             str = encoded;
         mbfs->delP(&encoded);
-        mbfs->delP(&base64EncBuf);
         return str;
     }
 
@@ -1599,10 +1769,8 @@ public:
         out.outC = client;
         uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
         out.outT = buf;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        bool ret = encode<uint8_t>(mbfs, base64EncBuf, (uint8_t *)data, len, out);
+        bool ret = encode<uint8_t>(mbfs, (uint8_t *)data, len, out);
         mbfs->delP(&buf);
-        mbfs->delP(&base64EncBuf);
         return ret;
     }
 };
@@ -1642,14 +1810,12 @@ public:
         uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(out.bufLen));
         out.ota = true;
         out.outT = buf;
-        unsigned char *base64DecBuf = bh->creatBase64DecBuffer(mbfs);
-        if (!bh->decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out))
+        if (!bh->decode<uint8_t>(mbfs, src, strlen(src), out))
         {
             code = FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
             ret = false;
         }
         mbfs->delP(&buf);
-        mbfs->delP(&base64DecBuf);
         return ret;
     }
 };
@@ -1757,6 +1923,12 @@ public:
         return mbfs->calCRC(buf);
     }
 
+    // The incremental CRC-32 (IEEE 802.3), pass 0 as crc for the first block
+    uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len)
+    {
+        return FBUtils::crc32(crc, data, len);
+    }
+
     void makePath(MB_String &path)
     {
         if (path.length() > 0)
@@ -46,8 +46,10 @@ FIREBASE_CLASS::~FIREBASE_CLASS()
 
     if (config)
     {
+        Core.internal.session_mutex.lock();
         Core.internal.sessions.clear();
         Core.internal.queueSessions.clear();
+        Core.internal.session_mutex.unlock();
         delete config;
         config = nullptr;
     }
@@ -128,9 +130,13 @@ bool FIREBASE_CLASS::ready()
     {
         for (size_t id = 0; id < Core.internal.sessions.size(); id++)
         {
-            FirebaseData *fbdo = addrTo<FirebaseData *>(Core.internal.sessions[id].ptr);
+            // the session that is being used by other task will be closed by its request
+            FirebaseData *fbdo = FirebaseData::lockSession(Core.internal.sessions, id);
             if (fbdo)
+            {
                 fbdo->closeSession();
+                fbdo->unlockSession();
+            }
         }
     }
     return Core.tokenReady();
@@ -205,13 +211,19 @@ void FIREBASE_CLASS::mSetAuthToken(FirebaseConfig *config, MB_StringPtr authToke
         refresh = true;
     }
 
+    Core.internal.token_mutex.lock();
+
     if (_authToken.length() == 0 || strcmp(Core.internal.auth_token.c_str(), _authToken.c_str()) == 0)
+    {
+        Core.internal.token_mutex.unlock();
         return;
+    }
 
     _authToken.clear();
 
     Core.internal.auth_token = authToken;
     Core.internal.atok_len = Core.internal.auth_token.length();
+    Core.internal.token_mutex.unlock();
     Core.internal.rtok_len = Core.internal.refresh_token.length();
 
     if (expire > 3600)
@@ -270,7 +282,9 @@ void FIREBASE_CLASS::reset(FirebaseConfig *config)
     {
         Core.internal.client_id.clear();
         Core.internal.client_secret.clear();
+        Core.internal.token_mutex.lock();
         Core.internal.auth_token.clear();
+        Core.internal.token_mutex.unlock();
         Core.internal.refresh_token.clear();
         Core.internal.atok_len = 0;
         Core.internal.rtok_len = 0;
@@ -290,6 +304,14 @@ void FIREBASE_CLASS::reset(FirebaseConfig *config)
         Core.internal.email_crc = 0;
         Core.internal.password_crc = 0;
 
+        // the stored access token belongs to the previous credentials
+        if (config->token_cache.file.length() > 0)
+        {
+            firebase_mutex_guard guard(Core.internal.file_mutex);
+            Core.mbfs.remove(config->token_cache.file, mbfs_type config->token_cache.file_storage);
+        }
+        Core.accessTokenCacheLoaded = false;
+
         config->signer.tokens.status = token_status_uninitialized;
     }
 }
@@ -362,6 +384,16 @@ void FIREBASE_CLASS::setFloatDigits(uint8_t digits)
         Core.internal.fb_float_digits = digits;
 }
 
+bool FIREBASE_CLASS::saveSSLSessionCache()
+{
+    return Core.saveSSLSessionCache();
+}
+
+void FIREBASE_CLASS::clearSSLSessionCache()
+{
+    Core.sslSessionCache.clear();
+}
+
 void FIREBASE_CLASS::setDoubleDigits(uint8_t digits)
 {
     if (digits < 9)
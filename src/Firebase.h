@@ -325,6 +325,8 @@ public:
   /** Get currently used auth token string.
    *
    * @return constant char* of currently used auth token.
+   *
+   * @note The token can be refreshed by other task, copy it before use when the library is used from more than one task.
    */
   const char *getToken();
 
@@ -358,6 +360,28 @@ public:
    */
   void setDoubleDigits(uint8_t digits);
 
+  /** Write the TLS sessions that shared by all FirebaseData objects to the file.
+   *
+   * @return Boolean type status indicates the success of the operation.
+   *
+   * @note The file is assigned by config.ssl_session_cache.file and config.ssl_session_cache.file_storage.
+   * The sessions in the file are restored on the first connection after reboot or deep sleep
+   * to resume the previous sessions instead of the full TLS handshake.
+   *
+   * The changed sessions are written to the file automatically when the next request is started
+   * and no other file was opened on that storage, not more often than FIREBASE_SSL_SESSION_CACHE_SAVE_INTERVAL
+   * (60 seconds by default), this function should be called before entering the deep sleep.
+   *
+   * The file contains the secrets of sessions and should be kept private.
+   */
+  bool saveSSLSessionCache();
+
+  /** Remove all TLS sessions that shared by all FirebaseData objects.
+   *
+   * @note The next connection to each server will perform the full TLS handshake.
+   */
+  void clearSSLSessionCache();
+
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
 
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
@@ -1512,6 +1536,34 @@ public:
     return RTDB.updateNodeSilentAsync(&fbdo, path, &json, priority);
   }
 
+  /** Write all path and value pairs in the batch at once (multi-location update).
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param batch The RTDBBatch object that holds the items to write.
+   * @return Boolean type status indicates the success of the operation.
+   *
+   * @note No payload will be returned from the server.
+   */
+  bool commitBatch(FirebaseData &fbdo, RTDBBatch &batch) { return RTDB.commitBatch(&fbdo, &batch); }
+
+  bool commitBatchAsync(FirebaseData &fbdo, RTDBBatch &batch) { return RTDB.commitBatchAsync(&fbdo, &batch); }
+
+  /** Read the available responses of pipelined async requests without blocking.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return Boolean type status indicates the connection is still usable.
+   *
+   * @note The pipelining can be enabled with FirebaseData::setPipelining.
+   */
+  bool processPipeline(FirebaseData &fbdo) { return RTDB.processPipeline(&fbdo); }
+
+  /** Wait for the responses of all pipelined async requests.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return Boolean type status indicates all in-flight requests were answered.
+   */
+  bool flushPipeline(FirebaseData &fbdo) { return RTDB.flushPipeline(&fbdo); }
+
   /** Read any type of value at the defined database path.
    *
    * @param fbdo Firebase Data Object to hold data and instance.
@@ -1912,6 +1964,56 @@ public:
     return RTDB.downloadOTA(&fbdo, fwPath, callback);
   }
 
+  /** Upload file from SD card/Flash memory as the chunked file at the defined database path.
+   * The file is stored as the fixed size base64 chunks at <nodePath>/chunks/<index> and its size,
+   * chunk size, chunk count, CRC32 and SHA-256 at <nodePath>/manifest.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param storageType Type of storage to read file data, StorageType::FLASH or StorageType::SD.
+   * @param nodePath Database path that the chunked file will be stored.
+   * @param fileName File name included its path in SD card/Flash memory.
+   * @param callback Optional. The callback function that accept RTDB_UploadStatusInfo data.
+   * @param chunkSize Optional. The binary bytes per chunk.
+   * @return Boolean type status indicates the success of the operation.
+   *
+   * The interrupted upload of the same file will be resumed from the first missing chunk.
+   */
+  template <typename T1 = const char *, typename T2 = const char *>
+  bool setFileChunks(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName,
+                     RTDB_UploadProgressCallback callback = NULL, size_t chunkSize = FIREBASE_RTDB_FILE_CHUNK_SIZE)
+  {
+    return RTDB.setFileChunks(&fbdo, getMemStorageType(storageType), nodePath, fileName, callback, chunkSize);
+  }
+
+  /** Download the chunked file at the defined database path and save it to SD card/Flash memory.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param storageType Type of storage to write file data, StorageType::FLASH or StorageType::SD.
+   * @param nodePath Database path that the chunked file was stored using setFileChunks.
+   * @param fileName File name included its path in SD card/Flash memory to save in SD card/Flash memory.
+   * @param callback Optional. The callback function that accept RTDB_DownloadStatusInfo data.
+   * @return Boolean type status indicates the success of the operation.
+   */
+  template <typename T1 = const char *, typename T2 = const char *>
+  bool getFileChunks(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName,
+                     RTDB_DownloadProgressCallback callback = NULL)
+  {
+    return RTDB.getFileChunks(&fbdo, getMemStorageType(storageType), nodePath, fileName, callback);
+  }
+
+  /** Download a firmware file that was stored as the chunked file from the database.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param fwPath The database path that the firmware was stored using setFileChunks.
+   * @param callback Optional. The callback function that accept RTDB_DownloadStatusInfo data.
+   * @return Boolean type status indicates the success of the operation.
+   */
+  template <typename T = const char *>
+  bool downloadOTAChunks(FirebaseData &fbdo, T fwPath, RTDB_DownloadProgressCallback callback = NULL)
+  {
+    return RTDB.downloadOTAChunks(&fbdo, fwPath, callback);
+  }
+
   /** Delete all child nodes at the defined database path.
    *
    * @param fbdo Firebase Data Object to hold data and instance.
@@ -1939,11 +2041,14 @@ public:
    * @param fbdo The pointer to Firebase Data Object.
    * @param path The parent path of children nodes that is being deleted.
    * @param timestampNode The sub-child node that keep the timestamp.
-   * @param limit The maximum number of children nodes to delete at once, 30 is maximum.
+   * @param limit The maximum number of children nodes to delete in this call.
    * @param dataRetentionPeriod The period in seconds of data in the past which will be retained.
    * @return Boolean value, indicates the success of the operation.
    *
-   * @note The databaseSecret can be empty if the auth type is OAuth2.0 or legacy and required if auth type
+   * @note The expired nodes are queried in pages of up to 30 nodes and all nodes of each page
+   * are deleted at once with one multi-path update request.
+   *
+   * The databaseSecret can be empty if the auth type is OAuth2.0 or legacy and required if auth type
    * is Email/Password sign-in.
    */
   template <typename T1 = const char *, typename T2 = const char *>
@@ -2002,6 +2107,45 @@ public:
    */
   bool endStream(FirebaseData &fbdo) { return RTDB.endStream(&fbdo); }
 
+  /** Enable or disable the local replica of the stream data.
+   * The get requests under the stream path are served from the replica without the network request.
+   * This should be called before Firebase.beginStream.
+   *
+   * @param fbdo Firebase Data Object that used for stream.
+   * @param enable The boolean value to enable the replica.
+   */
+  void setStreamReplica(FirebaseData &fbdo, bool enable) { RTDB.setStreamReplica(&fbdo, enable); }
+
+  /** Set the maximum memory size of all stream replicas.
+   * The least recently read children are removed when the size exceeds the limit.
+   *
+   * @param size The size in bytes.
+   */
+  void setReplicaMaxSize(size_t size) { RTDB.setReplicaMaxSize(size); }
+
+  /** Set the stream event queue which decouples the stream callback from the stream reading.
+   *
+   * @param fbdo Firebase Data Object that used for stream.
+   * @param size The number of event slots, 0 to call the stream callback directly.
+   * @param policy The policy when the queue is full, firebase_rtdb_stream_queue_policy_drop_oldest,
+   * firebase_rtdb_stream_queue_policy_coalesce or firebase_rtdb_stream_queue_policy_block.
+   */
+  void setStreamQueue(FirebaseData &fbdo, size_t size,
+                      firebase_rtdb_stream_queue_policy policy = firebase_rtdb_stream_queue_policy_drop_oldest)
+  {
+    RTDB.setStreamQueue(&fbdo, size, policy);
+  }
+
+#if defined(ESP32)
+  /** Set the stream event queue worker task.
+   *
+   * @param stackSize The task reserved stack memory in byte.
+   * @param priority The task priority.
+   * @param cpuCore The CPU core that runs the task.
+   */
+  void setStreamWorkerTask(size_t stackSize, uint8_t priority, uint8_t cpuCore) { RTDB.setStreamWorkerTask(stackSize, priority, cpuCore); }
+#endif
+
   /** Set the stream callback functions.
    * setStreamCallback should be called before Firebase.beginStream.
    *
@@ -2026,7 +2170,7 @@ public:
   {
     RTDB.setStreamCallback(&fbdo, dataAvailablecallback, timeoutCallback, streamTaskStackSize);
   }
-#elif defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(FB_ENABLE_EXTERNAL_CLIENT)
+#elif defined(ESP8266) || defined(MB_ARDUINO_PICO) || defined(FB_ENABLE_EXTERNAL_CLIENT) || defined(FIREBASE_HOST_STREAM_TASK)
   void setStreamCallback(FirebaseData &fbdo, FirebaseData::StreamEventCallback dataAvailablecallback,
                          FirebaseData::StreamTimeoutCallback timeoutCallback = NULL)
   {
@@ -2054,7 +2198,7 @@ public:
    *
    * These properties will store the result from calling the function [MultiPathStreamData object].get.
    */
-#if defined(ESP8266)
+#if defined(ESP8266) || defined(FIREBASE_HOST_STREAM_TASK)
   void setMultiPathStreamCallback(FirebaseData &fbdo, FirebaseData::MultiPathStreamEventCallback multiPathDataCallback,
                                   FirebaseData::StreamTimeoutCallback timeoutCallback = NULL)
   {
@@ -2457,10 +2601,12 @@ public:
    *
    * queueInfo.path(), get a string of the Firebase call path that is being processed of current Error Queue.
    */
+#if defined(ESP32) || defined(ESP8266)
   void beginAutoRunErrorQueue(FirebaseData &fbdo, FirebaseData::QueueInfoCallback callback = NULL)
   {
     RTDB.beginAutoRunErrorQueue(&fbdo, callback);
   }
+#endif
 
   /** Stop the Firebase Error Queues Auto Run Process.
    *
@@ -2474,6 +2620,37 @@ public:
    */
   void clearErrorQueue(FirebaseData &fbdo) { RTDB.clearErrorQueue(&fbdo); };
 
+  /** Start the persistent offline journal which the failed and offline writes are kept in.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param filename The base name of segment files.
+   * @param storageType Type of storage to write file, StorageType::FLASH or StorageType::SD.
+   * @param maxSize The maximum size in bytes of all segment files, the oldest segment is removed when the journal is full.
+   * @param segmentSize The size in bytes of each segment file.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * The journal writes are replayed in order by processErrorQueue or the error queue auto run process.
+   */
+  template <typename T = const char *>
+  bool beginOfflineJournal(FirebaseData &fbdo, T filename, uint8_t storageType,
+                           size_t maxSize = FIREBASE_RTDB_JOURNAL_MAX_SIZE, size_t segmentSize = FIREBASE_RTDB_JOURNAL_SEGMENT_SIZE)
+  {
+    return RTDB.beginOfflineJournal(&fbdo, filename, getMemStorageType(storageType), maxSize, segmentSize);
+  }
+
+  /** Stop using the offline journal, the segment files are kept in the storage.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   */
+  void endOfflineJournal(FirebaseData &fbdo) { RTDB.endOfflineJournal(&fbdo); }
+
+  /** Get the number of writes in the offline journal that were not replayed.
+   *
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return The number of writes.
+   */
+  size_t offlineJournalCount(FirebaseData &fbdo) { return RTDB.offlineJournalCount(&fbdo); }
+
 #endif // ERROR QUEUE
 
 #endif // RTDB
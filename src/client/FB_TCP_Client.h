@@ -100,6 +100,12 @@ public:
   virtual ~Firebase_TCP_Client()
   {
     clear();
+    if (_rx_buf)
+      delete[] _rx_buf;
+    _rx_buf = nullptr;
+    if (_cork_buf)
+      delete[] _cork_buf;
+    _cork_buf = nullptr;
     if (_tcp_client)
       delete (ESP_SSLClient *)_tcp_client;
     _tcp_client = nullptr;
@@ -548,6 +554,23 @@ public:
    */
   uint8_t connected() { return _tcp_client && _tcp_client->connected(); };
 
+  /**
+   * Get the socket of the internal client or the client of host build.
+   * @return The socket descriptor or -1 when the external client was used or not connected.
+   */
+  int fd()
+  {
+#if defined(ESP32)
+    if (_client_type == firebase_client_type_internal_basic_client && _basic_client && connected())
+      return reinterpret_cast<BASE_WIFICLIENT *>(_basic_client)->fd();
+#elif defined(FIREBASE_HOST_STREAM_TASK)
+    // the Client of host build returns its socket or -1
+    if (_basic_client && connected())
+      return _basic_client->fd();
+#endif
+    return -1;
+  }
+
   bool connect()
   {
     if (!_tcp_client)
@@ -647,6 +670,10 @@ public:
    */
   void stop()
   {
+    resetReadBuffer();
+    // the held data belongs to the request on this connection
+    _cork = false;
+    _cork_len = 0;
     if (_tcp_client)
       _tcp_client->stop();
   }
@@ -662,37 +689,51 @@ public:
 
   size_t write(const uint8_t *data, size_t size)
   {
-
-    if (!_tcp_client)
-      return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
+    if (!_cork)
+      return mWrite(data, size);
 
     if (!data || size == 0)
       return setError(FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
 
-    if (!networkReady())
-      return setError(FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED);
-
-    if (!_tcp_client->connected() && !connect())
-      return setError(FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED);
-
-    int toSend = _chunkSize;
-    int sent = 0;
-    while (sent < (int)size)
+    // send the held data first to keep the order
+    if (_cork_len + size > FIREBASE_TCP_CORK_BUFFER_SIZE)
     {
-      if (sent + toSend > (int)size)
-        toSend = size - sent;
+      int ret = flushCork();
+      if (ret < 0)
+        return ret;
+    }
 
-      if ((int)_tcp_client->write(data + sent, toSend) != toSend)
-        return FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+    if (size >= FIREBASE_TCP_CORK_BUFFER_SIZE)
+      return mWrite(data, size);
 
-      sent += toSend;
-    }
+    if (!_cork_buf)
+      _cork_buf = new uint8_t[FIREBASE_TCP_CORK_BUFFER_SIZE];
+
+    memcpy(_cork_buf + _cork_len, data, size);
+    _cork_len += size;
 
     setError(FIREBASE_ERROR_HTTP_CODE_OK);
 
     return size;
   }
 
+  /**
+   * Hold the following writes in buffer and send them together when the buffer is full or uncork is called.
+   * Each write to the SSL client is sent as its own TLS record, holding the small writes of request
+   * reduces the number of records and TCP segments.
+   */
+  void cork() { _cork = true; }
+
+  /**
+   * Send the data held since cork and stop holding the writes.
+   * @return The size of data that was sent or negative value for error.
+   */
+  int uncork()
+  {
+    _cork = false;
+    return flushCork();
+  }
+
   size_t write(uint8_t v)
   {
     uint8_t buf[1];
@@ -700,6 +741,18 @@ public:
     return write(buf, 1);
   }
 
+  /**
+   * Get the size of data that can be written without being split.
+   * @return The free space of the cork buffer while corked, otherwise the free space
+   * of the SSL send buffer or 0 when it is unknown.
+   */
+  int availableForWrite()
+  {
+    if (_cork)
+      return FIREBASE_TCP_CORK_BUFFER_SIZE - _cork_len;
+    return _tcp_client && connected() ? _tcp_client->availableForWrite() : 0;
+  }
+
   /**
    * The TCP data send function.
    * @param data The data to send.
@@ -765,7 +818,7 @@ public:
     if (!_tcp_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
-    return _tcp_client->available();
+    return (_rx_len - _rx_pos) + _tcp_client->available();
   }
 
   /**
@@ -777,7 +830,10 @@ public:
     if (!_basic_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
-    return _tcp_client->read();
+    if (_rx_pos == _rx_len && fillReadBuffer() <= 0)
+      return -1;
+
+    return _rx_buf[_rx_pos++];
   }
 
   int read(uint8_t *buf, size_t len)
@@ -796,7 +852,38 @@ public:
     if (!_basic_client)
       return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
 
-    return _tcp_client->read(buf, len);
+    if (!buf || len <= 0)
+      return 0;
+
+    // drain the buffered bytes first
+    int read = _rx_len - _rx_pos;
+    if (read > len)
+      read = len;
+
+    if (read > 0)
+    {
+      memcpy(buf, _rx_buf + _rx_pos, read);
+      _rx_pos += read;
+    }
+
+    if (read == len)
+      return read;
+
+    // large requests go straight to the SSL client, small ones refill the buffer
+    if (len - read >= _rx_buf_size)
+    {
+      int avail = _tcp_client->available();
+      if (avail > len - read)
+        avail = len - read;
+
+      int r = avail > 0 ? _tcp_client->read(buf + read, avail) : 0;
+      if (r > 0)
+        read += r;
+    }
+    else if (fillReadBuffer() > 0)
+      read += readBytes(buf + read, len - read);
+
+    return read;
   }
 
   /**
@@ -810,11 +897,75 @@ public:
     return readBytes((uint8_t *)buf, len);
   }
 
+  /**
+   * Read the available data until new line character or buffer full.
+   * @param buf The data buffer.
+   * @param len The size of data buffer.
+   * @return The size of data that was read including new line character.
+   */
+  int readLine(char *buf, int len)
+  {
+    if (!_basic_client || !buf)
+      return 0;
+
+    int idx = 0;
+    while (idx < len && (_rx_pos < _rx_len || fillReadBuffer() > 0))
+    {
+      int n = scanLine(len - idx);
+      memcpy(buf + idx, _rx_buf + _rx_pos, n);
+      _rx_pos += n;
+      idx += n;
+      if (buf[idx - 1] == '\n')
+        break;
+    }
+    return idx;
+  }
+
+  /**
+   * Read the available data until new line character.
+   * @param buf The string to append the data.
+   * @return The size of data that was read including new line character.
+   */
+  int readLine(MB_String &buf)
+  {
+    if (!_basic_client)
+      return 0;
+
+    int idx = 0;
+    while (_rx_pos < _rx_len || fillReadBuffer() > 0)
+    {
+      int n = scanLine(_rx_len - _rx_pos);
+      buf.append((const char *)_rx_buf + _rx_pos, n);
+      _rx_pos += n;
+      idx += n;
+      if (_rx_buf[_rx_pos - 1] == '\n')
+        break;
+    }
+    return idx;
+  }
+
+  /**
+   * Set the size of receive buffer that used for block reading.
+   * @param size The size of buffer in bytes.
+   */
+  void setReadBufferSize(int size)
+  {
+    if (size < 64 || size == _rx_buf_size || _rx_pos < _rx_len)
+      return;
+
+    if (_rx_buf)
+      delete[] _rx_buf;
+    _rx_buf = nullptr;
+    _rx_buf_size = size;
+    resetReadBuffer();
+  }
+
   /**
    * Wait for all receive buffer data read.
    */
   void flush()
   {
+    resetReadBuffer();
     if (_tcp_client && _tcp_client->connected())
       _tcp_client->flush();
   }
@@ -832,7 +983,11 @@ public:
   {
     if (!_tcp_client)
       return 0;
-    return _tcp_client->peek();
+
+    if (_rx_pos == _rx_len && fillReadBuffer() <= 0)
+      return -1;
+
+    return _rx_buf[_rx_pos];
   }
 
   int connect(IPAddress ip, uint16_t port)
@@ -1132,6 +1287,11 @@ public:
     _tcp_client->setSession(session);
   }
 
+  void setSessionCache(BearSSL_SessionCache *cache)
+  {
+    _tcp_client->setSessionCache(cache);
+  }
+
   ESP_SSLClient *client() { return _tcp_client; }
 
   void setSPIEthernet(SPI_ETH_Module *eth) { this->eth = eth; }
@@ -1142,6 +1302,96 @@ public:
   bool clockReady = false;
 
 private:
+  // Read the available data from SSL client into receive buffer.
+  // Returns the number of buffered bytes.
+  int fillReadBuffer()
+  {
+    if (_rx_pos < _rx_len)
+      return _rx_len - _rx_pos;
+
+    resetReadBuffer();
+
+    if (!_tcp_client)
+      return 0;
+
+    int avail = _tcp_client->available();
+    if (avail <= 0)
+      return 0;
+
+    // extra byte for null terminator, the buffered data can be used as C string
+    if (!_rx_buf)
+      _rx_buf = new uint8_t[_rx_buf_size + 1];
+
+    int r = _tcp_client->read(_rx_buf, avail < _rx_buf_size ? avail : _rx_buf_size);
+    if (r > 0)
+      _rx_len = r;
+
+    _rx_buf[_rx_len] = 0;
+
+    return _rx_len;
+  }
+
+  // Returns the number of buffered bytes up to and including new line character, limited by max.
+  int scanLine(int max)
+  {
+    int n = _rx_len - _rx_pos;
+    if (n > max)
+      n = max;
+
+    const uint8_t *nl = (const uint8_t *)memchr(_rx_buf + _rx_pos, '\n', n);
+    return nl ? nl - (_rx_buf + _rx_pos) + 1 : n;
+  }
+
+  void resetReadBuffer()
+  {
+    _rx_pos = 0;
+    _rx_len = 0;
+  }
+
+  size_t mWrite(const uint8_t *data, size_t size)
+  {
+    if (!_tcp_client)
+      return setError(FIREBASE_ERROR_TCP_CLIENT_NOT_INITIALIZED);
+
+    if (!data || size == 0)
+      return setError(FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
+
+    if (!networkReady())
+      return setError(FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED);
+
+    if (!_tcp_client->connected() && !connect())
+      return setError(FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED);
+
+    int toSend = _chunkSize;
+    int sent = 0;
+    while (sent < (int)size)
+    {
+      if (sent + toSend > (int)size)
+        toSend = size - sent;
+
+      if ((int)_tcp_client->write(data + sent, toSend) != toSend)
+        return FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+
+      sent += toSend;
+    }
+
+    setError(FIREBASE_ERROR_HTTP_CODE_OK);
+
+    return size;
+  }
+
+  // Send the data held by cork.
+  int flushCork()
+  {
+    if (_cork_len == 0)
+      return 0;
+
+    int len = _cork_len;
+    _cork_len = 0;
+
+    return (int)mWrite(_cork_buf, len);
+  }
+
   // lwIP TCP Keepalive idle in seconds.
   int _tcpKeepIdleSeconds = -1;
   // lwIP TCP Keepalive interval in seconds.
@@ -1180,6 +1430,12 @@ private:
   int _last_error = 0;
   volatile bool _network_status = false;
   int _rx_size = 1024, _tx_size = 512;
+  uint8_t *_rx_buf = nullptr;
+  int _rx_buf_size = 1024;
+  int _rx_pos = 0, _rx_len = 0;
+  bool _cork = false;
+  uint8_t *_cork_buf = nullptr;
+  int _cork_len = 0;
   int *response_code = nullptr;
   FirebaseConfig *_config = nullptr;
   FirebaseAuth *_auth = nullptr;
@@ -99,6 +99,315 @@ private:
     br_ssl_session_parameters _session;
 };
 
+#if !defined(BSSL_SESSION_CACHE_SIZE)
+#define BSSL_SESSION_CACHE_SIZE 4
+#endif
+
+// The longest host name that its session can be cached
+#if !defined(BSSL_SESSION_CACHE_HOST_LEN)
+#define BSSL_SESSION_CACHE_HOST_LEN 96
+#endif
+
+// The clients in different tasks share the session cache
+#if defined(ESP32) || (defined(ARDUINO_ARCH_RP2040) && defined(INC_FREERTOS_H))
+#define BSSL_SESSION_CACHE_LOCK
+#endif
+
+// The TLS sessions of servers keyed by host and port that shared by all clients
+// Use with BSSL_SSL_Client::setSessionCache to resume the session that was
+// established by any client, the least recently used session will be replaced when full.
+// The cache can be serialized to keep the sessions across reboot or deep sleep,
+// the serialized data contains the master secrets and should be kept private.
+class BearSSL_SessionCache
+{
+public:
+    BearSSL_SessionCache()
+    {
+#if defined(BSSL_SESSION_CACHE_LOCK)
+        _lock = xSemaphoreCreateRecursiveMutex();
+#endif
+        clear();
+        _dirty = false;
+    }
+
+    ~BearSSL_SessionCache()
+    {
+#if defined(BSSL_SESSION_CACHE_LOCK)
+        if (_lock)
+            vSemaphoreDelete(_lock);
+#endif
+    }
+
+    // Get the session of server, returns false if not found
+    bool get(const char *host, uint16_t port, br_ssl_session_parameters *params)
+    {
+        guard g(this);
+        int i = find(host, port);
+        if (i < 0 || !params)
+            return false;
+
+        memcpy(params, &_entries[i].params, sizeof(br_ssl_session_parameters));
+        _entries[i].stamp = ++_stamp;
+        return true;
+    }
+
+    // Add or update the session of server
+    void put(const char *host, uint16_t port, const br_ssl_session_parameters *params)
+    {
+        // nothing to resume or the host name is too long to keep
+        if (!host || !params || params->session_id_len == 0 || params->session_id_len > sizeof(params->session_id) ||
+            strlen(host) > BSSL_SESSION_CACHE_HOST_LEN)
+            return;
+
+        guard g(this);
+        int i = find(host, port);
+
+        if (i >= 0 && memcmp(&_entries[i].params, params, sizeof(br_ssl_session_parameters)) == 0)
+        {
+            _entries[i].stamp = ++_stamp;
+            return;
+        }
+
+        if (i < 0)
+        {
+            i = 0;
+            for (int j = 1; j < BSSL_SESSION_CACHE_SIZE; j++)
+            {
+                if (_entries[j].stamp < _entries[i].stamp)
+                    i = j;
+            }
+        }
+
+        strcpy(_entries[i].host, host);
+        _entries[i].port = port;
+        _entries[i].stamp = ++_stamp;
+        memcpy(&_entries[i].params, params, sizeof(br_ssl_session_parameters));
+        _dirty = true;
+    }
+
+    // Remove the session of server e.g. when the resumed handshake was failed
+    void remove(const char *host, uint16_t port)
+    {
+        guard g(this);
+        int i = find(host, port);
+        if (i < 0)
+            return;
+
+        memset(&_entries[i], 0, sizeof(entry_t));
+        _dirty = true;
+    }
+
+    // Remove all sessions
+    void clear()
+    {
+        guard g(this);
+        memset(_entries, 0, sizeof(_entries));
+        _stamp = 0;
+        _dirty = true;
+    }
+
+    // Get the number of cached sessions
+    size_t size() const
+    {
+        guard g(this);
+        size_t n = 0;
+        for (int i = 0; i < BSSL_SESSION_CACHE_SIZE; i++)
+        {
+            if (_entries[i].stamp > 0)
+                n++;
+        }
+        return n;
+    }
+
+    // Check whether the sessions were changed since the last serialize or deserialize
+    bool dirty() const { return _dirty; }
+
+    // Mark the sessions as changed e.g. when the serialized data could not be stored
+    void setDirty() { _dirty = true; }
+
+    // Get the buffer size required by serialize
+    size_t serializedSize() const
+    {
+        guard g(this);
+        size_t total = header_size;
+        for (int i = 0; i < BSSL_SESSION_CACHE_SIZE; i++)
+        {
+            if (_entries[i].stamp > 0)
+                total += entry_size + strlen(_entries[i].host);
+        }
+        return total;
+    }
+
+    // Write the sessions to buffer in the order of least recently used first,
+    // returns the number of bytes written or 0 if buffer is too small
+    size_t serialize(uint8_t *buf, size_t len)
+    {
+        guard g(this);
+        size_t total = serializedSize();
+        if (!buf || len < total)
+            return 0;
+
+        memcpy(buf, "BSC2", 4);
+        buf[4] = (uint8_t)size();
+        uint8_t *p = buf + header_size;
+
+        uint32_t last = 0;
+        for (size_t n = buf[4]; n > 0; n--)
+        {
+            // the next older entry
+            int i = -1;
+            for (int j = 0; j < BSSL_SESSION_CACHE_SIZE; j++)
+            {
+                if (_entries[j].stamp > last && (i < 0 || _entries[j].stamp < _entries[i].stamp))
+                    i = j;
+            }
+            last = _entries[i].stamp;
+
+            const br_ssl_session_parameters &s = _entries[i].params;
+            size_t hostLen = strlen(_entries[i].host);
+            *p++ = (uint8_t)hostLen;
+            memcpy(p, _entries[i].host, hostLen);
+            p += hostLen;
+            p = put16(p, _entries[i].port);
+            *p++ = s.session_id_len;
+            memcpy(p, s.session_id, sizeof(s.session_id));
+            p += sizeof(s.session_id);
+            p = put16(p, s.version);
+            p = put16(p, s.cipher_suite);
+            memcpy(p, s.master_secret, sizeof(s.master_secret));
+            p += sizeof(s.master_secret);
+        }
+
+        _dirty = false;
+        return total;
+    }
+
+    // Restore the sessions from serialized data, the current sessions will be replaced
+    bool deserialize(const uint8_t *buf, size_t len)
+    {
+        // the sessions of the old format (without host name) are dropped
+        if (!buf || len < header_size || memcmp(buf, "BSC2", 4) != 0)
+            return false;
+
+        guard g(this);
+        clear();
+
+        const uint8_t *p = buf + header_size, *end = buf + len;
+        // keep the most recently used entries when the cache size was reduced
+        size_t skip = buf[4] > BSSL_SESSION_CACHE_SIZE ? buf[4] - BSSL_SESSION_CACHE_SIZE : 0;
+
+        for (size_t i = 0; i < buf[4]; i++)
+        {
+            if (p >= end || *p > BSSL_SESSION_CACHE_HOST_LEN || (size_t)(end - p) < entry_size + *p)
+            {
+                clear();
+                return false;
+            }
+
+            if (i < skip)
+            {
+                p += entry_size + *p;
+                continue;
+            }
+
+            entry_t &e = _entries[i - skip];
+            size_t hostLen = *p++;
+            memcpy(e.host, p, hostLen);
+            e.host[hostLen] = 0;
+            p += hostLen;
+            e.port = get16(p);
+            p += 2;
+            e.params.session_id_len = *p++;
+            memcpy(e.params.session_id, p, sizeof(e.params.session_id));
+            p += sizeof(e.params.session_id);
+            e.params.version = get16(p);
+            e.params.cipher_suite = get16(p + 2);
+            p += 4;
+            memcpy(e.params.master_secret, p, sizeof(e.params.master_secret));
+            p += sizeof(e.params.master_secret);
+            e.stamp = ++_stamp;
+
+            if (e.params.session_id_len == 0 || e.params.session_id_len > sizeof(e.params.session_id))
+            {
+                clear();
+                return false;
+            }
+        }
+
+        _dirty = false;
+        return true;
+    }
+
+private:
+    struct entry_t
+    {
+        char host[BSSL_SESSION_CACHE_HOST_LEN + 1];
+        uint16_t port;
+        // the last use order, 0 for empty entry
+        uint32_t stamp;
+        br_ssl_session_parameters params;
+    };
+
+    static const size_t header_size = 5;
+    // without the host name
+    static const size_t entry_size = 1 + 2 + 1 + 32 + 2 + 2 + 48;
+
+    entry_t _entries[BSSL_SESSION_CACHE_SIZE];
+    uint32_t _stamp = 0;
+    bool _dirty = false;
+
+#if defined(BSSL_SESSION_CACHE_LOCK)
+    SemaphoreHandle_t _lock = NULL;
+#endif
+
+    // Hold the recursive lock of cache until going out of scope
+    class guard
+    {
+    public:
+        guard(const BearSSL_SessionCache *cache) : _cache(cache)
+        {
+#if defined(BSSL_SESSION_CACHE_LOCK)
+            if (_cache->_lock)
+                xSemaphoreTakeRecursive(_cache->_lock, portMAX_DELAY);
+#endif
+        }
+
+        ~guard()
+        {
+#if defined(BSSL_SESSION_CACHE_LOCK)
+            if (_cache->_lock)
+                xSemaphoreGiveRecursive(_cache->_lock);
+#endif
+        }
+
+    private:
+        const BearSSL_SessionCache *_cache;
+    };
+
+    // The host name is compared in full (case-insensitive), the session is never offered to other host
+    int find(const char *host, uint16_t port)
+    {
+        if (!host || !*host)
+            return -1;
+
+        for (int i = 0; i < BSSL_SESSION_CACHE_SIZE; i++)
+        {
+            if (_entries[i].stamp > 0 && _entries[i].port == port && strcasecmp(_entries[i].host, host) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    static uint8_t *put16(uint8_t *p, uint16_t v)
+    {
+        p[0] = v & 0xff;
+        p[1] = v >> 8;
+        return p + 2;
+    }
+
+    static uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+};
+
 static const uint16_t suites_P[] PROGMEM = {
 #ifndef BEARSSL_SSL_BASIC
     BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
@@ -599,6 +599,8 @@ int BSSL_SSL_Client::availableForWrite()
 
 void BSSL_SSL_Client::setSession(BearSSL_Session *session) { _session = session; };
 
+void BSSL_SSL_Client::setSessionCache(BearSSL_SessionCache *cache) { _session_cache = cache; };
+
 // Assume a given public key, don't validate or use cert info at all
 void BSSL_SSL_Client::setKnownKey(const PublicKey *pk, unsigned usages)
 {
@@ -1565,16 +1567,22 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
 
     br_ssl_engine_inject_entropy(_eng, rng_seeds, sizeof rng_seeds);
 
+    // The shared session of this server takes precedence over the session storage spot
+    br_ssl_session_parameters cached;
+    bool resume = _session_cache && _session_cache->get(host, _port, &cached);
+    if (resume && _session)
+        memcpy(_session->getSession(), &cached, sizeof(cached));
+
     // Restore session from the storage spot, if present
-    if (_session)
+    if (_session || resume)
     {
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
         esp_ssl_debug_print(PSTR("Set SSL session!"), _debug_level, esp_ssl_debug_info, __func__);
 #endif
-        br_ssl_engine_set_session_parameters(_eng, _session->getSession());
+        br_ssl_engine_set_session_parameters(_eng, _session ? _session->getSession() : &cached);
     }
 
-    if (!br_ssl_client_reset(_sc.get(), host, _session ? 1 : 0))
+    if (!br_ssl_client_reset(_sc.get(), host, (_session || resume) ? 1 : 0))
     {
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
         esp_ssl_debug_print(PSTR("Can't reset client."), _debug_level, esp_ssl_debug_error, __func__);
@@ -1596,6 +1604,9 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
         esp_ssl_debug_print(PSTR("Failed to initlalize the SSL layer."), _debug_level, esp_ssl_debug_error, __func__);
         mPrintSSLError(br_ssl_engine_last_error(_eng), esp_ssl_debug_error, __func__);
 #endif
+        // Don't offer the same session again
+        if (_session_cache)
+            _session_cache->remove(host, _port);
         mFreeSSL();
         return 0;
     }
@@ -1612,6 +1623,12 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
     if (_session)
         br_ssl_engine_get_session_parameters(_eng, _session->getSession());
 
+    if (_session_cache)
+    {
+        br_ssl_engine_get_session_parameters(_eng, &cached);
+        _session_cache->put(host, _port, &cached);
+    }
+
     // Session is already validated here, there is no need to keep following
     _x509_minimal = nullptr;
     _x509_insecure = nullptr;
@@ -2078,6 +2095,7 @@ void BSSL_SSL_Client::mClear()
     _recvapp_len = 0;
     _oom_err = false;
     _session = nullptr;
+    _session_cache = nullptr;
     freeImpl(&_cipher_list);
     _cipher_cnt = 0;
     _tls_min = BR_TLS10;
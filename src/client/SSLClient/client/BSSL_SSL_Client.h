@@ -172,6 +172,8 @@ public:
 
     void setSession(BearSSL_Session *session);
 
+    void setSessionCache(BearSSL_SessionCache *cache);
+
     void setKnownKey(const PublicKey *pk, unsigned usages = BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN);
 
     bool setFingerprint(const uint8_t fingerprint[20]);
@@ -343,6 +345,9 @@ private:
     // Will be used on connect and updated on close
     BearSSL_Session *_session = nullptr;
 
+    // Optional shared sessions of servers, used on connect and updated after handshake
+    BearSSL_SessionCache *_session_cache = nullptr;
+
     bool _use_insecure = false;
     bool _use_fingerprint = false;
     uint8_t _fingerprint[20];
@@ -159,8 +159,7 @@ int BSSL_TCP_Client::read()
 
 int BSSL_TCP_Client::read(uint8_t *buf, size_t size)
 {
-    if (!_ssl_client.connected())
-        return 0;
+    // The data that server sent before closing the connection is still readable.
     return _ssl_client.read(buf, size);
 }
 
@@ -305,6 +304,8 @@ int BSSL_TCP_Client::availableForWrite() { return _ssl_client.availableForWrite(
 
 void BSSL_TCP_Client::setSession(BearSSL_Session *session) { _ssl_client.setSession(session); };
 
+void BSSL_TCP_Client::setSessionCache(BearSSL_SessionCache *cache) { _ssl_client.setSessionCache(cache); };
+
 void BSSL_TCP_Client::setKnownKey(const PublicKey *pk, unsigned usages)
 {
     _ssl_client.setKnownKey(pk, usages);
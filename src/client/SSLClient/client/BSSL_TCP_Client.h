@@ -348,6 +348,15 @@ public:
 
     void setSession(BearSSL_Session *session);
 
+    /**
+     * Set the shared TLS session cache.
+     * @param cache The pointer to BearSSL_SessionCache that holds the sessions of servers.
+     *
+     * The session of the same server (host and port) that established by any client which shares this cache
+     * will be resumed on connect to skip the full handshake.
+     */
+    void setSessionCache(BearSSL_SessionCache *cache);
+
     void setKnownKey(const PublicKey *pk, unsigned usages = BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN);
 
     /**
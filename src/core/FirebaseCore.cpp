@@ -69,6 +69,8 @@ bool FirebaseCore::parseSAFile()
     if (!config || config->signer.pk.length() > 0)
         return ret;
 
+    firebase_mutex_guard guard(internal.file_mutex);
+
     int res = mbfs.open(config->service_account.json.path, mbfs_type config->service_account.json.storage_type, mb_fs_open_mode_read);
 
     if (res >= 0)
@@ -208,7 +210,9 @@ bool FirebaseCore::checkAuthTypeChanged(FirebaseConfig *config, FirebaseAuth *au
         else if (strlen(config->signer.tokens.legacy_token) > 0)
         {
             setTokenType(token_type_legacy_token);
+            internal.token_mutex.lock();
             internal.auth_token = config->signer.tokens.legacy_token;
+            internal.token_mutex.unlock();
             internal.ltok_len = strlen(config->signer.tokens.legacy_token);
             internal.rtok_len = 0;
             internal.atok_len = 0;
@@ -484,6 +488,10 @@ bool FirebaseCore::handleToken()
                                 config->signer.tokens.status = token_status_uninitialized;
                         }
 
+                        // the unexpired access token from previous boot is used instead of JWT generation and token exchange
+                        if (config->signer.tokens.token_type == token_type_oauth2_access_token && !accessTokenCacheLoaded && loadAccessToken())
+                            return true;
+
                         // if no token status set, set the states
                         if (config->signer.tokens.status != token_status_on_initialize)
                         {
@@ -657,11 +665,16 @@ void FirebaseCore::tokenProcessingTask()
     // All sessions should be closed
     freeClient(&tcpClient);
 
-    for (size_t i = 0; i < Core.internal.sessions.size(); i++)
+    internal.session_mutex.lock();
+    for (size_t i = 0; i < internal.sessions.size(); i++)
     {
-        if (Core.internal.sessions[i].status)
+        if (internal.sessions[i].status)
+        {
+            internal.session_mutex.unlock();
             return;
+        }
     }
+    internal.session_mutex.unlock();
 
     // return when task is currently running
     if (config->signer.tokenTaskRunning)
@@ -855,11 +868,7 @@ bool FirebaseCore::refreshToken()
         {
 
             if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_14 /* "id_token" */))
-            {
-                internal.auth_token = resultPtr->to<const char *>();
-                internal.atok_len = strlen(resultPtr->to<const char *>());
-                internal.ltok_len = 0;
-            }
+                setAuthToken(resultPtr->to<const char *>());
 
             if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_12 /* "refresh_token" */))
             {
@@ -1327,9 +1336,12 @@ bool FirebaseCore::createJWT()
         // generate RSA signature from private key and message digest
         config->signer.signature = new unsigned char[config->signer.signatureSize];
 
+        // the fastest implementation available on this platform, i62 (64-bit multiply), i31 or i15 (slow multiply)
+        br_rsa_pkcs1_sign rsa_sign = br_rsa_pkcs1_sign_get_default();
+
         FBUtils::idle();
-        int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
-                                        br_sha256_SIZE, br_rsa_key, config->signer.signature);
+        int ret = rsa_sign(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
+                           br_sha256_SIZE, br_rsa_key, config->signer.signature);
         FBUtils::idle();
         mbfs.delP(&config->signer.hash);
 
@@ -1350,7 +1362,7 @@ bool FirebaseCore::createJWT()
             config->signer.encSignature.clear();
         }
         else
-            return handleError(FIREBASE_ERROR_TOKEN_SIGN, (const char *)FPSTR("BearSSL, br_rsa_i15_pkcs1_sign: "));
+            return handleError(FIREBASE_ERROR_TOKEN_SIGN, (const char *)FPSTR("BearSSL, br_rsa_pkcs1_sign: "));
     }
 
 #endif
@@ -1470,11 +1482,7 @@ bool FirebaseCore::getIdToken(bool createUser, MB_StringPtr email, MB_StringPtr
             }
 
             if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_45 /* "idToken" */))
-            {
-                internal.auth_token = resultPtr->to<const char *>();
-                internal.atok_len = strlen(resultPtr->to<const char *>());
-                internal.ltok_len = 0;
-            }
+                setAuthToken(resultPtr->to<const char *>());
 
             if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_46 /* "refreshToken" */))
             {
@@ -1520,7 +1528,11 @@ bool FirebaseCore::deleteIdToken(MB_StringPtr idToken)
     if (_idToken.length() > 0)
         jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), _idToken);
     else
-        jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), internal.auth_token);
+    {
+        MB_String token;
+        appendAuthToken(token);
+        jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), token);
+    }
 
     MB_String req;
     hh.addRequestHeaderFirst(req, http_post);
@@ -1558,11 +1570,11 @@ bool FirebaseCore::deleteIdToken(MB_StringPtr idToken)
 
         if (error.code == 0)
         {
-            if (_idToken.length() == 0 || strcmp(internal.auth_token.c_str(), _idToken.c_str()) == 0)
+            MB_String token;
+            appendAuthToken(token);
+            if (_idToken.length() == 0 || strcmp(token.c_str(), _idToken.c_str()) == 0)
             {
-                internal.auth_token.clear();
-                internal.atok_len = 0;
-                internal.ltok_len = 0;
+                setAuthToken("");
                 config->signer.tokens.expires = 0;
                 config->signer.step = firebase_jwt_generation_step_begin;
                 internal.fb_last_jwt_generation_error_cb_millis = 0;
@@ -1617,9 +1629,227 @@ void FirebaseCore::closeSession(Firebase_TCP_Client *client, firebase_session_in
         session->rtdb.data_tmo = false;
         session->rtdb.new_stream = true;
     }
+
+    if (session && session->rtdb.pipeline.pending.size() > 0)
+    {
+        struct firebase_rtdb_pipeline_info_t &pl = session->rtdb.pipeline;
+
+        int code = session->response.code == FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT
+                       ? FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT
+                       : FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+        MB_String err;
+        errorToString(code, err);
+
+        // the callback may send the new request on this session
+        MB_VECTOR<RTDB_AsyncResultInfo> pending;
+        pending.swap(pl.pending);
+
+        pl.state = firebase_rtdb_pipeline_read_status;
+        pl.line.clear();
+        pl.body.clear();
+
+        for (size_t i = 0; i < pending.size(); i++)
+        {
+            pending[i].httpCode = code;
+            pending[i].errorMsg = err;
+            if (pl.cb)
+                pl.cb(pending[i]);
+        }
+    }
 #endif
 }
 
+void FirebaseCore::setSSLSession(Firebase_TCP_Client *client, BearSSL_Session *session)
+{
+    if (!client)
+        return;
+
+    // restore the sessions once and keep the file updated with the sessions of previous connections,
+    // the file is accessed only when no other file was opened on that storage e.g. the file download
+    // is in progress, and the changes are written not more often than FIREBASE_SSL_SESSION_CACHE_SAVE_INTERVAL
+    if (config && config->ssl_session_cache.file.length() > 0 && internal.file_mutex.tryLock())
+    {
+        if (!mbfs.ready(mbfs_type config->ssl_session_cache.file_storage))
+        {
+            if (!sslSessionCacheLoaded)
+                loadSSLSessionCache();
+            else if (sslSessionCache.dirty() && millis() - sslSessionCacheSaveMillis >= FIREBASE_SSL_SESSION_CACHE_SAVE_INTERVAL)
+                saveSSLSessionCache();
+        }
+        internal.file_mutex.unlock();
+    }
+
+    client->setSession(session);
+    client->setSessionCache(&sslSessionCache);
+}
+
+bool FirebaseCore::loadSSLSessionCache()
+{
+    sslSessionCacheLoaded = true;
+    sslSessionCacheSaveMillis = millis();
+
+    if (!config || config->ssl_session_cache.file.length() == 0)
+        return false;
+
+    firebase_mutex_guard guard(internal.file_mutex);
+
+    int sz = mbfs.open(config->ssl_session_cache.file, mbfs_type config->ssl_session_cache.file_storage, mb_fs_open_mode_read);
+    if (sz < 0)
+        return false;
+
+    bool ret = false;
+
+    if (sz > 0)
+    {
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs.newP(sz));
+        if (buf && mbfs.read(mbfs_type config->ssl_session_cache.file_storage, buf, sz) == sz)
+            ret = sslSessionCache.deserialize(buf, sz);
+        mbfs.delP(&buf);
+    }
+
+    mbfs.close(mbfs_type config->ssl_session_cache.file_storage);
+
+    return ret;
+}
+
+bool FirebaseCore::saveSSLSessionCache()
+{
+    if (!config || config->ssl_session_cache.file.length() == 0)
+        return false;
+
+    size_t len = sslSessionCache.serializedSize();
+    uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs.newP(len));
+    if (!buf)
+        return false;
+
+    bool ret = false;
+
+    firebase_mutex_guard guard(internal.file_mutex);
+
+    if (sslSessionCache.serialize(buf, len) == len &&
+        mbfs.open(config->ssl_session_cache.file, mbfs_type config->ssl_session_cache.file_storage, mb_fs_open_mode_write) >= 0)
+    {
+        ret = mbfs.write(mbfs_type config->ssl_session_cache.file_storage, buf, len) == (int)len;
+        mbfs.close(mbfs_type config->ssl_session_cache.file_storage);
+    }
+
+    mbfs.delP(&buf);
+
+    sslSessionCacheSaveMillis = millis();
+
+    // the sessions were not written, try again later
+    if (!ret)
+        sslSessionCache.setDirty();
+
+    return ret;
+}
+
+bool FirebaseCore::loadAccessToken()
+{
+    if (!config || config->token_cache.file.length() == 0)
+        return false;
+
+    // the expiry time can't be verified without the valid time, try again later
+    time_t now = getTime();
+    if (now < FIREBASE_DEFAULT_TS)
+        return false;
+
+    accessTokenCacheLoaded = true;
+
+    firebase_mutex_guard guard(internal.file_mutex);
+
+    int sz = mbfs.open(config->token_cache.file, mbfs_type config->token_cache.file_storage, mb_fs_open_mode_read);
+    if (sz < 0)
+        return false;
+
+    bool ret = false;
+
+    // "FBT1", client_email crc, project_id crc, private_key crc, expiry timestamp, token type length, token type and token
+    if (sz > 15)
+    {
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs.newP(sz + 1));
+
+        if (buf && mbfs.read(mbfs_type config->token_cache.file_storage, buf, sz) == sz && memcmp(buf, "FBT1", 4) == 0)
+        {
+            uint16_t crc1 = buf[4] | buf[5] << 8, crc2 = buf[6] | buf[7] << 8, crc3 = buf[8] | buf[9] << 8;
+            uint32_t exp = (uint32_t)buf[10] | (uint32_t)buf[11] << 8 | (uint32_t)buf[12] << 16 | (uint32_t)buf[13] << 24;
+            int typeLen = buf[14];
+
+            if (crc1 == internal.client_email_crc && crc2 == internal.project_id_crc && crc3 == internal.priv_key_crc &&
+                (time_t)(exp - config->signer.preRefreshSeconds) > now && sz > 15 + typeLen)
+            {
+                config->signer.tokens.auth_type.clear();
+                config->signer.tokens.auth_type.append(reinterpret_cast<char *>(buf + 15), typeLen);
+                internal.token_mutex.lock();
+                internal.auth_token.clear();
+                internal.auth_token.append(reinterpret_cast<char *>(buf + 15 + typeLen), sz - 15 - typeLen);
+                internal.token_mutex.unlock();
+                internal.atok_len = internal.auth_token.length();
+                internal.ltok_len = 0;
+                config->signer.tokens.expires = exp;
+                config->signer.tokens.last_millis = millis();
+                config->signer.tokens.error.message.clear();
+                config->signer.tokens.status = token_status_ready;
+                config->signer.step = firebase_jwt_generation_step_begin;
+                internal.fb_last_jwt_generation_error_cb_millis = 0;
+                sendTokenStatusCB();
+                ret = true;
+            }
+        }
+
+        mbfs.delP(&buf);
+    }
+
+    mbfs.close(mbfs_type config->token_cache.file_storage);
+
+    return ret;
+}
+
+bool FirebaseCore::saveAccessToken()
+{
+    // the token without valid expiry timestamp can't be reused after reboot
+    if (!config || config->token_cache.file.length() == 0 || internal.atok_len == 0 ||
+        config->signer.tokens.expires < FIREBASE_DEFAULT_TS || config->signer.tokens.auth_type.length() > 255)
+        return false;
+
+    MB_String token;
+    appendAuthToken(token);
+
+    size_t typeLen = config->signer.tokens.auth_type.length();
+    size_t len = 15 + typeLen + token.length();
+    uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs.newP(len));
+    if (!buf)
+        return false;
+
+    uint32_t exp = config->signer.tokens.expires;
+    memcpy(buf, "FBT1", 4);
+    buf[4] = internal.client_email_crc & 0xff;
+    buf[5] = internal.client_email_crc >> 8;
+    buf[6] = internal.project_id_crc & 0xff;
+    buf[7] = internal.project_id_crc >> 8;
+    buf[8] = internal.priv_key_crc & 0xff;
+    buf[9] = internal.priv_key_crc >> 8;
+    for (int i = 0; i < 4; i++)
+        buf[10 + i] = (exp >> (8 * i)) & 0xff;
+    buf[14] = typeLen;
+    memcpy(buf + 15, config->signer.tokens.auth_type.c_str(), typeLen);
+    memcpy(buf + 15 + typeLen, token.c_str(), token.length());
+
+    bool ret = false;
+
+    firebase_mutex_guard guard(internal.file_mutex);
+
+    if (mbfs.open(config->token_cache.file, mbfs_type config->token_cache.file_storage, mb_fs_open_mode_write) >= 0)
+    {
+        ret = mbfs.write(mbfs_type config->token_cache.file_storage, buf, len) == (int)len;
+        mbfs.close(mbfs_type config->token_cache.file_storage);
+    }
+
+    mbfs.delP(&buf);
+
+    return ret;
+}
+
 bool FirebaseCore::reconnect(Firebase_TCP_Client *client, firebase_session_info_t *session, unsigned long dataTime)
 {
 
@@ -1777,7 +2007,7 @@ bool FirebaseCore::initClient(PGM_P subDomain, firebase_auth_token_status status
     hh.addGAPIsHost(host, subDomain);
 
     FBUtils::idle();
-    tcpClient->setSession(&bsslSession);
+    setSSLSession(tcpClient, &bsslSession);
     tcpClient->begin(host.c_str(), 443, &response_code);
 
     return true;
@@ -1806,7 +2036,11 @@ bool FirebaseCore::requestTokens(bool refresh)
     {
         // {"token":"<sutom or signed jwt token>","returnSecureToken":true}
         if (config->signer.customTokenCustomSet)
-            jsonPtr->add(pgm2Str(firebase_pgm_str_18 /* "token" */), internal.auth_token.c_str());
+        {
+            MB_String token;
+            appendAuthToken(token);
+            jsonPtr->add(pgm2Str(firebase_pgm_str_18 /* "token" */), token.c_str());
+        }
         else
             jsonPtr->add(pgm2Str(firebase_pgm_str_18 /* "token" */), config->signer.tokens.jwt.c_str());
 
@@ -1906,11 +2140,7 @@ bool FirebaseCore::requestTokens(bool refresh)
             if (config->signer.tokens.token_type == token_type_custom_token)
             {
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_45 /* "idToken" */))
-                {
-                    internal.auth_token = resultPtr->to<const char *>();
-                    internal.atok_len = strlen(resultPtr->to<const char *>());
-                    internal.ltok_len = 0;
-                }
+                    setAuthToken(resultPtr->to<const char *>());
 
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_46 /* "refreshToken" */))
                 {
@@ -1924,17 +2154,15 @@ bool FirebaseCore::requestTokens(bool refresh)
             else if (config->signer.tokens.token_type == token_type_oauth2_access_token)
             {
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_57 /* "access_token" */))
-                {
-                    internal.auth_token = resultPtr->to<const char *>();
-                    internal.atok_len = strlen(resultPtr->to<const char *>());
-                    internal.ltok_len = 0;
-                }
+                    setAuthToken(resultPtr->to<const char *>());
 
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_58 /* "token_type" */))
                     config->signer.tokens.auth_type = resultPtr->to<const char *>();
 
                 if (jh.parse(jsonPtr, resultPtr, firebase_auth_pgm_str_15 /* "expires_in" */))
                     getExpiration(resultPtr->to<const char *>());
+
+                saveAccessToken();
             }
             return handleTaskError(FIREBASE_ERROR_TOKEN_COMPLETE_NOTIFY);
         }
@@ -1988,7 +2216,11 @@ bool FirebaseCore::handleEmailSending(MB_StringPtr payload, firebase_user_email_
         if (_payload.length() > 0)
             jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), _payload);
         else
-            jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), internal.auth_token.c_str());
+        {
+            MB_String token;
+            appendAuthToken(token);
+            jsonPtr->add(pgm2Str(firebase_auth_pgm_str_45 /* "idToken" */), token.c_str());
+        }
     }
     else if (type == firebase_user_email_sending_type_reset_psw)
     {
@@ -2053,8 +2285,12 @@ bool FirebaseCore::checkToken()
     if (!config || !auth)
         return false;
 
-    if (isAuthToken(true) && isExpired())
+    // only one task processes the token, the others check its status
+    if (isAuthToken(true) && isExpired() && internal.token_task_mutex.tryLock())
+    {
         handleToken();
+        internal.token_task_mutex.unlock();
+    }
 
     return config->signer.tokens.status == token_status_ready;
 }
@@ -2323,6 +2559,21 @@ void FirebaseCore::errorToString(int httpCode, MB_String &buff)
     case FIREBASE_ERROR_USER_PAUSE:
         buff += firebase_rtdb_err_pgm_str_5; // "the FirebaseData object was paused"
         break;
+    case FIREBASE_ERROR_INVALID_JSON_DATA:
+        buff += firebase_rtdb_err_pgm_str_6; // "invalid JSON data"
+        return;
+    case FIREBASE_ERROR_INVALID_BATCH_PATH:
+        buff += firebase_rtdb_err_pgm_str_7; // "invalid or overlapped batch path"
+        return;
+    case FIREBASE_ERROR_FILE_CHUNKS_INCOMPLETE:
+        buff += firebase_rtdb_err_pgm_str_8; // "file chunks are missing or incomplete"
+        return;
+    case FIREBASE_ERROR_FILE_CHUNKS_CRC_MISMATCH:
+        buff += firebase_rtdb_err_pgm_str_9; // "file chunks CRC mismatch"
+        return;
+    case FIREBASE_ERROR_FILE_CHUNKS_OUT_OF_MEMORY:
+        buff += firebase_rtdb_err_pgm_str_10; // "not enough memory for the file chunk"
+        return;
 
     case FIREBASE_ERROR_NO_FCM_ID_TOKEN_PROVIDED:
         buff += firebase_fcm_err_pgm_str_1; // "no ID token or registration token provided"
@@ -2363,6 +2614,34 @@ const char *FirebaseCore::getToken()
     return internal.auth_token.c_str();
 }
 
+void FirebaseCore::setAuthToken(const char *token)
+{
+    internal.token_mutex.lock();
+    internal.auth_token = token;
+    internal.token_mutex.unlock();
+    internal.atok_len = strlen(token);
+    internal.ltok_len = 0;
+}
+
+void FirebaseCore::appendAuthToken(MB_String &buf)
+{
+    internal.token_mutex.lock();
+    buf += internal.auth_token;
+    internal.token_mutex.unlock();
+}
+
+void FirebaseCore::copyToken(MB_String &buf)
+{
+    firebase_mutex_guard guard(internal.token_mutex);
+    buf = getToken();
+}
+
+size_t FirebaseCore::tokenLength()
+{
+    firebase_mutex_guard guard(internal.token_mutex);
+    return strlen(getToken());
+}
+
 const char *FirebaseCore::getRefreshToken()
 {
     if (!config)
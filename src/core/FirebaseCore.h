@@ -59,6 +59,7 @@ class FirebaseCore
     friend class FB_RTDB;
     friend class FirebaseData;
     friend class QueryFilter;
+    friend class RTDBBatch;
 
 public:
     FirebaseCore();
@@ -77,6 +78,10 @@ private:
     uint32_t tsOffset = 0;
     struct firebase_cfg_int_t internal;
     BearSSL_Session bsslSession;
+    BearSSL_SessionCache sslSessionCache;
+    bool sslSessionCacheLoaded = false;
+    unsigned long sslSessionCacheSaveMillis = 0;
+    bool accessTokenCacheLoaded = false;
     FirebaseConfig *config = nullptr;
     FirebaseAuth *auth = nullptr;
     firebase_wifi wifiCreds;
@@ -183,6 +188,14 @@ private:
     void sendTokenStatusCB();
     /* get auth token */
     const char *getToken();
+    /* set the auth token which is shared by the tasks */
+    void setAuthToken(const char *token);
+    /* append the auth token to the buffer while it is not being changed by other task */
+    void appendAuthToken(MB_String &buf);
+    /* copy the auth token as getToken while it is not being changed by other task */
+    void copyToken(MB_String &buf);
+    /* get the length of auth token as getToken while it is not being changed by other task */
+    size_t tokenLength();
     /* get refresh token */
     const char *getRefreshToken();
     /* check for authentication type changes */
@@ -208,6 +221,16 @@ private:
     void resumeNetwork(Firebase_TCP_Client *client, bool &net_once_connected, unsigned long &last_reconnect_millis, uint16_t &net_reconnect_tmo);
     /* close TCP session */
     void closeSession(Firebase_TCP_Client *client, firebase_session_info_t *session);
+    /* assign the TLS session storage and the shared TLS session cache to client */
+    void setSSLSession(Firebase_TCP_Client *client, BearSSL_Session *session);
+    /* read the shared TLS sessions from file */
+    bool loadSSLSessionCache();
+    /* write the shared TLS sessions to file */
+    bool saveSSLSessionCache();
+    /* restore the unexpired OAuth2.0 access token from file */
+    bool loadAccessToken();
+    /* write the OAuth2.0 access token and its expiry time to file */
+    bool saveAccessToken();
     /* set external Client */
     void setTCPClient(Firebase_TCP_Client *tcpClient);
     /* set the network status acknowledge */
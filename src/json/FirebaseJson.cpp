@@ -41,6 +41,281 @@
 
 #include "FirebaseJson.h"
 
+#if defined(FIREBASEJSON_POOL_TASK_TABLE) || defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+std::atomic<int> FirebaseJsonPool::scopes(0);
+#endif
+
+#if defined(FIREBASEJSON_POOL_TASK_TABLE)
+FirebaseJsonPool::task_pool_t FirebaseJsonPool::taskPools[FIREBASEJSON_POOL_MAX_TASKS];
+#if defined(ESP32)
+portMUX_TYPE FirebaseJsonPool::taskPoolsMux = portMUX_INITIALIZER_UNLOCKED;
+#define FIREBASEJSON_POOL_LOCK() portENTER_CRITICAL(&taskPoolsMux)
+#define FIREBASEJSON_POOL_UNLOCK() portEXIT_CRITICAL(&taskPoolsMux)
+#else
+#define FIREBASEJSON_POOL_LOCK() taskENTER_CRITICAL()
+#define FIREBASEJSON_POOL_UNLOCK() taskEXIT_CRITICAL()
+#endif
+#elif defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+thread_local FirebaseJsonPool *FirebaseJsonPool::active = NULL;
+#else
+FirebaseJsonPool *FirebaseJsonPool::active = NULL;
+#endif
+
+// Install the hooks before any element can be allocated, the hooks expect their allocation header
+static struct fb_js_hooks_init_t
+{
+    fb_js_hooks_init_t() { MB_JSON_InitHooks(&MB_JSON_hooks); }
+} fb_js_hooks_init;
+
+// The block header size that keeps the data 8 bytes aligned
+#define FIREBASEJSON_POOL_BLOCK_HEADER ((sizeof(FirebaseJsonPool::block_t) + 7) & ~(size_t)7)
+
+FirebaseJsonPool::FirebaseJsonPool(size_t blockSize)
+{
+    this->blockSize = blockSize > 0 ? blockSize : FIREBASEJSON_POOL_BLOCK_SIZE;
+}
+
+FirebaseJsonPool::~FirebaseJsonPool()
+{
+    while (blocks)
+    {
+        block_t *next = blocks->next;
+        free(blocks);
+        blocks = next;
+    }
+
+    release(this);
+}
+
+void *FirebaseJsonPool::alloc(size_t len)
+{
+    size_t n = ((len + 7) & ~(size_t)7) + FIREBASEJSON_ALLOC_HEADER;
+
+    block_t *b = blocks;
+    if (!b || b->used + n > b->size)
+    {
+        size_t sz = n > blockSize ? n : blockSize;
+        block_t *nb = reinterpret_cast<block_t *>(fb_js_heap_malloc(FIREBASEJSON_POOL_BLOCK_HEADER + sz));
+        if (!nb)
+            return NULL;
+        nb->size = sz;
+        nb->used = 0;
+
+        // keep the free space of current block for the next allocations if this is the large one
+        if (b && sz > blockSize)
+        {
+            nb->next = b->next;
+            b->next = nb;
+        }
+        else
+        {
+            nb->next = blocks;
+            blocks = nb;
+        }
+        b = nb;
+    }
+
+    uint8_t *p = reinterpret_cast<uint8_t *>(b) + FIREBASEJSON_POOL_BLOCK_HEADER + b->used;
+    fb_js_alloc_t *hdr = reinterpret_cast<fb_js_alloc_t *>(p);
+    hdr->pool = this;
+    hdr->len = len;
+    b->used += n;
+    return p + FIREBASEJSON_ALLOC_HEADER;
+}
+
+void *FirebaseJsonPool::resize(void *ptr, size_t len)
+{
+    size_t oldLen = fb_js_alloc_header(ptr)->len;
+    if (len <= oldLen)
+        return ptr;
+
+    void *p = alloc(len);
+    if (p)
+        memcpy(p, ptr, oldLen);
+    return p;
+}
+
+bool FirebaseJsonPool::owns(const void *ptr) const
+{
+    return ptr && find(ptr) == this;
+}
+
+void FirebaseJsonPool::reset()
+{
+    // keep the first allocated block for reuse
+    while (blocks && blocks->next)
+    {
+        block_t *next = blocks->next;
+        free(blocks);
+        blocks = next;
+    }
+
+    if (blocks)
+        blocks->used = 0;
+}
+
+size_t FirebaseJsonPool::size() const
+{
+    size_t sz = 0;
+    for (block_t *b = blocks; b; b = b->next)
+        sz += b->size;
+    return sz;
+}
+
+FirebaseJsonPool *FirebaseJsonPool::current()
+{
+#if defined(FIREBASEJSON_POOL_TASK_TABLE)
+    // no pool is used by any task, allocate from heap without lock
+    if (scopes.load(std::memory_order_acquire) == 0)
+        return NULL;
+
+    // other tasks should not allocate from the pool of the task that is modifying its object
+    void *task = xTaskGetCurrentTaskHandle();
+    FirebaseJsonPool *pool = NULL;
+    FIREBASEJSON_POOL_LOCK();
+    for (size_t i = 0; i < FIREBASEJSON_POOL_MAX_TASKS; i++)
+    {
+        if (taskPools[i].task == task)
+        {
+            pool = taskPools[i].pool;
+            break;
+        }
+    }
+    FIREBASEJSON_POOL_UNLOCK();
+    return pool;
+#elif defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+    return scopes.load(std::memory_order_acquire) == 0 ? NULL : active;
+#else
+    return active;
+#endif
+}
+
+FirebaseJsonPool *FirebaseJsonPool::find(const void *ptr)
+{
+    return ptr ? fb_js_alloc_header(ptr)->pool : NULL;
+}
+
+FirebaseJsonPool *FirebaseJsonPool::setCurrent(FirebaseJsonPool *pool)
+{
+#if defined(FIREBASEJSON_POOL_TASK_TABLE)
+    void *task = xTaskGetCurrentTaskHandle();
+    FirebaseJsonPool *prev = NULL;
+    int slot = -1, freeSlot = -1;
+
+    FIREBASEJSON_POOL_LOCK();
+    for (size_t i = 0; i < FIREBASEJSON_POOL_MAX_TASKS; i++)
+    {
+        if (taskPools[i].task == task)
+        {
+            slot = i;
+            break;
+        }
+        else if (!taskPools[i].task && freeSlot < 0)
+            freeSlot = i;
+    }
+
+    // the task without free slot uses the heap
+    if (slot < 0 && pool)
+        slot = freeSlot;
+
+    if (slot >= 0)
+    {
+        prev = taskPools[slot].pool;
+        taskPools[slot].task = pool ? task : NULL;
+        taskPools[slot].pool = pool;
+    }
+    FIREBASEJSON_POOL_UNLOCK();
+    return prev;
+#else
+    FirebaseJsonPool *prev = active;
+    active = pool;
+    return prev;
+#endif
+}
+
+void FirebaseJsonPool::release(FirebaseJsonPool *pool)
+{
+#if defined(FIREBASEJSON_POOL_TASK_TABLE)
+    if (scopes.load(std::memory_order_acquire) == 0)
+        return;
+
+    FIREBASEJSON_POOL_LOCK();
+    for (size_t i = 0; i < FIREBASEJSON_POOL_MAX_TASKS; i++)
+    {
+        if (taskPools[i].pool == pool)
+        {
+            taskPools[i].task = NULL;
+            taskPools[i].pool = NULL;
+        }
+    }
+    FIREBASEJSON_POOL_UNLOCK();
+#else
+    if (active == pool)
+        active = NULL;
+#endif
+}
+
+FirebaseJsonPool::Scope::Scope(FirebaseJsonPool *pool) : pool(pool)
+{
+#if defined(FIREBASEJSON_POOL_TASK_TABLE) || defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+    // counted before the pool was set, the allocation of this task always sees the pool
+    if (pool)
+        scopes.fetch_add(1, std::memory_order_acq_rel);
+#endif
+    prev = setCurrent(pool);
+}
+
+FirebaseJsonPool::Scope::~Scope()
+{
+    setCurrent(prev);
+#if defined(FIREBASEJSON_POOL_TASK_TABLE) || defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+    if (pool)
+        scopes.fetch_sub(1, std::memory_order_acq_rel);
+#endif
+}
+
+void FirebaseJsonPath::setPath(const char *path)
+{
+    clear();
+    path = path ? path : "";
+    this->path = path;
+
+    const char *p = path;
+    while (true)
+    {
+        const char *end = strchr(p, '/');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        MB_String key;
+        key.append(p, len);
+        key.trim();
+
+        if (key.length() > 0)
+        {
+            int index = -1;
+            if (key[0] == '[' && key[key.length() - 1] == ']')
+            {
+                index = atoi(key.c_str() + 1);
+                if (index < 0)
+                    index = 0;
+            }
+            keys.push_back(key);
+            indexes.push_back(index);
+        }
+
+        if (!end)
+            break;
+        p = end + 1;
+    }
+}
+
+void FirebaseJsonPath::clear()
+{
+    path.clear();
+    keys.clear();
+    indexes.clear();
+}
+
 FirebaseJsonBase::FirebaseJsonBase()
 {
     MB_JSON_InitHooks(&MB_JSON_hooks);
@@ -49,21 +324,78 @@ FirebaseJsonBase::FirebaseJsonBase()
 FirebaseJsonBase::~FirebaseJsonBase()
 {
     mClear();
+    if (pool)
+        delete pool;
+    pool = NULL;
 }
 
 FirebaseJsonBase &FirebaseJsonBase::mClear()
 {
     mIteratorEnd();
-    if (root != NULL)
-        MB_JSON_Delete(root);
-    root = NULL;
+    mDeleteRoot();
     buf.clear();
     errorPos = -1;
     return *this;
 }
+
+void FirebaseJsonBase::mDeleteRoot()
+{
+    mClearIndex();
+
+    // all pooled elements are released at once
+    if (pool)
+        pool->reset();
+    else if (root != NULL)
+        MB_JSON_Delete(root);
+    root = NULL;
+}
+
+void FirebaseJsonBase::mSetPool(bool enable, size_t blockSize)
+{
+    if (enable == (pool != NULL))
+        return;
+
+    mClearIndex();
+
+    FirebaseJsonPool *old = pool;
+    pool = enable ? new FirebaseJsonPool(blockSize) : NULL;
+
+    // move the existing elements to the new allocator
+    if (root != NULL)
+    {
+        MB_JSON *e = NULL;
+        {
+            FirebaseJsonPool::Scope scope(pool);
+            e = MB_JSON_Duplicate(root, true);
+        }
+        if (!old)
+            MB_JSON_Delete(root);
+        root = e;
+    }
+
+    if (old)
+        delete old;
+}
+
+MB_JSON *FirebaseJsonBase::adopt(MB_JSON *value)
+{
+    // the value was created outside the pool scope, copy it to the pool
+    if (!pool || !value || pool->owns(value))
+        return value;
+
+    MB_JSON *e = NULL;
+    {
+        FirebaseJsonPool::Scope scope(pool);
+        e = MB_JSON_Duplicate(value, true);
+    }
+    MB_JSON_Delete(value);
+    return e;
+}
+
 void FirebaseJsonBase::mCopy(FirebaseJsonBase &other)
 {
     mClear();
+    FirebaseJsonPool::Scope scope(pool);
     this->root = MB_JSON_Duplicate(other.root, true);
     this->doubleDigits = other.doubleDigits;
     this->floatDigits = other.floatDigits;
@@ -94,6 +426,7 @@ bool FirebaseJsonBase::setRaw(const char *raw)
         else
         {
             this->root_type = Root_Type_Raw;
+            FirebaseJsonPool::Scope scope(pool);
             root = MB_JSON_CreateRaw(raw);
         }
     }
@@ -104,6 +437,7 @@ bool FirebaseJsonBase::setRaw(const char *raw)
 MB_JSON *FirebaseJsonBase::parse(const char *raw)
 {
     const char *s = NULL;
+    FirebaseJsonPool::Scope scope(pool);
     MB_JSON *e = MB_JSON_ParseWithOpts(raw, &s, 1);
     errorPos = (s - raw != (int)strlen(raw)) ? s - raw : -1;
     return e;
@@ -113,6 +447,7 @@ void FirebaseJsonBase::prepareRoot()
 {
     if (root == NULL)
     {
+        FirebaseJsonPool::Scope scope(pool);
         if (root_type == Root_Type_JSONArray)
             root = MB_JSON_CreateArray();
         else
@@ -120,13 +455,13 @@ void FirebaseJsonBase::prepareRoot()
     }
 }
 
-void FirebaseJsonBase::searchElements(MB_VECTOR<MB_String> &keys, MB_JSON *parent, struct search_result_t &r)
+void FirebaseJsonBase::searchElements(const FirebaseJsonPath &path, MB_JSON *parent, struct search_result_t &r, bool useIndex)
 {
     MB_JSON *e = parent;
-    for (size_t i = 0; i < keys.size(); i++)
+    for (size_t i = 0; i < path.keys.size(); i++)
     {
         r.status = key_status_not_existed;
-        e = getElement(parent, keys[i].c_str(), r);
+        e = getElement(parent, path.keys[i].c_str(), path.indexes[i], r, useIndex);
         r.stopIndex = i;
         if (r.status != key_status_existed)
         {
@@ -140,11 +475,10 @@ void FirebaseJsonBase::searchElements(MB_VECTOR<MB_String> &keys, MB_JSON *paren
     }
 }
 
-MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct search_result_t &r)
+MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, int index, struct search_result_t &r, bool useIndex)
 {
     MB_JSON *e = NULL;
-    bool isArrKey = isArrayKey(key);
-    int index = isArrKey ? getArrIndex(key) : -1;
+    bool isArrKey = index > -1;
     if ((isArray(parent) && !isArrKey) || (isObject(parent) && isArrKey))
         r.status = key_status_mistype;
     else if (isArray(parent) && isArrKey)
@@ -155,7 +489,7 @@ MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct s
     }
     else if (isObject(parent) && !isArrKey)
     {
-        e = MB_JSON_GetObjectItemCaseSensitive(parent, key);
+        e = getObjectItem(parent, key, useIndex);
         if (e == NULL)
             r.status = key_status_not_existed;
     }
@@ -167,7 +501,98 @@ MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct s
     return e;
 }
 
-void FirebaseJsonBase::mAdd(MB_VECTOR<MB_String> keys, MB_JSON **parent, int beginIndex, MB_JSON *value)
+static uint32_t fb_js_hash(const char *key)
+{
+    // FNV-1a
+    uint32_t h = 2166136261UL;
+    while (*key)
+    {
+        h ^= (uint8_t)*key++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+MB_JSON *FirebaseJsonBase::getObjectItem(MB_JSON *parent, const char *key, bool useIndex)
+{
+    if (!useIndex || !index_enabled)
+        return MB_JSON_GetObjectItemCaseSensitive(parent, key);
+
+    index_table_t *table = NULL;
+    for (size_t i = 0; i < index_tables.size(); i++)
+    {
+        if (index_tables[i].parent == parent)
+        {
+            table = &index_tables[i];
+            break;
+        }
+    }
+
+    // build the index of this object lazily
+    if (!table)
+    {
+        size_t n = 0;
+        for (MB_JSON *c = parent->child; c; c = c->next)
+            n++;
+
+        if (n < index_min_size || index_tables.size() >= FIREBASEJSON_INDEX_MAX_OBJECTS)
+            return MB_JSON_GetObjectItemCaseSensitive(parent, key);
+
+        size_t cap = 1;
+        while (cap < n * 2)
+            cap <<= 1;
+
+        index_table_t t;
+        t.parent = parent;
+        t.mask = cap - 1;
+        t.slots = reinterpret_cast<MB_JSON **>(newP(cap * sizeof(MB_JSON *)));
+        if (!t.slots)
+            return MB_JSON_GetObjectItemCaseSensitive(parent, key);
+
+        for (MB_JSON *c = parent->child; c; c = c->next)
+        {
+            if (!c->string)
+                continue;
+
+            size_t h = fb_js_hash(c->string) & t.mask;
+            while (t.slots[h] && strcmp(t.slots[h]->string, c->string) != 0)
+                h = (h + 1) & t.mask;
+
+            // the first one of duplicate keys wins as in linear search
+            if (!t.slots[h])
+                t.slots[h] = c;
+        }
+
+        index_tables.push_back(t);
+        table = &index_tables[index_tables.size() - 1];
+    }
+
+    size_t h = fb_js_hash(key) & table->mask;
+    while (table->slots[h])
+    {
+        if (strcmp(table->slots[h]->string, key) == 0)
+            return table->slots[h];
+        h = (h + 1) & table->mask;
+    }
+
+    return NULL;
+}
+
+void FirebaseJsonBase::mClearIndex()
+{
+    for (size_t i = 0; i < index_tables.size(); i++)
+        delP(&index_tables[i].slots);
+    index_tables.clear();
+}
+
+void FirebaseJsonBase::mSetIndex(bool enable, size_t minSize)
+{
+    mClearIndex();
+    index_enabled = enable;
+    index_min_size = minSize;
+}
+
+void FirebaseJsonBase::mAdd(const MB_VECTOR<MB_String> &keys, MB_JSON **parent, int beginIndex, MB_JSON *value)
 {
     MB_JSON *m_parent = *parent;
 
@@ -258,7 +683,7 @@ MB_JSON *FirebaseJsonBase::addArray(MB_JSON *parent, MB_JSON *e, size_t size)
     return e;
 }
 
-void FirebaseJsonBase::appendArray(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value)
+void FirebaseJsonBase::appendArray(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value)
 {
     MB_JSON *item = NULL;
 
@@ -293,7 +718,7 @@ void FirebaseJsonBase::appendArray(MB_VECTOR<MB_String> &keys, struct search_res
         MB_JSON_Delete(value);
 }
 
-void FirebaseJsonBase::replaceItem(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value)
+void FirebaseJsonBase::replaceItem(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value)
 {
     if (r.foundIndex == -1)
     {
@@ -334,7 +759,7 @@ void FirebaseJsonBase::replaceItem(MB_VECTOR<MB_String> &keys, struct search_res
     }
 }
 
-void FirebaseJsonBase::replace(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item)
+void FirebaseJsonBase::replace(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item)
 {
     if (isArray(parent))
         MB_JSON_ReplaceItemInArray(parent, getArrIndex(keys[r.foundIndex].c_str()), item);
@@ -549,8 +974,7 @@ bool FirebaseJsonBase::mReadClient(Client *client)
     buf.clear();
     if (readClient(client, buf))
     {
-        if (root != NULL)
-            MB_JSON_Delete(root);
+        mDeleteRoot();
         root = parse(buf.c_str());
         buf.clear();
         return root != NULL;
@@ -563,8 +987,7 @@ bool FirebaseJsonBase::mReadStream(Stream *s, int timeoutMS)
     // non-blocking read
     if (readStream(s, serData, buf, true, timeoutMS))
     {
-        if (root != NULL)
-            MB_JSON_Delete(root);
+        mDeleteRoot();
         root = parse(buf.c_str());
         buf.clear();
         return root != NULL;
@@ -578,8 +1001,7 @@ bool FirebaseJsonBase::mReadSdFat(SD_FAT_FILE &file, int timeoutMS)
     // non-blocking read
     if (readSdFatFile(file, serData, buf, true, timeoutMS))
     {
-        if (root != NULL)
-            MB_JSON_Delete(root);
+        mDeleteRoot();
         root = parse(buf.c_str());
         buf.clear();
         return root != NULL;
@@ -597,43 +1019,39 @@ const char *FirebaseJsonBase::mRaw()
 bool FirebaseJsonBase::mRemove(const char *path)
 {
     bool ret = false;
+    mClearIndex();
     prepareRoot();
-    MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
-    makeList(path, keys, '/');
+    FirebaseJsonPath p(path);
 
-    if (keys.size() > 0)
+    if (p.keys.size() > 0)
     {
-        if (isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON)
-        {
-            clearList(keys);
+        if (p.indexes[0] > -1 && root_type == Root_Type_JSON)
             return false;
-        }
     }
 
     MB_JSON *parent = root;
 
     struct search_result_t r;
-    searchElements(keys, parent, r);
+    searchElements(p, parent, r);
     parent = r.parent;
 
     if (r.status == key_status_existed)
     {
         ret = true;
         if (isArray(parent))
-            MB_JSON_DeleteItemFromArray(parent, getArrIndex(keys[r.stopIndex].c_str()));
+            MB_JSON_DeleteItemFromArray(parent, p.indexes[r.stopIndex]);
         else
         {
-            MB_JSON_DeleteItemFromObjectCaseSensitive(parent, keys[r.stopIndex].c_str());
+            MB_JSON_DeleteItemFromObjectCaseSensitive(parent, p.keys[r.stopIndex].c_str());
             if (parent->child == NULL && r.stopIndex > 0)
             {
                 MB_String path;
-                mGetPath(path, keys, 0, r.stopIndex - 1);
+                mGetPath(path, p.keys, 0, r.stopIndex - 1);
                 mRemove(path.c_str());
             }
         }
     }
 
-    clearList(keys);
     return ret;
 }
 
@@ -675,33 +1093,34 @@ int FirebaseJsonBase::mResponseCode()
 }
 
 bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify)
+{
+    FirebaseJsonPath p(path);
+    return mGet(parent, result, p, prettify);
+}
+
+bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify)
 {
     bool ret = false;
     prepareRoot();
-    MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
-    makeList(path, keys, '/');
 
-    if (keys.size() > 0)
+    if (path.keys.size() > 0)
     {
-        if (isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON)
-        {
-            clearList(keys);
+        if (path.indexes[0] > -1 && root_type == Root_Type_JSON)
             return false;
-        }
     }
 
     MB_JSON *_parent = parent;
     struct search_result_t r;
-    searchElements(keys, parent, r);
+    searchElements(path, parent, r, true);
     _parent = r.parent;
 
     if (r.status == key_status_existed)
     {
         MB_JSON *data = NULL;
         if (isArray(_parent))
-            data = MB_JSON_GetArrayItem(_parent, getArrIndex(keys[r.stopIndex].c_str()));
+            data = MB_JSON_GetArrayItem(_parent, path.indexes[r.stopIndex]);
         else
-            data = MB_JSON_GetObjectItemCaseSensitive(_parent, keys[r.stopIndex].c_str());
+            data = getObjectItem(_parent, path.keys[r.stopIndex].c_str(), true);
 
         if (data != NULL)
         {
@@ -719,7 +1138,6 @@ bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const cha
         }
     }
 
-    clearList(keys);
     return ret;
 }
 
@@ -840,38 +1258,42 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
 
 void FirebaseJsonBase::mSet(const char *path, MB_JSON *value)
 {
+    FirebaseJsonPath p(path);
+    mSet(p, value);
+}
+
+void FirebaseJsonBase::mSet(const FirebaseJsonPath &path, MB_JSON *value)
+{
+    mClearIndex();
+    value = adopt(value);
+    FirebaseJsonPool::Scope scope(pool);
     prepareRoot();
-    MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
-    makeList(path, keys, '/');
 
-    if (keys.size() > 0)
+    if (path.keys.size() > 0)
     {
-        if ((isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON) || (!isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSONArray))
+        if ((path.indexes[0] > -1 && root_type == Root_Type_JSON) || (path.indexes[0] == -1 && root_type == Root_Type_JSONArray))
         {
             MB_JSON_Delete(value);
-            clearList(keys);
             return;
         }
     }
 
     MB_JSON *parent = root;
     struct search_result_t r;
-    searchElements(keys, parent, r);
+    searchElements(path, parent, r);
     parent = r.parent;
 
     if (value == NULL)
         value = MB_JSON_CreateNull();
 
     if (r.status == key_status_mistype || r.status == key_status_not_existed)
-        replaceItem(keys, r, parent, value);
+        replaceItem(path.keys, r, parent, value);
     else if (r.status == key_status_out_of_range)
-        appendArray(keys, r, parent, value);
+        appendArray(path.keys, r, parent, value);
     else if (r.status == key_status_existed)
-        replace(keys, r, parent, value);
+        replace(path.keys, r, parent, value);
     else
         MB_JSON_Delete(value);
-
-    clearList(keys);
 }
 
 #if defined(__AVR__)
@@ -906,6 +1328,9 @@ FirebaseJson::~FirebaseJson()
 
 FirebaseJson &FirebaseJson::nAdd(const char *key, MB_JSON *value)
 {
+    mClearIndex();
+    value = adopt(value);
+    FirebaseJsonPool::Scope scope(pool);
     prepareRoot();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
     // makeList(key, keys, '/');
@@ -957,6 +1382,9 @@ FirebaseJsonArray &FirebaseJsonArray::nAdd(MB_JSON *value)
 
     root_type = Root_Type_JSONArray;
 
+    mClearIndex();
+    value = adopt(value);
+    FirebaseJsonPool::Scope scope(pool);
     prepareRoot();
 
     if (value == NULL)
@@ -998,6 +1426,9 @@ bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 
     root_type = Root_Type_JSONArray;
 
+    mClearIndex();
+    value = adopt(value);
+    FirebaseJsonPool::Scope scope(pool);
     prepareRoot();
 
     int size = MB_JSON_GetArraySize(root);
@@ -1017,6 +1448,7 @@ bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 
 bool FirebaseJsonArray::mRemoveIdx(int index)
 {
+    mClearIndex();
     int size = MB_JSON_GetArraySize(root);
     if (index < size)
     {
@@ -1065,8 +1497,7 @@ bool FirebaseJsonData::getArray(FirebaseJsonArray &jsonArray)
 bool FirebaseJsonData::mGetArray(const char *source, FirebaseJsonArray &jsonArray)
 {
 
-    if (jsonArray.root != NULL)
-        MB_JSON_Delete(jsonArray.root);
+    jsonArray.mDeleteRoot();
 
     jsonArray.root = jsonArray.parse(source);
 
@@ -1082,8 +1513,7 @@ bool FirebaseJsonData::getJSON(FirebaseJson &json)
 
 bool FirebaseJsonData::mGetJSON(const char *source, FirebaseJson &json)
 {
-    if (json.root != NULL)
-        MB_JSON_Delete(json.root);
+    json.mDeleteRoot();
 
     json.root = json.parse(source);
 
@@ -1159,4 +1589,466 @@ void FirebaseJsonData::clear()
     success = false;
 }
 
+void FirebaseJsonStreamReader::begin(FirebaseJsonStreamCallback callback)
+{
+    _callback = callback;
+    reset();
+}
+
+void FirebaseJsonStreamReader::reset()
+{
+    _state = st_value;
+    _numState = num_int;
+    _error = false;
+    _inKey = false;
+    _escape = false;
+    _truncated = false;
+    _hexCount = 0;
+    _hex = 0;
+    _highSurrogate = 0;
+    _pos = 0;
+    _depth = 0;
+    _keyLen = 0;
+    _valueLen = 0;
+    _curPathLen = 0;
+    _key[0] = '\0';
+    _value[0] = '\0';
+    _path[0] = '\0';
+}
+
+bool FirebaseJsonStreamReader::feed(const char *data, size_t len)
+{
+    if (_error || !data)
+        return !_error;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!process(data[i]))
+            return false;
+        _pos++;
+    }
+
+    return true;
+}
+
+bool FirebaseJsonStreamReader::end()
+{
+    if (_error)
+        return false;
+
+    // The root scalar number or literal has no terminating character.
+    if (_depth == 0 && (_state == st_number || _state == st_literal))
+    {
+        if (!process(' '))
+            return false;
+    }
+
+    if (_state != st_done)
+        return setError();
+
+    return true;
+}
+
+bool FirebaseJsonStreamReader::process(char c)
+{
+    bool ws = c == ' ' || c == '\t' || c == '\r' || c == '\n';
+
+    switch (_state)
+    {
+    case st_value:
+        if (ws)
+            return true;
+        return beginValue(c);
+
+    case st_value_or_end:
+        if (ws)
+            return true;
+        if (c == ']')
+            return endContainer(c);
+        return beginValue(c);
+
+    case st_key_or_end:
+    case st_key:
+        if (ws)
+            return true;
+        if (c == '}' && _state == st_key_or_end)
+            return endContainer(c);
+        if (c != '"')
+            return setError();
+        _inKey = true;
+        _keyLen = 0;
+        _key[0] = '\0';
+        _state = st_string;
+        return true;
+
+    case st_colon:
+        if (ws)
+            return true;
+        if (c != ':')
+            return setError();
+        _state = st_value;
+        return true;
+
+    case st_after_value:
+        if (ws)
+            return true;
+        if (c == ',')
+        {
+            if (_isArray[_depth - 1])
+            {
+                _index[_depth - 1]++;
+                _state = st_value;
+            }
+            else
+                _state = st_key;
+            return true;
+        }
+        return endContainer(c);
+
+    case st_string:
+        if (_hexCount > 0)
+        {
+            uint8_t v = 0;
+            if (c >= '0' && c <= '9')
+                v = c - '0';
+            else if (c >= 'a' && c <= 'f')
+                v = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                v = c - 'A' + 10;
+            else
+                return setError();
+
+            _hex = (_hex << 4) | v;
+            if (--_hexCount == 0)
+            {
+                if (_hex >= 0xD800 && _hex <= 0xDBFF)
+                    _highSurrogate = _hex;
+                else if (_hex >= 0xDC00 && _hex <= 0xDFFF && _highSurrogate > 0)
+                {
+                    appendUTF8(0x10000 + (((uint32_t)_highSurrogate - 0xD800) << 10) + (_hex - 0xDC00));
+                    _highSurrogate = 0;
+                }
+                else
+                    appendUTF8(_hex);
+            }
+            return true;
+        }
+
+        if (_escape)
+        {
+            _escape = false;
+            switch (c)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                appendToken(c);
+                break;
+            case 'b':
+                appendToken('\b');
+                break;
+            case 'f':
+                appendToken('\f');
+                break;
+            case 'n':
+                appendToken('\n');
+                break;
+            case 'r':
+                appendToken('\r');
+                break;
+            case 't':
+                appendToken('\t');
+                break;
+            case 'u':
+                _hexCount = 4;
+                _hex = 0;
+                break;
+            default:
+                return setError();
+            }
+            return true;
+        }
+
+        if (c == '\\')
+            _escape = true;
+        else if (c == '"')
+        {
+            _highSurrogate = 0;
+            if (_inKey)
+            {
+                _inKey = false;
+                _state = st_colon;
+            }
+            else
+            {
+                pushPath();
+                emit(fb_json_stream_event_value, FirebaseJson::JSON_STRING);
+                return afterValue();
+            }
+        }
+        else if ((uint8_t)c < 0x20)
+            return setError();
+        else
+            appendToken(c);
+        return true;
+
+    case st_number:
+        if (c >= '0' && c <= '9')
+        {
+            // no leading zero
+            if (_numState == num_zero)
+                return setError();
+            if (_numState == num_sign)
+                _numState = c == '0' ? num_zero : num_int;
+            else if (_numState == num_dot)
+                _numState = num_frac;
+            else if (_numState == num_exp || _numState == num_exp_sign)
+                _numState = num_exp_digits;
+        }
+        else if (c == '.' && (_numState == num_zero || _numState == num_int))
+            _numState = num_dot;
+        else if ((c == 'e' || c == 'E') && (_numState == num_zero || _numState == num_int || _numState == num_frac))
+            _numState = num_exp;
+        else if ((c == '+' || c == '-') && _numState == num_exp)
+            _numState = num_exp_sign;
+        else
+        {
+            // the digit is required after the sign, dot and exponent, the misplaced number character is not allowed
+            if (_numState == num_sign || _numState == num_dot || _numState == num_exp || _numState == num_exp_sign ||
+                c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+                return setError();
+            pushPath();
+            emit(fb_json_stream_event_value, numberType());
+            afterValue();
+            return process(c);
+        }
+        appendToken(c);
+        return true;
+
+    case st_literal:
+        if (c >= 'a' && c <= 'z')
+        {
+            appendToken(c);
+            return true;
+        }
+        else
+        {
+            int typeNum = FirebaseJson::JSON_UNDEFINED;
+            if (!literalType(typeNum))
+                return setError();
+            pushPath();
+            emit(fb_json_stream_event_value, typeNum);
+            afterValue();
+            return process(c);
+        }
+
+    case st_done:
+        if (ws)
+            return true;
+        return setError();
+
+    default:
+        break;
+    }
+
+    return setError();
+}
+
+bool FirebaseJsonStreamReader::beginValue(char c)
+{
+    if (c == '{' || c == '[')
+    {
+        if (_depth >= FIREBASEJSON_STREAM_MAX_DEPTH)
+            return setError();
+
+        bool isArray = c == '[';
+        pushPath();
+        _value[0] = '\0';
+        emit(isArray ? fb_json_stream_event_begin_array : fb_json_stream_event_begin_object, isArray ? FirebaseJson::JSON_ARRAY : FirebaseJson::JSON_OBJECT);
+        _isArray[_depth] = isArray;
+        _index[_depth] = 0;
+        _pathLen[_depth] = _curPathLen;
+        _depth++;
+        _state = isArray ? st_value_or_end : st_key_or_end;
+        return true;
+    }
+
+    _inKey = false;
+    _valueLen = 0;
+    _value[0] = '\0';
+
+    if (c == '"')
+        _state = st_string;
+    else if (c == '-' || (c >= '0' && c <= '9'))
+    {
+        appendToken(c);
+        _numState = c == '-' ? num_sign : (c == '0' ? num_zero : num_int);
+        _state = st_number;
+    }
+    else if (c == 't' || c == 'f' || c == 'n')
+    {
+        appendToken(c);
+        _state = st_literal;
+    }
+    else
+        return setError();
+
+    return true;
+}
+
+bool FirebaseJsonStreamReader::endContainer(char c)
+{
+    if (_depth == 0 || (c == ']') != _isArray[_depth - 1] || (c != ']' && c != '}'))
+        return setError();
+
+    bool isArray = _isArray[_depth - 1];
+    _depth--;
+    _curPathLen = _pathLen[_depth];
+    _path[_curPathLen] = '\0';
+    _value[0] = '\0';
+    emit(isArray ? fb_json_stream_event_end_array : fb_json_stream_event_end_object, isArray ? FirebaseJson::JSON_ARRAY : FirebaseJson::JSON_OBJECT);
+    return afterValue();
+}
+
+bool FirebaseJsonStreamReader::afterValue()
+{
+    _state = _depth == 0 ? st_done : st_after_value;
+    return true;
+}
+
+void FirebaseJsonStreamReader::appendToken(char c)
+{
+    char *buf = _inKey ? _key : _value;
+    size_t &len = _inKey ? _keyLen : _valueLen;
+    size_t size = _inKey ? FIREBASEJSON_STREAM_KEY_SIZE : FIREBASEJSON_STREAM_VALUE_SIZE;
+
+    if (len + 1 < size)
+    {
+        buf[len++] = c;
+        buf[len] = '\0';
+    }
+    else
+        _truncated = true;
+}
+
+void FirebaseJsonStreamReader::appendUTF8(uint32_t cp)
+{
+    if (cp < 0x80)
+        appendToken(cp);
+    else if (cp < 0x800)
+    {
+        appendToken(0xC0 | (cp >> 6));
+        appendToken(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000)
+    {
+        appendToken(0xE0 | (cp >> 12));
+        appendToken(0x80 | ((cp >> 6) & 0x3F));
+        appendToken(0x80 | (cp & 0x3F));
+    }
+    else
+    {
+        appendToken(0xF0 | (cp >> 18));
+        appendToken(0x80 | ((cp >> 12) & 0x3F));
+        appendToken(0x80 | ((cp >> 6) & 0x3F));
+        appendToken(0x80 | (cp & 0x3F));
+    }
+}
+
+void FirebaseJsonStreamReader::pushPath()
+{
+    _curPathLen = _depth > 0 ? _pathLen[_depth - 1] : 0;
+    _path[_curPathLen] = '\0';
+
+    if (_depth == 0)
+        return;
+
+    char num[12];
+    const char *seg = _key;
+    if (_isArray[_depth - 1])
+    {
+        snprintf(num, sizeof(num), "%d", _index[_depth - 1]);
+        seg = num;
+    }
+
+    if (_curPathLen > 0)
+    {
+        if (_curPathLen + 1 < FIREBASEJSON_STREAM_PATH_SIZE)
+            _path[_curPathLen++] = '/';
+        else
+            _truncated = true;
+    }
+
+    while (*seg)
+    {
+        if (_curPathLen + 1 < FIREBASEJSON_STREAM_PATH_SIZE)
+            _path[_curPathLen++] = *seg++;
+        else
+        {
+            _truncated = true;
+            break;
+        }
+    }
+
+    _path[_curPathLen] = '\0';
+}
+
+void FirebaseJsonStreamReader::emit(fb_json_stream_event_type event, int typeNum)
+{
+    if (!_callback)
+    {
+        _truncated = false;
+        return;
+    }
+
+    FirebaseJsonStreamEvent e;
+    bool inArray = _depth > 0 && _isArray[_depth - 1];
+    e.event = event;
+    e.typeNum = typeNum;
+    e.depth = _depth;
+    e.index = inArray ? _index[_depth - 1] : -1;
+    // The key of closing container was overwritten by its children keys, use path instead.
+    e.key = _depth > 0 && !inArray && event != fb_json_stream_event_end_object && event != fb_json_stream_event_end_array ? _key : "";
+    e.path = _path;
+    e.value = _value;
+    e.truncated = _truncated;
+    e.errorPos = _pos;
+    _truncated = false;
+    _callback(e);
+}
+
+int FirebaseJsonStreamReader::numberType()
+{
+    if (strpbrk(_value, ".eE") != NULL)
+    {
+        double d = atof(_value);
+        if (d > 0x7fffffff)
+            return FirebaseJson::JSON_DOUBLE;
+        return FirebaseJson::JSON_FLOAT;
+    }
+    return FirebaseJson::JSON_INT;
+}
+
+bool FirebaseJsonStreamReader::literalType(int &typeNum)
+{
+    if (strcmp(_value, (const char *)MBSTRING_FLASH_MCR("true")) == 0 || strcmp(_value, (const char *)MBSTRING_FLASH_MCR("false")) == 0)
+        typeNum = FirebaseJson::JSON_BOOL;
+    else if (strcmp(_value, (const char *)MBSTRING_FLASH_MCR("null")) == 0)
+        typeNum = FirebaseJson::JSON_NULL;
+    else
+        return false;
+    return true;
+}
+
+bool FirebaseJsonStreamReader::setError()
+{
+    if (!_error)
+    {
+        _error = true;
+        _value[0] = '\0';
+        emit(fb_json_stream_event_error, FirebaseJson::JSON_UNDEFINED);
+    }
+    return false;
+}
+
 #endif
\ No newline at end of file
@@ -203,6 +203,8 @@ static const char fb_json_str_9[] PROGMEM = "Location: ";
 class FirebaseJson;
 class FirebaseJsonArray;
 class FirebaseJsonData;
+class FirebaseJsonPath;
+class FirebaseJsonStreamReader;
 
 static size_t getReservedLen(size_t len)
 {
@@ -216,7 +218,126 @@ static size_t getReservedLen(size_t len)
     return (size_t)newlen;
 }
 
-static void *fb_js_malloc(size_t len)
+#if !defined(FIREBASEJSON_POOL_BLOCK_SIZE)
+#define FIREBASEJSON_POOL_BLOCK_SIZE 1024
+#endif
+
+// The maximum number of tasks that can use their pools at the same time, the others use the heap
+#if !defined(FIREBASEJSON_POOL_MAX_TASKS)
+#define FIREBASEJSON_POOL_MAX_TASKS 8
+#endif
+
+// The current pool is kept per task in the table on the FreeRTOS devices, per thread on the host
+// and in one pointer on the single task devices.
+#if defined(ESP32) || (defined(ARDUINO_ARCH_RP2040) && defined(INC_FREERTOS_H))
+#define FIREBASEJSON_POOL_TASK_TABLE
+#if !defined(ESP32)
+#include <task.h>
+#endif
+#elif !defined(ARDUINO)
+#define FIREBASEJSON_POOL_THREAD_LOCAL
+#endif
+
+#if defined(FIREBASEJSON_POOL_TASK_TABLE) || defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+#include <atomic>
+#endif
+
+class FirebaseJsonPool;
+
+// The header in front of every allocation made by the hooks, the pool is NULL for heap memory.
+// It costs FIREBASEJSON_ALLOC_HEADER bytes per element, key and value (8 bytes on the 32-bit devices,
+// 16 bytes on the 64-bit host) whether the pool allocator was used or not.
+struct fb_js_alloc_t
+{
+    FirebaseJsonPool *pool;
+    size_t len;
+};
+
+// The allocation header size that keeps the data 8 bytes aligned
+#define FIREBASEJSON_ALLOC_HEADER ((sizeof(fb_js_alloc_t) + 7) & ~(size_t)7)
+
+static inline fb_js_alloc_t *fb_js_alloc_header(const void *ptr)
+{
+    return reinterpret_cast<fb_js_alloc_t *>(const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(ptr)) - FIREBASEJSON_ALLOC_HEADER);
+}
+
+/**
+ * The block (arena) allocator for the elements of FirebaseJson and FirebaseJsonArray object.
+ *
+ * The nodes, keys and values are bump allocated from the memory blocks and never freed individually,
+ * all blocks are released at once when the pool was reset.
+ *
+ * The allocation hooks check the pool of the calling task only while any Scope is active, otherwise
+ * the elements are allocated from the heap without taking the lock.
+ */
+class FirebaseJsonPool
+{
+public:
+    FirebaseJsonPool(size_t blockSize = FIREBASEJSON_POOL_BLOCK_SIZE);
+    ~FirebaseJsonPool();
+
+    void *alloc(size_t len);
+    void *resize(void *ptr, size_t len);
+    bool owns(const void *ptr) const;
+    void reset();
+    size_t size() const;
+
+    // The pool that is currently used by the allocation hooks of the calling task or NULL for heap.
+    static FirebaseJsonPool *current();
+    // The pool that owns the pointer allocated by the hooks or NULL for heap pointer.
+    static FirebaseJsonPool *find(const void *ptr);
+
+    // Set the pool to be used by the allocation hooks of the calling task during the lifetime of this object.
+    class Scope
+    {
+    public:
+        Scope(FirebaseJsonPool *pool);
+        ~Scope();
+
+    private:
+        FirebaseJsonPool *prev = NULL;
+        FirebaseJsonPool *pool = NULL;
+    };
+
+private:
+    struct block_t
+    {
+        block_t *next;
+        size_t size;
+        size_t used;
+    };
+
+    block_t *blocks = NULL;
+    size_t blockSize = FIREBASEJSON_POOL_BLOCK_SIZE;
+
+    // Set the pool of the calling task and return the previous one.
+    static FirebaseJsonPool *setCurrent(FirebaseJsonPool *pool);
+    static void release(FirebaseJsonPool *pool);
+
+#if defined(FIREBASEJSON_POOL_TASK_TABLE) || defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+    // The number of active scopes of all tasks
+    static std::atomic<int> scopes;
+#endif
+
+#if defined(FIREBASEJSON_POOL_TASK_TABLE)
+    struct task_pool_t
+    {
+        void *task;
+        FirebaseJsonPool *pool;
+    };
+
+    static task_pool_t taskPools[FIREBASEJSON_POOL_MAX_TASKS];
+#if defined(ESP32)
+    static portMUX_TYPE taskPoolsMux;
+#endif
+#elif defined(FIREBASEJSON_POOL_THREAD_LOCAL)
+    static thread_local FirebaseJsonPool *active;
+#else
+    static FirebaseJsonPool *active;
+#endif
+};
+
+static void *fb_js_heap_malloc(size_t len)
 {
     void *p;
     size_t newLen = getReservedLen(len);
@@ -247,15 +368,40 @@ static void *fb_js_malloc(size_t len)
     return p;
 }
 
+static void *fb_js_malloc(size_t len)
+{
+    FirebaseJsonPool *pool = FirebaseJsonPool::current();
+    if (pool)
+        return pool->alloc(len);
+
+    uint8_t *p = reinterpret_cast<uint8_t *>(fb_js_heap_malloc(FIREBASEJSON_ALLOC_HEADER + len));
+    if (!p)
+        return NULL;
+
+    fb_js_alloc_t *hdr = reinterpret_cast<fb_js_alloc_t *>(p);
+    hdr->pool = NULL;
+    hdr->len = len;
+    return p + FIREBASEJSON_ALLOC_HEADER;
+}
+
 static void fb_js_free(void *ptr)
 {
-    if (ptr)
-        free(ptr);
+    // pool memory is released as a whole when the pool was reset
+    if (ptr && !fb_js_alloc_header(ptr)->pool)
+        free(fb_js_alloc_header(ptr));
 }
 
 static void *fb_js_realloc(void *ptr, size_t sz)
 {
-    size_t newLen = getReservedLen(sz);
+    if (!ptr)
+        return fb_js_malloc(sz);
+
+    FirebaseJsonPool *pool = fb_js_alloc_header(ptr)->pool;
+    if (pool)
+        return pool->resize(ptr, sz);
+
+    ptr = fb_js_alloc_header(ptr);
+    size_t newLen = getReservedLen(FIREBASEJSON_ALLOC_HEADER + sz);
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
     if (ESP.getPsramSize() > 0)
         ptr = (void *)ps_realloc(ptr, newLen);
@@ -277,7 +423,8 @@ static void *fb_js_realloc(void *ptr, size_t sz)
     if (!ptr)
         return NULL;
 
-    return ptr;
+    reinterpret_cast<fb_js_alloc_t *>(ptr)->len = sz;
+    return reinterpret_cast<uint8_t *>(ptr) + FIREBASEJSON_ALLOC_HEADER;
 }
 
 static MB_JSON_Hooks MB_JSON_hooks __attribute__((used)) = {fb_js_malloc, fb_js_free, fb_js_realloc};
@@ -552,6 +699,65 @@ private:
     }
 };
 
+#if !defined(FIREBASEJSON_INDEX_MIN_SIZE)
+#define FIREBASEJSON_INDEX_MIN_SIZE 16
+#endif
+
+#if !defined(FIREBASEJSON_INDEX_MAX_OBJECTS)
+#define FIREBASEJSON_INDEX_MAX_OBJECTS 8
+#endif
+
+/**
+ * The pre-tokenized relative path of element that can be reused for get and set of FirebaseJson object.
+ *
+ * The path is split into node names and array indexes once and no string parsing is required
+ * in every get and set call.
+ */
+class FirebaseJsonPath
+{
+    friend class FirebaseJsonBase;
+
+public:
+    FirebaseJsonPath(){};
+
+    /**
+     * @param path The relative path of element e.g. /myRoot/[2]/Sensor1/myData/[3].
+     */
+    explicit FirebaseJsonPath(const char *path) { setPath(path); }
+    explicit FirebaseJsonPath(const String &path) { setPath(path.c_str()); }
+    explicit FirebaseJsonPath(const MB_String &path) { setPath(path.c_str()); }
+    ~FirebaseJsonPath() { clear(); };
+
+    /**
+     * Set the relative path of element.
+     *
+     * @param path The relative path of element e.g. /myRoot/[2]/Sensor1/myData/[3].
+     */
+    void setPath(const char *path);
+
+    /**
+     * Get the number of node names and array indexes in this path.
+     *
+     * @return number of path elements.
+     */
+    size_t size() const { return keys.size(); }
+
+    /**
+     * Get the relative path string.
+     *
+     * @return the path string.
+     */
+    const char *c_str() const { return path.c_str(); }
+
+    void clear();
+
+private:
+    MB_String path;
+    MB_VECTOR<MB_String> keys;
+    // the array index of each path element or -1 for node name
+    MB_VECTOR<int> indexes;
+};
+
 class FirebaseJsonBase
 {
     friend class FirebaseJson;
@@ -582,6 +788,13 @@ private:
         int stopIndex = 0;
     };
 
+    struct index_table_t
+    {
+        MB_JSON *parent = NULL;
+        MB_JSON **slots = NULL;
+        size_t mask = 0;
+    };
+
     struct iterator_result_t
     {
         uint16_t ofs1 = 0;
@@ -617,18 +830,21 @@ private:
     bool setRaw(const char *raw);
     void prepareRoot();
     MB_JSON *parse(const char *raw);
-    void searchElements(MB_VECTOR<MB_String> &keys, MB_JSON *parent, struct search_result_t &r);
-    MB_JSON *getElement(MB_JSON *parent, const char *key, struct search_result_t &r);
-    void mAdd(MB_VECTOR<MB_String> keys, MB_JSON **parent, int beginIndex, MB_JSON *value);
+    void searchElements(const FirebaseJsonPath &path, MB_JSON *parent, struct search_result_t &r, bool useIndex = false);
+    MB_JSON *getElement(MB_JSON *parent, const char *key, int index, struct search_result_t &r, bool useIndex);
+    MB_JSON *getObjectItem(MB_JSON *parent, const char *key, bool useIndex);
+    void mClearIndex();
+    void mSetIndex(bool enable, size_t minSize);
+    void mAdd(const MB_VECTOR<MB_String> &keys, MB_JSON **parent, int beginIndex, MB_JSON *value);
     void makeList(const MB_String &str, MB_VECTOR<MB_String> &keys, char delim);
     void pushLish(const MB_String &str, MB_VECTOR<MB_String> &keys);
     void clearList(MB_VECTOR<MB_String> &keys);
     bool isArray(MB_JSON *e);
     bool isObject(MB_JSON *e);
     MB_JSON *addArray(MB_JSON *parent, MB_JSON *e, size_t size);
-    void appendArray(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value);
-    void replaceItem(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value);
-    void replace(MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item);
+    void appendArray(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value);
+    void replaceItem(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *value);
+    void replace(const MB_VECTOR<MB_String> &keys, struct search_result_t &r, MB_JSON *parent, MB_JSON *item);
     size_t mIteratorBegin(MB_JSON *parent);
     size_t mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys);
     void mCollectIterator(MB_JSON *e, int type, int &arrIndex);
@@ -649,11 +865,16 @@ private:
     void mSetDoubleDigits(uint8_t digits);
     int mResponseCode();
     bool mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify = false);
+    bool mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify = false);
     void mSetResInt(FirebaseJsonData *data, const char *value);
     void mSetResFloat(FirebaseJsonData *data, const char *value);
     void mSetElementType(FirebaseJsonData *result);
     void mSet(const char *path, MB_JSON *value);
+    void mSet(const FirebaseJsonPath &path, MB_JSON *value);
     void mCopy(FirebaseJsonBase &other);
+    void mDeleteRoot();
+    void mSetPool(bool enable, size_t blockSize);
+    MB_JSON *adopt(MB_JSON *value);
 #if defined(__AVR__)
     unsigned long long strtoull_alt(const char *s);
 #endif
@@ -702,6 +923,10 @@ protected:
     struct iterator_data_t iterator_data;
     MB_JSON *root = NULL;
     MB_JSON_Hooks *hooks = NULL;
+    FirebaseJsonPool *pool = NULL;
+    bool index_enabled = false;
+    size_t index_min_size = FIREBASEJSON_INDEX_MIN_SIZE;
+    MB_VECTOR<index_table_t> index_tables;
     MB_String buf;
 
     template <typename T>
@@ -2001,6 +2226,22 @@ public:
      */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Set the block (arena) allocator for the elements of this JSON Array object.
+     *
+     * @param enable The boolean option to allocate the elements from the memory blocks of this object.
+     * @param blockSize The size in bytes of each memory block.
+     * @return instance of an object.
+     *
+     * @note All elements are released at once when cleared, the memory of removed or replaced elements
+     * is reused only after clear. The existing elements are moved to the new allocator.
+     */
+    FirebaseJsonArray &setPoolAllocator(bool enable, size_t blockSize = FIREBASEJSON_POOL_BLOCK_SIZE)
+    {
+        mSetPool(enable, blockSize);
+        return *this;
+    }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -2286,6 +2527,7 @@ class FirebaseJson : public FirebaseJsonBase
 public:
     typedef enum FirebaseJsonBase::fb_js_json_data_type jsonDataType;
     typedef struct FirebaseJsonBase::fb_js_iterator_value_t IteratorValue;
+    typedef FirebaseJsonPath Path;
 
     FirebaseJson() { this->root_type = Root_Type_JSON; }
 
@@ -2486,6 +2728,27 @@ public:
         return ret;
     }
 
+    /**
+     * Get the value from the specified pre-tokenized path.
+     *
+     * @param result FirebaseJsonData object that holds the result of the operation.
+     * @param path The FirebaseJson::Path object of the element.
+     * @param prettify The text indentation and new line serialization option.
+     * @return boolean status of the operation.
+     *
+     * @note The path object can be created once and reused e.g.
+     * FirebaseJson::Path temp("sensors/[0]/temp");
+     */
+    bool get(FirebaseJsonData &result, const Path &path, bool prettify = false) { return mGet(root, &result, path, prettify); }
+
+    /**
+     * Check whether the pre-tokenized path to the child element existed in FirebaseJson object or not.
+     *
+     * @param path The FirebaseJson::Path object of the element.
+     * @return boolean status indicated the existence of element.
+     */
+    bool isMember(const Path &path) { return mGet(root, NULL, path); }
+
     /**
      * Parse and collect all node/array elements in FirebaseJson object.
      *
@@ -2580,6 +2843,32 @@ public:
         return *this;
     }
 
+    /**
+     * Set the value at the specified pre-tokenized path.
+     *
+     * @param path The FirebaseJson::Path object of the element.
+     * @param value The value to set.
+     * @return instance of an object.
+     */
+    template <typename T>
+    FirebaseJson &set(const Path &path, T value)
+    {
+        pathSetHandler(path, toElement(value));
+        return *this;
+    }
+
+    FirebaseJson &set(const Path &path, FirebaseJson &value)
+    {
+        pathSetHandler(path, MB_JSON_Duplicate(value.root, true));
+        return *this;
+    }
+
+    FirebaseJson &set(const Path &path, FirebaseJsonArray &value)
+    {
+        pathSetHandler(path, MB_JSON_Duplicate(value.root, true));
+        return *this;
+    }
+
     /**
      * Remove the specified node and its content.
      *
@@ -2626,6 +2915,38 @@ public:
      */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Set the block (arena) allocator for the elements of this JSON object.
+     *
+     * @param enable The boolean option to allocate the elements from the memory blocks of this object.
+     * @param blockSize The size in bytes of each memory block.
+     * @return instance of an object.
+     *
+     * @note All elements are released at once when cleared, the memory of removed or replaced elements
+     * is reused only after clear. The existing elements are moved to the new allocator.
+     */
+    FirebaseJson &setPoolAllocator(bool enable, size_t blockSize = FIREBASEJSON_POOL_BLOCK_SIZE)
+    {
+        mSetPool(enable, blockSize);
+        return *this;
+    }
+
+    /**
+     * Set the hash index for key lookup of the large objects in this JSON object.
+     *
+     * @param enable The boolean option to enable the hash index.
+     * @param minSize The minimum number of children of object to be indexed.
+     * @return instance of an object.
+     *
+     * @note The index of each object is built lazily on the first get or isMember call that
+     * looks up its children and all indexes are dropped when this JSON object was modified.
+     */
+    FirebaseJson &setIndexEnabled(bool enable, size_t minSize = FIREBASEJSON_INDEX_MIN_SIZE)
+    {
+        mSetIndex(enable, minSize);
+        return *this;
+    }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -2758,6 +3079,49 @@ private:
         return *this;
     }
 
+    void pathSetHandler(const Path &path, MB_JSON *value)
+    {
+        if (root_type != Root_Type_JSON)
+            mClear();
+
+        root_type = Root_Type_JSON;
+
+        mSet(path, value);
+    }
+
+    template <typename T>
+    auto toElement(T value) -> typename std::enable_if<is_bool<T>::value, MB_JSON *>::type
+    {
+        return MB_JSON_CreateBool(value);
+    }
+
+    template <typename T>
+    auto toElement(T value) -> typename std::enable_if<is_num_int<T>::value, MB_JSON *>::type
+    {
+        return MB_JSON_CreateRaw(num2Str(value, -1));
+    }
+
+    template <typename T>
+    auto toElement(T value) -> typename std::enable_if<std::is_same<T, float>::value, MB_JSON *>::type
+    {
+        return MB_JSON_CreateRaw(num2Str(value, floatDigits));
+    }
+
+    template <typename T>
+    auto toElement(T value) -> typename std::enable_if<std::is_same<T, double>::value || std::is_same<T, long double>::value, MB_JSON *>::type
+    {
+        return MB_JSON_CreateRaw(num2Str(value, doubleDigits));
+    }
+
+    template <typename T>
+    auto toElement(T value) -> typename std::enable_if<is_string<T>::value, MB_JSON *>::type
+    {
+        uint32_t addr = 0;
+        MB_JSON *e = MB_JSON_CreateString(getStr(value, addr));
+        delAddr(addr);
+        return e;
+    }
+
     void delAddr(uint32_t addr)
     {
         if (addr > 0)
@@ -2769,4 +3133,187 @@ private:
     }
 };
 
+#if !defined(FIREBASEJSON_STREAM_MAX_DEPTH)
+#define FIREBASEJSON_STREAM_MAX_DEPTH 16
+#endif
+
+#if !defined(FIREBASEJSON_STREAM_KEY_SIZE)
+#define FIREBASEJSON_STREAM_KEY_SIZE 64
+#endif
+
+#if !defined(FIREBASEJSON_STREAM_VALUE_SIZE)
+#define FIREBASEJSON_STREAM_VALUE_SIZE 256
+#endif
+
+#if !defined(FIREBASEJSON_STREAM_PATH_SIZE)
+#define FIREBASEJSON_STREAM_PATH_SIZE 256
+#endif
+
+typedef enum
+{
+    fb_json_stream_event_begin_object,
+    fb_json_stream_event_end_object,
+    fb_json_stream_event_begin_array,
+    fb_json_stream_event_end_array,
+    fb_json_stream_event_value,
+    fb_json_stream_event_error
+} fb_json_stream_event_type;
+
+struct FirebaseJsonStreamEvent
+{
+    // The event type.
+    fb_json_stream_event_type event = fb_json_stream_event_value;
+    // The data type of element (FirebaseJson::JSON_OBJECT, FirebaseJson::JSON_INT etc.).
+    int typeNum = FirebaseJson::JSON_UNDEFINED;
+    // The nesting level of element, the root element is at depth 0.
+    int depth = 0;
+    // The array index of element or -1 if the parent is not array.
+    int index = -1;
+    // The key of element or empty string if the parent is not object.
+    const char *key = "";
+    // The full path of element i.e. "a/b/0/c".
+    const char *path = "";
+    // The scalar value, the string is unescaped, number, bool and null are in their literal form.
+    const char *value = "";
+    // The key, path or value exceeded its fixed size buffer and was truncated.
+    bool truncated = false;
+    // The position of the character that caused the error.
+    size_t errorPos = 0;
+};
+
+typedef void (*FirebaseJsonStreamCallback)(FirebaseJsonStreamEvent &);
+
+/**
+ * The incremental (SAX-style) JSON reader.
+ *
+ * Feed the JSON text in chunks of any size and the callback is called for every
+ * object/array boundary and scalar value as soon as it was completely read.
+ * The reader keeps no document tree, it uses fixed size buffers for key, value,
+ * path and nesting stack (see FIREBASEJSON_STREAM_XXX macros) then the memory usage
+ * is constant regardless of payload size.
+ */
+class FirebaseJsonStreamReader
+{
+public:
+    FirebaseJsonStreamReader(){};
+    FirebaseJsonStreamReader(FirebaseJsonStreamCallback callback) { begin(callback); };
+    ~FirebaseJsonStreamReader(){};
+
+    /**
+     * Reset the reader and assign the callback function.
+     *
+     * @param callback The FirebaseJsonStreamCallback function that accepts FirebaseJsonStreamEvent.
+     */
+    void begin(FirebaseJsonStreamCallback callback);
+
+    /**
+     * Feed the chunk of JSON text to the reader.
+     *
+     * @param data The chunk data.
+     * @param len The length of chunk data.
+     * @return bool status of parsing, false when syntax error was found.
+     *
+     * @note The chunk does not need to end at token boundary.
+     */
+    bool feed(const char *data, size_t len);
+
+    /**
+     * Feed the null terminated chunk of JSON text to the reader.
+     *
+     * @param data The chunk string.
+     * @return bool status of parsing, false when syntax error was found.
+     */
+    bool feed(const char *data) { return data ? feed(data, strlen(data)) : !_error; }
+
+    /**
+     * Signal the end of JSON text.
+     *
+     * @return bool status of the complete JSON text parsing.
+     *
+     * @note The pending root number/literal value will be emitted.
+     */
+    bool end();
+
+    /**
+     * Reset the reader state without changing the callback.
+     */
+    void reset();
+
+    /**
+     * Get the parsing error status.
+     *
+     * @return bool error status.
+     */
+    bool hasError() { return _error; }
+
+    /**
+     * Check whether the root value was completely read.
+     *
+     * @return bool status.
+     */
+    bool completed() { return _state == st_done; }
+
+private:
+    enum reader_state_t
+    {
+        st_value,
+        st_value_or_end,
+        st_key,
+        st_key_or_end,
+        st_colon,
+        st_after_value,
+        st_string,
+        st_number,
+        st_literal,
+        st_done
+    };
+
+    // The position in number grammar, the number can end only after the digit
+    enum number_state_t
+    {
+        num_sign,
+        num_zero,
+        num_int,
+        num_dot,
+        num_frac,
+        num_exp,
+        num_exp_sign,
+        num_exp_digits
+    };
+
+    FirebaseJsonStreamCallback _callback = NULL;
+    reader_state_t _state = st_value;
+    number_state_t _numState = num_int;
+    bool _error = false;
+    bool _inKey = false;
+    bool _escape = false;
+    bool _truncated = false;
+    uint8_t _hexCount = 0;
+    uint16_t _hex = 0;
+    uint16_t _highSurrogate = 0;
+    size_t _pos = 0;
+    int _depth = 0;
+    bool _isArray[FIREBASEJSON_STREAM_MAX_DEPTH + 1];
+    int _index[FIREBASEJSON_STREAM_MAX_DEPTH + 1];
+    uint16_t _pathLen[FIREBASEJSON_STREAM_MAX_DEPTH + 1];
+    char _key[FIREBASEJSON_STREAM_KEY_SIZE];
+    char _value[FIREBASEJSON_STREAM_VALUE_SIZE];
+    char _path[FIREBASEJSON_STREAM_PATH_SIZE];
+    size_t _keyLen = 0;
+    size_t _valueLen = 0;
+    size_t _curPathLen = 0;
+
+    bool process(char c);
+    bool beginValue(char c);
+    bool endContainer(char c);
+    bool afterValue();
+    void appendToken(char c);
+    void appendUTF8(uint32_t cp);
+    void pushPath();
+    void emit(fb_json_stream_event_type event, int typeNum);
+    int numberType();
+    bool literalType(int &typeNum);
+    bool setError();
+};
+
 #endif
\ No newline at end of file
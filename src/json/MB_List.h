@@ -1,5 +1,5 @@
 /*
- * Just a simple dynamic array implementation, MB_List v1.0.4
+ * Just a simple dynamic array implementation, MB_List v1.0.5
  *
  * Created November 1, 2022
  *
@@ -66,9 +66,18 @@ public:
 
     void pop_back()
     {
-        current--;
-        if (current < 0)
-            current = 0;
+        if (current > 0)
+        {
+            current--;
+            // release the resources held by the removed item
+            arr[current] = T();
+        }
+    }
+
+    void reserve(int size)
+    {
+        if (size > capacity)
+            relocate(size);
     }
 
     void erase(int beginIndex, int endIndex)
@@ -103,9 +112,10 @@ public:
             delete[] arr;
         arr = NULL;
         current = 0;
+        capacity = 0;
     }
 
-    size_t size()
+    size_t size() const
     {
         return current;
     }
@@ -117,20 +127,24 @@ public:
         return arr[0];
     }
 
+    const T &operator[](int index) const
+    {
+        if (index < current && index >= 0)
+            return arr[index];
+        return arr[0];
+    }
+
     void swap(MB_List &item)
     {
-        MB_List temp;
-        temp.arr = this->arr;
-        temp.current = this->current;
-        temp.capacity = this->capacity;
-        clear();
+        T *arr = this->arr;
+        int current = this->current;
+        int capacity = this->capacity;
         this->arr = item.arr;
         this->current = item.current;
         this->capacity = item.capacity;
-        item.clear();
-        item.arr = temp.arr;
-        item.current = temp.current;
-        item.capacity = temp.capacity;
+        item.arr = arr;
+        item.current = current;
+        item.capacity = capacity;
     }
 
 private:
@@ -138,105 +152,70 @@ private:
     int current = 0;
     int capacity = 0;
 
+    // Move the items to the new storage with the given capacity.
+    bool relocate(int size)
+    {
+        T *temp = new T[size];
+
+        if (!temp)
+            return false;
+
+        for (int i = 0; i < current; i++)
+            temp[i] = static_cast<T &&>(arr[i]);
+
+        if (arr)
+            delete[] arr;
+
+        arr = temp;
+        capacity = size;
+        return true;
+    }
+
     void add(T *data, int index, int size)
     {
 
-        if (index > current)
+        if (index > current || index < 0 || size <= 0)
             return;
 
-        if (current == 0)
-        {
-            arr = new T[1];
-            if (arr)
-            {
-                current = 1;
-                arr[0] = *data;
-                capacity = 1;
-            }
-        }
-        else
+        // data may refer to an item in this list
+        T item = *data;
+
+        if (current + size > capacity)
         {
-            if (current + size >= capacity)
-            {
-                T *temp = new T[current];
-
-                if (temp)
-                {
-                    for (int i = 0; i < current; i++)
-                        temp[i] = arr[i];
-
-                    delete[] arr;
-                    arr = NULL;
-
-                    capacity = current + size;
-                    capacity *= 2;
-
-                    arr = new T[capacity];
-                    if (arr)
-                    {
-                        for (int i = 0; i < index; i++)
-                            arr[i] = temp[i];
-
-                        for (int i = index; i < index + size; i++)
-                            arr[i] = *data;
-
-                        for (int i = index; i < current; i++)
-                            arr[i + size] = temp[i];
-
-                        current += size;
-                    }
-
-                    delete[] temp;
-                    temp = NULL;
-                }
-            }
-            else
-            {
-                for (int i = index; i < index + size; i++)
-                    arr[i] = *data;
-                current += size;
-            }
+            int newCapacity = capacity > 0 ? capacity * 2 : 4;
+            while (newCapacity < current + size)
+                newCapacity *= 2;
+
+            if (!relocate(newCapacity))
+                return;
         }
+
+        for (int i = current - 1; i >= index; i--)
+            arr[i + size] = static_cast<T &&>(arr[i]);
+
+        for (int i = index; i < index + size; i++)
+            arr[i] = item;
+
+        current += size;
     }
 
     void remove(int index, int size)
     {
 
-        if (current == 0 || index < 0)
+        if (current == 0 || index < 0 || index >= current)
             return;
 
         if (index + size > current)
             size = current - index;
 
-        T *temp = new T[current];
+        for (int i = index; i < current - size; i++)
+            arr[i] = static_cast<T &&>(arr[i + size]);
 
-        if (temp)
-        {
-
-            for (int i = 0; i < current; i++)
-                temp[i] = arr[i];
-
-            delete[] arr;
-            arr = NULL;
-
-            capacity = current - size;
-            capacity *= 2;
+        // release the resources held by the removed items
+        for (int i = current - size; i < current; i++)
+            arr[i] = T();
 
-            arr = new T[capacity];
-            if (arr)
-            {
-                for (int i = 0; i < index; i++)
-                    arr[i] = temp[i];
-
-                for (int i = index; i < current - size; i++)
-                    arr[i] = temp[i + size];
-
-                current -= size;
-            }
-
-            delete[] temp;
-            temp = NULL;
-        }
+        current -= size;
     }
 };
 
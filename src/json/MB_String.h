@@ -1,11 +1,14 @@
 
 /**
- * Mobizt's SRAM/PSRAM supported String, version 1.2.12
+ * Mobizt's SRAM/PSRAM supported String, version 1.2.13
  *
  * Created March 25, 2024
  *
  * Changes Log
  *
+ * v1.2.13
+ * - geometric buffer growth, cached string length and inline (small string) buffer
+ *
  * v1.2.12
  * - using std namespace
  * 
@@ -103,6 +106,16 @@
 #define ESP8266_USE_EXTERNAL_HEAP
 #endif
 
+// The inline buffer size (including the null terminator) for short strings that
+// are kept inside the object instead of the heap, 0 to disable.
+#if !defined(MB_STRING_SSO_SIZE)
+#if defined(__AVR__) || defined(ESP8266_USE_EXTERNAL_HEAP)
+#define MB_STRING_SSO_SIZE 0
+#else
+#define MB_STRING_SSO_SIZE 16
+#endif
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #define MBSTRING_FLASH_MCR FPSTR
 #elif defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
@@ -756,13 +769,17 @@ public:
 
     MB_String &operator+=(const char *cstr)
     {
+        if (!cstr)
+            return (*this);
+
         size_t len = strlen_P(cstr);
         size_t slen = length();
 
         if (_reserve(slen + len, false))
         {
-            strcat_P(buf, (PGM_P)cstr);
+            memcpy_P(buf + slen, (PGM_P)cstr, len);
             *(buf + slen + len) = '\0';
+            strLen = slen + len;
         }
 
         return (*this);
@@ -827,14 +844,16 @@ public:
         if (clear)
             this->clear();
 
-        int len = strlen_P((PGM_P)pstr);
+        size_t len = strlen_P((PGM_P)pstr);
         if (len > 0)
         {
-            unsigned int newlen = length() + len;
-            reserve(newlen);
+            size_t slen = length();
 
-            if (bufLen > 0)
-                memcpy_P(buf + length(), (PGM_P)pstr, len + 1);
+            if (_reserve(slen + len, false))
+            {
+                memcpy_P(buf + slen, (PGM_P)pstr, len + 1);
+                strLen = slen + len;
+            }
         }
 
         return (*this);
@@ -896,32 +915,31 @@ public:
     template <typename T = int>
     auto appendNum(T value, int precision = 0) -> typename std::enable_if<is_num_int<T>::value || is_bool<T>::value, MB_String &>::type
     {
+        // the number is formatted on the stack, the longest 64-bit integer is 20 digits and sign
+        char num[24];
         char *s = NULL;
 
         if (is_bool<T>::value)
-            s = boolStr(value);
+            s = boolStr(num, value);
         else if (is_num_neg_int<T>::value)
         {
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
-            s = int32Str(value);
+            s = int32Str(num, value);
 #else
-            s = int64Str(value);
+            s = int64Str(num, value);
 #endif
         }
         else if (is_num_pos_int<T>::value)
         {
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
-            s = uint32Str(value);
+            s = uint32Str(num, value);
 #else
-            s = uint64Str(value);
+            s = uint64Str(num, value);
 #endif
         }
 
         if (s)
-        {
             *this += s;
-            delP(&s);
-        }
 
         return (*this);
     }
@@ -985,6 +1003,7 @@ public:
         {
             *(buf) = c;
             *(buf + 1) = '\0';
+            strLen = 1;
         }
 
         return *this;
@@ -1017,6 +1036,7 @@ public:
         {
             memmove(buf, buf + p1, p2 - p1 + 1);
             buf[p2 - p1 + 1] = '\0';
+            strLen = p2 - p1 + 1;
             _reserve(p2 - p1 + 1, true);
         }
     }
@@ -1028,13 +1048,16 @@ public:
 
         size_t slen = length();
 
-        if (n > strlen(cstr))
-            n = strlen(cstr);
+        // stop at the terminator without scanning past n bytes
+        const char *end = (const char *)memchr(cstr, '\0', n);
+        if (end)
+            n = end - cstr;
 
         if (_reserve(slen + n, false))
         {
             memmove(buf + slen, cstr, n);
             *(buf + slen + n) = '\0';
+            strLen = slen + n;
         }
     }
 
@@ -1047,6 +1070,7 @@ public:
             for (size_t i = 0; i < n; i++)
                 *(buf + slen + i) = c;
             *(buf + slen + n) = '\0';
+            strLen = slen + n;
         }
     }
 
@@ -1055,12 +1079,13 @@ public:
         size_t slen = length();
         size_t len = 1;
 
-        if (maxLength() < slen + len)
-            _reserve(slen + len, false);
+        if (maxLength() < slen + len && !_reserve(slen + len, false))
+            return;
 
         memmove(buf + len, buf, slen);
         buf[0] = c;
         buf[len + slen] = '\0';
+        strLen = len + slen;
     }
 
     void prepend(const char *cstr)
@@ -1068,12 +1093,13 @@ public:
         size_t slen = length();
         size_t len = strlen(cstr);
 
-        if (maxLength() < slen + len)
-            _reserve(slen + len, false);
+        if (maxLength() < slen + len && !_reserve(slen + len, false))
+            return;
 
         memmove(buf + len, buf, slen);
         memmove(buf, cstr, len);
         buf[len + slen] = '\0';
+        strLen = len + slen;
     }
 
     const char *c_str() const
@@ -1098,12 +1124,21 @@ public:
             c = '\0';
             return c;
         }
+        // the caller may write through the reference, the length is re-evaluated later
+        strLen = npos;
         return buf[index];
     }
 
     void swap(MB_String &rhs)
     {
-        rhs.clear();
+        if (this == &rhs)
+            return;
+
+        // the heap buffers are exchanged, the inline buffers are copied by move()
+        MB_String temp;
+        temp.move(rhs);
+        rhs.move(*this);
+        move(temp);
     }
 
     void shrink_to_fit()
@@ -1118,7 +1153,10 @@ public:
         {
             size_t slen = length();
             if (slen > 0)
+            {
                 buf[slen - 1] = '\0';
+                strLen = slen - 1;
+            }
             _reserve(slen, true);
         }
     }
@@ -1174,6 +1212,7 @@ public:
         memmove(buf + index, buf + index + len, rightLen);
 
         buf[index + rightLen] = '\0';
+        strLen = index + rightLen;
 
         _reserve(length(), true);
     }
@@ -1182,7 +1221,9 @@ public:
     {
         if (!buf)
             return 0;
-        return strlen(buf);
+        if (strLen == npos)
+            strLen = strlen(buf);
+        return strLen;
     }
 
     MB_String substr(size_t offset, size_t len = npos) const
@@ -1228,13 +1269,18 @@ public:
             bufLen = len;
             memset(buf, 0, len);
         }
+        strLen = 0;
     }
 #endif
 
     void resize(size_t len)
     {
         if (_reserve(len, true))
+        {
+            if (length() > len)
+                strLen = len;
             buf[len] = '\0';
+        }
     }
 
     MB_String &replace(size_t pos, size_t len, const char *replace)
@@ -1253,8 +1299,12 @@ public:
                 if (maxLength() < length() + repLen - len)
                     _reserve(length() + repLen - len, false);
 
+                if (maxLength() < length() + repLen - len)
+                    return *this;
+
                 memmove(buf + pos + repLen, buf + pos + len, rightLen);
                 buf[pos + repLen + rightLen] = '\0';
+                strLen = pos + repLen + rightLen;
             }
 
             memmove(buf + pos, replace, repLen);
@@ -1285,6 +1335,7 @@ public:
                 *(buf + pos + i) = c;
 
             buf[pos + n + rightLen] = '\0';
+            strLen = pos + n + rightLen;
         }
 
         return *this;
@@ -1299,12 +1350,13 @@ public:
 
             size_t rightLen = length() - pos;
 
-            if (maxLength() < length() + insLen)
-                _reserve(length() + insLen, false);
+            if (maxLength() < length() + insLen && !_reserve(length() + insLen, false))
+                return *this;
 
             memmove(buf + pos + insLen, buf + pos, rightLen);
             buf[pos + insLen + rightLen] = '\0';
             memmove(buf + pos, cstr, insLen);
+            strLen = pos + insLen + rightLen;
         }
 
         return *this;
@@ -1451,6 +1503,7 @@ public:
             }
 
             buf[i] = '\0';
+            strLen = i;
         }
 
         temp.clear();
@@ -1470,8 +1523,17 @@ public:
 
     void reserve(size_t len)
     {
-        if (_reserve(len, false))
+        // exact size, the caller knows how much it needs
+        size_t newlen = getReservedLen(len);
+        if (newlen > bufLen)
+            allocate(newlen, false);
+
+        if (newlen <= bufLen)
+        {
             buf[len] = '\0';
+            // the buffer can be written directly after reserve
+            strLen = npos;
+        }
     }
 
     static const size_t npos = -1;
@@ -1479,39 +1541,34 @@ public:
 private:
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
 
-    char *int32Str(signed long value)
+    char *int32Str(char *t, signed long value)
     {
-        char *t = (char *)newP(64);
         sprintf(t, (const char *)MBSTRING_FLASH_MCR("%ld"), value);
         return t;
     }
 
-    char *uint32Str(unsigned long value)
+    char *uint32Str(char *t, unsigned long value)
     {
-        char *t = (char *)newP(64);
         sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lu"), value);
         return t;
     }
 
 #endif
 
-    char *int64Str(signed long long value)
+    char *int64Str(char *t, signed long long value)
     {
-        char *t = (char *)newP(64);
         sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lld"), value);
         return t;
     }
 
-    char *uint64Str(unsigned long long value)
+    char *uint64Str(char *t, unsigned long long value)
     {
-        char *t = (char *)newP(64);
         sprintf(t, (const char *)MBSTRING_FLASH_MCR("%llu"), value);
         return t;
     }
 
-    char *boolStr(bool value)
+    char *boolStr(char *t, bool value)
     {
-        char *t = (char *)newP(8);
         value ? strcpy(t, (const char *)MBSTRING_FLASH_MCR("true")) : strcpy(t, (const char *)MBSTRING_FLASH_MCR("false"));
         return t;
     }
@@ -1657,6 +1714,7 @@ private:
 
             memmove(buf + slen, buf, slen);
             buf[2 * slen] = '\0';
+            strLen = 2 * slen;
         }
         else
         {
@@ -1679,6 +1737,7 @@ private:
 
         memmove(buf + slen, cstr, len);
         buf[slen + len] = '\0';
+        strLen = slen + len;
     }
 
     void concat(const char *cstr)
@@ -1691,23 +1750,30 @@ private:
 
     void move(MB_String &rhs)
     {
-        if (buf)
+        // the inline buffer can't be taken over, copy it instead
+        if (rhs.isInline() || (buf && bufLen >= rhs.bufLen))
         {
-            if (bufLen >= rhs.bufLen)
-            {
-                strcpy(buf, rhs.buf);
-                bufLen = rhs.bufLen;
-                rhs.bufLen = 0;
-                return;
-            }
-            else
-            {
-                free(buf);
-            }
+            copy(rhs.c_str(), rhs.length());
+            rhs.clear();
+            return;
         }
+
+        allocate(0, false);
         buf = rhs.buf;
         bufLen = rhs.bufLen;
+        strLen = rhs.strLen;
         rhs.buf = NULL;
+        rhs.bufLen = 0;
+        rhs.strLen = 0;
+    }
+
+    bool isInline() const
+    {
+#if MB_STRING_SSO_SIZE > 0
+        return buf == sso;
+#else
+        return false;
+#endif
     }
 
     void allocate(size_t len, bool shrink)
@@ -1715,53 +1781,71 @@ private:
 
         if (len == 0)
         {
-            if (buf)
+            if (buf && !isInline())
                 free(buf);
             buf = NULL;
             bufLen = 0;
+            strLen = 0;
             return;
         }
 
+#if MB_STRING_SSO_SIZE > 0
+        if (len <= MB_STRING_SSO_SIZE)
+        {
+            if (!buf)
+            {
+                sso[0] = '\0';
+                buf = sso;
+                bufLen = MB_STRING_SSO_SIZE;
+                strLen = 0;
+            }
+            else if (shrink && !isInline())
+            {
+                // move back to the inline buffer
+                size_t slen = length();
+                if (slen > len - 1)
+                    slen = len - 1;
+                memcpy(sso, buf, slen);
+                sso[slen] = '\0';
+                free(buf);
+                buf = sso;
+                bufLen = MB_STRING_SSO_SIZE;
+                strLen = slen;
+            }
+            return;
+        }
+#endif
+
         if (len > bufLen || shrink)
         {
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
             ESP.setExternalHeap();
 #endif
+            // Keep the old buffer when allocation failed.
+            bool heap = buf && !isInline();
+            size_t slen = length();
+            if (slen > len - 1)
+                slen = len - 1;
 
-            if (shrink || (bufLen > 0 && buf))
-            {
-                int slen = length();
+            char *p = NULL;
 
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_realloc(buf, len);
-                else
-                    buf = (char *)realloc(buf, len);
-#else
-                buf = (char *)realloc(buf, len);
-#endif
-                if (buf)
-                {
-                    buf[slen] = '\0';
-                    bufLen = len;
-                }
-            }
+            if (ESP.getPsramSize() > 0)
+                p = heap ? (char *)ps_realloc(buf, len) : (char *)ps_malloc(len);
             else
-            {
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_malloc(len);
-                else
-                    buf = (char *)malloc(len);
+                p = heap ? (char *)realloc(buf, len) : (char *)malloc(len);
 #else
-                buf = (char *)malloc(len);
+            p = heap ? (char *)realloc(buf, len) : (char *)malloc(len);
 #endif
-                if (buf)
-                {
-                    buf[0] = '\0';
-                    bufLen = len;
-                }
+            if (p)
+            {
+                if (buf && !heap)
+                    memcpy(p, buf, slen);
+                p[slen] = '\0';
+                buf = p;
+                bufLen = len;
+                strLen = slen;
             }
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
@@ -1781,6 +1865,7 @@ private:
 
         memcpy_P(buf, (PGM_P)cstr, length);
         buf[length] = '\0';
+        strLen = length;
 
         return *this;
     }
@@ -1792,7 +1877,15 @@ private:
         if (shrink)
             allocate(newlen, true);
         else if (newlen > bufLen)
-            allocate(newlen, false);
+        {
+            // Grow by half of the current capacity at least to keep the
+            // repeated appends amortized, fall back to the exact size on failure.
+            size_t grow = bufLen + (bufLen >> 1);
+            if (grow > newlen)
+                allocate(getReservedLen(grow), false);
+            if (newlen > bufLen)
+                allocate(newlen, false);
+        }
 
         return newlen <= bufLen;
     }
@@ -2038,6 +2131,11 @@ private:
 
     char *buf = NULL;
     size_t bufLen = 0;
+    // cached string length, npos when the buffer was modified externally
+    mutable size_t strLen = 0;
+#if MB_STRING_SSO_SIZE > 0
+    char sso[MB_STRING_SSO_SIZE];
+#endif
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
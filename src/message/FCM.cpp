@@ -160,7 +160,7 @@ void FB_CM::fcm_connect(FirebaseData *fbdo, firebase_fcm_msg_mode mode)
                              : firebase_fcm_pgm_str_2 /* "iid" */);
 
     rescon(fbdo, host.c_str());
-    fbdo->tcpClient.setSession(&fbdo->bsslSession);
+    Core.setSSLSession(&fbdo->tcpClient, &fbdo->bsslSession);
     fbdo->tcpClient.begin(host.c_str(), port, &fbdo->session.response.code);
     fbdo->session.max_payload_length = 0;
 }
@@ -227,7 +227,9 @@ bool FB_CM::sendHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const cha
         if (fbdo->session.response.code < 0)
             return false;
 
-        fbdo->tcpSend(Core.getToken());
+        MB_String token;
+        Core.copyToken(token);
+        fbdo->tcpSend(token.c_str());
 
         if (fbdo->session.response.code < 0)
             return false;
@@ -863,11 +865,17 @@ bool FB_CM::fcm_send(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char
     // set the SSL client to skip server SSL certificate verification
     fbdo->tcpClient.setCACert(nullptr);
 
+    // hold the header pieces and payload to send them in as few TLS records as possible
+    fbdo->tcpClient.cork();
+
     bool ret = sendHeader(fbdo, mode, msg);
 
     if (ret)
         fbdo->tcpSend(msg);
 
+    if (fbdo->tcpClient.uncork() < 0 && fbdo->session.response.code >= 0)
+        fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+
     fbdo->session.fcm.payload.clear();
     if (fbdo->session.response.code < 0)
     {
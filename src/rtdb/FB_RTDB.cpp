@@ -111,27 +111,15 @@ bool FB_RTDB::mSetRules(FirebaseData *fbdo, MB_StringPtr rules, firebase_mem_sto
     return ret;
 }
 
-void FB_RTDB::storeToken(MB_String &atok, const char *databaseSecret)
+void FB_RTDB::storeToken(FirebaseData *fbdo, const char *databaseSecret)
 {
-    atok = Core.internal.auth_token;
-    Core.setTokenType(token_type_legacy_token);
-    Core.config->signer.tokens.legacy_token = databaseSecret;
-    Core.internal.auth_token = Core.config->signer.tokens.legacy_token;
-    Core.internal.ltok_len = strlen(databaseSecret);
-    Core.internal.rtok_len = 0;
-    Core.internal.atok_len = 0;
-    Core.handleToken();
+    // the secret is used by this session only, the shared auth token is kept unchanged for other tasks
+    fbdo->session.rtdb.auth_secret = databaseSecret;
 }
 
-void FB_RTDB::restoreToken(MB_String &atok, firebase_auth_token_type tk)
+void FB_RTDB::restoreToken(FirebaseData *fbdo)
 {
-    Core.internal.auth_token = atok;
-    atok.clear();
-    Core.config->signer.tokens.legacy_token = "";
-    Core.config->signer.tokens.token_type = tk;
-    Core.internal.atok_len = Core.internal.auth_token.length();
-    Core.internal.ltok_len = 0;
-    Core.handleToken();
+    fbdo->session.rtdb.auth_secret.clear();
 }
 
 bool FB_RTDB::mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr node,
@@ -142,7 +130,6 @@ bool FB_RTDB::mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr
 
     MB_String s;
     bool ret = false;
-    MB_String atok;
 
     firebase_auth_token_type tk = Core.getTokenType();
 
@@ -151,7 +138,7 @@ bool FB_RTDB::mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr
         if (strlen(addrTo<const char *>(databaseSecret.address())) &&
             tk != token_type_oauth2_access_token &&
             tk != token_type_legacy_token)
-            storeToken(atok, addrTo<const char *>(databaseSecret.address()));
+            storeToken(fbdo, addrTo<const char *>(databaseSecret.address()));
     }
 
     if (getRules(fbdo))
@@ -201,7 +188,7 @@ bool FB_RTDB::mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr
         if (strlen(addrTo<const char *>(databaseSecret.address())) &&
             tk != token_type_oauth2_access_token &&
             tk != token_type_legacy_token)
-            restoreToken(atok, tk);
+            restoreToken(fbdo);
     }
 
     s.clear();
@@ -216,7 +203,6 @@ bool FB_RTDB::mSetReadWriteRules(FirebaseData *fbdo, MB_StringPtr path, MB_Strin
 
     MB_String s;
     bool ret = false;
-    MB_String atok;
 
     firebase_auth_token_type tk = Core.getTokenType();
 
@@ -225,7 +211,7 @@ bool FB_RTDB::mSetReadWriteRules(FirebaseData *fbdo, MB_StringPtr path, MB_Strin
         if (strlen(addrTo<const char *>(databaseSecret.address())) &&
             tk != token_type_oauth2_access_token &&
             tk != token_type_legacy_token)
-            storeToken(atok, addrTo<const char *>(databaseSecret.address()));
+            storeToken(fbdo, addrTo<const char *>(databaseSecret.address()));
     }
 
     if (getRules(fbdo))
@@ -291,7 +277,7 @@ bool FB_RTDB::mSetReadWriteRules(FirebaseData *fbdo, MB_StringPtr path, MB_Strin
         if (strlen(addrTo<const char *>(databaseSecret.address())) &&
             tk != token_type_oauth2_access_token &&
             tk != token_type_legacy_token)
-            restoreToken(atok, tk);
+            restoreToken(fbdo);
     }
 
     s.clear();
@@ -329,6 +315,257 @@ bool FB_RTDB::mGetShallowData(FirebaseData *fbdo, MB_StringPtr path)
     return handleRequest(fbdo, &req);
 }
 
+bool FB_RTDB::mCommitBatch(FirebaseData *fbdo, Batch *batch, bool async)
+{
+    if (!batch || batch->size() == 0)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_MISSING_DATA;
+        return false;
+    }
+
+    // nothing will be sent when any path was invalid, see the item results for the offending paths
+    if (!batch->validate())
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_INVALID_BATCH_PATH;
+        return false;
+    }
+
+    MB_String payload;
+    batch->makePayload(payload);
+
+    bool ret = buildRequest(fbdo, rtdb_update_nocontent, toStringPtr(pgm2Str(firebase_pgm_str_1 /* "/" */)),
+                            toStringPtr(payload), d_json, _NO_SUB_TYPE, _NO_REF, _NO_QUERY, _NO_PRIORITY,
+                            toStringPtr(_NO_ETAG), async, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
+
+    // the multi-location update is atomic, all items share the same result
+    int code = fbdo->httpCode();
+    if (ret && code <= 0)
+        code = FIREBASE_ERROR_HTTP_CODE_OK;
+    batch->setResult(code);
+
+    return ret;
+}
+
+bool FB_RTDB::processPipeline(FirebaseData *fbdo)
+{
+    if (!fbdo)
+        return false;
+
+    firebase_mutex_guard guard(fbdo->session.mutex);
+    return readPipeline(fbdo) >= 0;
+}
+
+bool FB_RTDB::flushPipeline(FirebaseData *fbdo)
+{
+    if (!fbdo)
+        return false;
+
+    firebase_mutex_guard guard(fbdo->session.mutex);
+    return waitPipeline(fbdo, 0);
+}
+
+int FB_RTDB::readPipeline(FirebaseData *fbdo)
+{
+    struct firebase_rtdb_pipeline_info_t &pl = fbdo->session.rtdb.pipeline;
+
+    if (pl.pending.size() == 0)
+        return 0;
+
+    int total = 0;
+
+    // read only the data that is already available, the partial line or body is kept for the next call
+    while (pl.pending.size() > 0 && fbdo->tcpClient.available() > 0)
+    {
+        if (pl.state == firebase_rtdb_pipeline_read_body || pl.state == firebase_rtdb_pipeline_read_chunk_data)
+        {
+            char buf[64];
+            int len = pl.remaining < (int)sizeof(buf) ? pl.remaining : (int)sizeof(buf);
+            int r = fbdo->tcpClient.readBytes(buf, len);
+            if (r <= 0)
+                break;
+
+            total += r;
+            pl.remaining -= r;
+
+            // only the body of error response is kept for the error message
+            if (pl.http_code >= 400 && pl.body.length() + r <= fbdo->session.resp_size)
+                pl.body.append(buf, r);
+
+            if (pl.remaining == 0)
+            {
+                if (pl.state == firebase_rtdb_pipeline_read_body)
+                    completePipeline(fbdo);
+                else
+                    pl.state = firebase_rtdb_pipeline_read_chunk_size;
+            }
+
+            continue;
+        }
+
+        int r = fbdo->tcpClient.readLine(pl.line);
+        if (r <= 0)
+            break;
+
+        total += r;
+
+        if (pl.line[pl.line.length() - 1] != '\n')
+            continue;
+
+        // the result callback may send the new request which continues parsing the next response
+        MB_String line = pl.line;
+        pl.line.clear();
+        line.trim();
+
+        if (pl.state == firebase_rtdb_pipeline_read_status)
+        {
+            if (Core.sh.compare(line, 0, firebase_pgm_str_53 /* "HTTP/1.1 " */))
+            {
+                pl.http_code = atoi(line.c_str() + strlen_P(firebase_pgm_str_53));
+                pl.remaining = -1;
+                pl.chunked = false;
+                pl.close = false;
+                pl.body.clear();
+                pl.state = firebase_rtdb_pipeline_read_header;
+            }
+        }
+        else if (pl.state == firebase_rtdb_pipeline_read_header)
+        {
+            if (line.length() == 0)
+            {
+                if (pl.http_code >= 100 && pl.http_code < 200)
+                    pl.state = firebase_rtdb_pipeline_read_status; // interim response
+                else if (pl.http_code == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT ||
+                         pl.http_code == FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED)
+                    completePipeline(fbdo);
+                else if (pl.chunked)
+                    pl.state = firebase_rtdb_pipeline_read_chunk_size;
+                else if (pl.remaining > 0)
+                    pl.state = firebase_rtdb_pipeline_read_body;
+                else
+                {
+                    // the body without length is delimited by the connection close which can't be pipelined
+                    if (pl.remaining < 0)
+                        pl.close = true;
+                    completePipeline(fbdo);
+                }
+            }
+            else if (Core.sh.compare(line, 0, firebase_pgm_str_34 /* "Content-Length: " */, true))
+                pl.remaining = atoi(line.c_str() + strlen_P(firebase_pgm_str_34));
+            else if (Core.sh.compare(line, 0, firebase_pgm_str_50 /* "Transfer-Encoding: " */, true))
+                pl.chunked = Core.sh.compare(line, strlen_P(firebase_pgm_str_50), firebase_pgm_str_51 /* "chunked" */, true);
+            else if (Core.sh.compare(line, 0, firebase_pgm_str_48 /* "Connection: " */, true))
+                pl.close = Core.sh.compare(line, strlen_P(firebase_pgm_str_48), firebase_rtdb_pgm_str_41 /* "close" */, true);
+        }
+        else if (pl.state == firebase_rtdb_pipeline_read_chunk_size)
+        {
+            // skip the line break after the chunk data
+            if (line.length() > 0)
+            {
+                pl.remaining = strtol(line.c_str(), NULL, 16);
+                pl.state = pl.remaining > 0 ? firebase_rtdb_pipeline_read_chunk_data : firebase_rtdb_pipeline_read_trailer;
+            }
+        }
+        else if (pl.state == firebase_rtdb_pipeline_read_trailer)
+        {
+            if (line.length() == 0)
+                completePipeline(fbdo);
+        }
+    }
+
+    if (pl.pending.size() > 0 && !fbdo->tcpClient.connected() && fbdo->tcpClient.available() <= 0)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+        fbdo->closeSession();
+        return -1;
+    }
+
+    return total;
+}
+
+bool FB_RTDB::waitPipeline(FirebaseData *fbdo, size_t limit)
+{
+    struct firebase_rtdb_pipeline_info_t &pl = fbdo->session.rtdb.pipeline;
+    unsigned long dataTime = millis();
+
+    while (pl.pending.size() > limit)
+    {
+        int r = readPipeline(fbdo);
+
+        if (r < 0)
+            return false;
+
+        if (r > 0)
+            dataTime = millis();
+        else if (pl.pending.size() > limit)
+        {
+            // the session will be closed and the unanswered requests are reported when timed out or network lost
+            if (!fbdo->reconnect(dataTime))
+            {
+                if (pl.pending.size() > 0)
+                    fbdo->closeSession();
+                return false;
+            }
+
+            FBUtils::idle();
+        }
+    }
+
+    return true;
+}
+
+void FB_RTDB::completePipeline(FirebaseData *fbdo)
+{
+    struct firebase_rtdb_pipeline_info_t &pl = fbdo->session.rtdb.pipeline;
+
+    pl.state = firebase_rtdb_pipeline_read_status;
+
+    if (pl.pending.size() == 0)
+        return;
+
+    // the server replies in the same order of requests
+    RTDB_AsyncResultInfo info = pl.pending[0];
+    pl.pending.erase(pl.pending.begin());
+
+    info.httpCode = pl.http_code;
+
+    if (pl.http_code >= 400)
+    {
+        FirebaseJson js;
+        FirebaseJsonData d;
+        js.setJsonData(pl.body);
+        js.get(d, pgm2Str(firebase_pgm_str_58 /* "error" */));
+        if (d.success)
+            info.errorMsg = d.stringValue.c_str();
+        else
+            Core.errorToString(pl.http_code, info.errorMsg);
+    }
+
+    pl.body.clear();
+
+    bool close = pl.close;
+
+    if (pl.cb)
+        pl.cb(info);
+
+    // the remaining requests will not be answered
+    if (close)
+        fbdo->closeSession();
+}
+
+bool FB_RTDB::mGetJSONStream(FirebaseData *fbdo, MB_StringPtr path, firebase_data_type type, uint32_t query_addr,
+                             FirebaseJsonStreamReader *reader)
+{
+    if (!reader)
+        return false;
+
+    reader->reset();
+    fbdo->session.rtdb.json_reader = reader;
+    bool ret = buildRequest(fbdo, http_get, path, toStringPtr(_NO_PAYLOAD), type, _NO_SUB_TYPE, _NO_REF, query_addr,
+                            _NO_PRIORITY, toStringPtr(_NO_ETAG), _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
+    fbdo->session.rtdb.json_reader = nullptr;
+    return ret;
+}
+
 void FB_RTDB::enableClassicRequest(FirebaseData *fbdo, bool enable)
 {
     fbdo->session.classic_request = enable;
@@ -500,9 +737,6 @@ bool FB_RTDB::mDeleteNodesByTimestamp(FirebaseData *fbdo, MB_StringPtr path, MB_
 
     int _limit = atoi(lm.c_str());
 
-    if (_limit > 30)
-        _limit = 30;
-
 #if defined(__AVR__)
     uint32_t pr = Core.ut.strtoull_alt(_dataRetentionPeriod.c_str());
 #else
@@ -511,48 +745,589 @@ bool FB_RTDB::mDeleteNodesByTimestamp(FirebaseData *fbdo, MB_StringPtr path, MB_
 #endif
 
     QueryFilter query;
+    Batch batch;
+    MB_String _path = path;
 
     uint32_t lastTS = current_ts - pr;
 
-    if (strcmp(_timestampNode.c_str(), (const char *)MBSTRING_FLASH_MCR("$key")) == 0)
-        query.orderBy(_timestampNode).startAt(MB_String(0)).endAt(MB_String((int)lastTS)).limitToLast(_limit);
-    else
-        query.orderBy(_timestampNode).startAt(0).endAt(lastTS).limitToLast(_limit);
-
-    if (getJSON(fbdo, path, &query))
+    // The deleted nodes are no longer matched, then the same query returns the next page.
+    while (_limit > 0)
     {
+        int pageSize = _limit > MAX_DELETE_NODES_PER_QUERY ? MAX_DELETE_NODES_PER_QUERY : _limit;
+
+        query.clear();
+        if (strcmp(_timestampNode.c_str(), (const char *)MBSTRING_FLASH_MCR("$key")) == 0)
+            query.orderBy(_timestampNode).startAt(MB_String(0)).endAt(MB_String((int)lastTS)).limitToLast(pageSize);
+        else
+            query.orderBy(_timestampNode).startAt(0).endAt(lastTS).limitToLast(pageSize);
+
+        if (!getJSON(fbdo, _path, &query))
+            break;
+
         ret = true;
-        if (fbdo->session.rtdb.resp_data_type == d_json && fbdo->jsonString().length() > 4)
+
+        if (fbdo->session.rtdb.resp_data_type != d_json || fbdo->session.rtdb.raw.length() <= 4)
+            break;
+
+        // Only the keys of the top level nodes are needed, the nested nodes are skipped.
+        int count = 0;
+        MB_JSON *root = MB_JSON_Parse(fbdo->session.rtdb.raw.c_str());
+        for (MB_JSON *e = root ? root->child : NULL; e; e = e->next)
         {
-            FirebaseJson *js = fbdo->jsonObjectPtr();
-            size_t len = js->iteratorBegin();
-            FirebaseJson::IteratorValue value;
-            MB_String *nodes = new MB_String[len];
+            if (!e->string)
+                continue;
+            MB_String s = _path;
+            s += firebase_pgm_str_1; // "/"
+            s += e->string;
+            batch.remove(s.c_str());
+            count++;
+        }
+        MB_JSON_Delete(root);
 
-            for (size_t i = 0; i < len; i++)
-            {
-                value = js->valueAt(i);
-                if (value.type == FirebaseJson::JSON_OBJECT && value.key.length() > 1)
-                    nodes[i] = value.key;
-            }
-            js->iteratorEnd();
-            js->clear();
+        fbdo->clearJson();
+        fbdo->session.rtdb.raw.clear();
+
+        if (count == 0)
+            break;
+
+        // All nodes in this page are deleted at once in one multi-path update.
+        ret = commitBatch(fbdo, &batch);
+        batch.clear();
+
+        if (!ret || count < pageSize)
+            break;
+
+        _limit -= count;
+    }
+
+    query.clear();
+    return ret;
+}
+
+bool FB_RTDB::readFileManifest(FirebaseData *fbdo, const MB_String &path, struct firebase_rtdb_file_manifest_t &manifest)
+{
+    manifest = firebase_rtdb_file_manifest_t();
+
+    MB_String s = path;
+    s += MBSTRING_FLASH_MCR("/manifest");
+
+    if (!get(fbdo, s.c_str()))
+        return false;
+
+    // no manifest or not the chunked file
+    if (fbdo->session.rtdb.resp_data_type != d_json)
+        return true;
+
+    MB_JSON *root = MB_JSON_Parse(fbdo->session.rtdb.raw.c_str());
+    MB_JSON *e = MB_JSON_GetObjectItem(root, "size");
+    if (e)
+        manifest.size = e->valuedouble;
+    e = MB_JSON_GetObjectItem(root, "chunkSize");
+    if (e)
+        manifest.chunkSize = e->valuedouble;
+    e = MB_JSON_GetObjectItem(root, "count");
+    if (e)
+        manifest.count = e->valuedouble;
+    e = MB_JSON_GetObjectItem(root, "crc");
+    if (e && e->valuestring)
+        manifest.crc = strtoul(e->valuestring, NULL, 16);
+    e = MB_JSON_GetObjectItem(root, "sha256");
+    if (e && e->valuestring)
+        manifest.sha256 = e->valuestring;
+    manifest.complete = MB_JSON_IsTrue(MB_JSON_GetObjectItem(root, "complete"));
+    MB_JSON_Delete(root);
+
+    fbdo->clearJson();
+    fbdo->session.rtdb.raw.clear();
+
+    // the inconsistent manifest is treated as no manifest, the zero-length file has no chunk
+    manifest.valid = manifest.chunkSize > 0 &&
+                     manifest.count == (manifest.size + manifest.chunkSize - 1) / manifest.chunkSize;
+
+    return true;
+}
+
+int FB_RTDB::readFileChunk(const MB_String &fileName, firebase_mem_storage_type storageType, size_t offset,
+                           uint8_t *buf, size_t len)
+{
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    int ret = Core.mbfs.open(fileName, mbfs_type storageType, mb_fs_open_mode_read);
+    if (ret < 0)
+        return ret;
+
+    if (offset > 0 && !Core.mbfs.seek(mbfs_type storageType, offset))
+        ret = MB_FS_ERROR_FILE_IO_ERROR;
+    else
+        ret = Core.mbfs.read(mbfs_type storageType, buf, len);
+
+    Core.mbfs.close(mbfs_type storageType);
+    return ret;
+}
+
+bool FB_RTDB::writeFileChunk(const MB_String &fileName, firebase_mem_storage_type storageType, uint8_t *buf,
+                             size_t len, bool append)
+{
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    if (Core.mbfs.open(fileName, mbfs_type storageType, append ? mb_fs_open_mode_append : mb_fs_open_mode_write) < 0)
+        return false;
+
+    bool ret = len == 0 || Core.mbfs.write(mbfs_type storageType, buf, len) == (int)len;
+
+    Core.mbfs.close(mbfs_type storageType);
+    return ret;
+}
+
+void FB_RTDB::sha256Hex(const br_sha256_context &sha, MB_String &out)
+{
+    static const char hex[] = "0123456789abcdef";
+    uint8_t digest[br_sha256_SIZE];
+    br_sha256_out(&sha, digest);
+    out.clear();
+    for (size_t i = 0; i < br_sha256_SIZE; i++)
+    {
+        out += hex[digest[i] >> 4];
+        out += hex[digest[i] & 0x0f];
+    }
+}
+
+bool FB_RTDB::loadChunksCheckpoint(const MB_String &fileName, firebase_mem_storage_type storageType,
+                                   const struct firebase_rtdb_file_manifest_t &manifest, size_t &offset,
+                                   uint32_t &crc, br_sha256_context &sha)
+{
+    MB_String ckp = fileName;
+    ckp += MBSTRING_FLASH_MCR(".ckp");
+
+    // "FBC1", manifest crc, file size, written bytes, CRC32 of written bytes and SHA-256 state
+    uint8_t buf[20 + br_sha256_SIZE];
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+    bool ret = Core.mbfs.open(ckp, mbfs_type storageType, mb_fs_open_mode_read) == (int)sizeof(buf) &&
+               Core.mbfs.read(mbfs_type storageType, buf, sizeof(buf)) == (int)sizeof(buf);
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (!ret || memcmp(buf, "FBC1", 4) != 0)
+        return false;
+
+    uint32_t v[4];
+    for (int i = 0; i < 4; i++)
+        v[i] = (uint32_t)buf[4 + i * 4] | (uint32_t)buf[5 + i * 4] << 8 |
+               (uint32_t)buf[6 + i * 4] << 16 | (uint32_t)buf[7 + i * 4] << 24;
+
+    if (v[0] != manifest.crc || v[1] != manifest.size || v[2] == 0 || v[2] >= manifest.size ||
+        v[2] % manifest.chunkSize > 0)
+        return false;
+
+    offset = v[2];
+    crc = v[3];
+
+    // The SHA-256 state is saved at the last 64-byte block, the remaining bytes are read back from the file.
+    size_t tail = offset % 64;
+    uint8_t tailBuf[64];
+
+    ret = Core.mbfs.open(fileName, mbfs_type storageType, mb_fs_open_mode_read) == (int)offset &&
+          (tail == 0 || (Core.mbfs.seek(mbfs_type storageType, offset - tail) &&
+                         Core.mbfs.read(mbfs_type storageType, tailBuf, tail) == (int)tail));
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (!ret)
+        return false;
+
+    br_sha256_init(&sha);
+    br_sha256_set_state(&sha, buf + 20, offset - tail);
+    br_sha256_update(&sha, tailBuf, tail);
+
+    return true;
+}
+
+bool FB_RTDB::saveChunksCheckpoint(const MB_String &fileName, firebase_mem_storage_type storageType,
+                                   const struct firebase_rtdb_file_manifest_t &manifest, size_t offset,
+                                   uint32_t crc, const br_sha256_context &sha)
+{
+    MB_String ckp = fileName;
+    ckp += MBSTRING_FLASH_MCR(".ckp");
+
+    uint8_t buf[20 + br_sha256_SIZE];
+    uint32_t v[4] = {manifest.crc, (uint32_t)manifest.size, (uint32_t)offset, crc};
+    memcpy(buf, "FBC1", 4);
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            buf[4 + i * 4 + j] = (v[i] >> (8 * j)) & 0xff;
+    }
+    br_sha256_state(&sha, buf + 20);
+
+    bool ret = false;
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    if (Core.mbfs.open(ckp, mbfs_type storageType, mb_fs_open_mode_write) >= 0)
+    {
+        ret = Core.mbfs.write(mbfs_type storageType, buf, sizeof(buf)) == (int)sizeof(buf);
+        Core.mbfs.close(mbfs_type storageType);
+    }
+
+    return ret;
+}
+
+bool FB_RTDB::mSetFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr nodePath,
+                             MB_StringPtr fileName, size_t chunkSize, RTDB_UploadProgressCallback callback)
+{
+    if (fbdo->session.rtdb.pause)
+        return true;
+
+    // The file is opened for each chunk, the file lock is not held during the chunk requests.
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
+    MB_String _path = nodePath, _fileName = fileName;
+    Core.ut.makePath(_path);
+    Core.ut.makePath(_fileName);
+    while (_path.length() > 1 && _path[_path.length() - 1] == '/')
+        _path.pop_back();
+
+    if (chunkSize == 0)
+        chunkSize = FIREBASE_RTDB_FILE_CHUNK_SIZE;
+
+    int ret = 0;
+    {
+        firebase_mutex_guard fileGuard(Core.internal.file_mutex);
+        ret = Core.mbfs.open(_fileName, mbfs_type storageType, mb_fs_open_mode_read);
+        Core.mbfs.close(mbfs_type storageType);
+    }
+
+    if (ret < 0)
+    {
+        fbdo->session.response.code = ret;
+        return false;
+    }
+
+    uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(chunkSize));
+    if (!buf)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_FILE_CHUNKS_OUT_OF_MEMORY;
+        return false;
+    }
+
+    size_t size = ret, count = (size + chunkSize - 1) / chunkSize, done = 0, read = 0;
+
+    // The file CRC identifies the interrupted upload of the same file.
+    uint32_t crc = 0;
+    br_sha256_context sha;
+    br_sha256_init(&sha);
+    while (read < size)
+    {
+        int r = readFileChunk(_fileName, storageType, read, buf, size - read < chunkSize ? size - read : chunkSize);
+        if (r <= 0)
+            break;
+        crc = Core.ut.crc32(crc, buf, r);
+        br_sha256_update(&sha, buf, r);
+        read += r;
+    }
+
+    bool success = read == size;
+    if (!success)
+        fbdo->session.response.code = MB_FS_ERROR_FILE_IO_ERROR;
+
+    char crcStr[9];
+    snprintf(crcStr, sizeof(crcStr), "%08lx", (unsigned long)crc);
+
+    struct firebase_rtdb_file_manifest_t manifest;
 
-            for (size_t i = 0; i < len; i++)
+    if (success)
+        success = readFileManifest(fbdo, _path, manifest);
+
+    MB_String chunkPath = _path;
+    chunkPath += MBSTRING_FLASH_MCR("/chunks/");
+
+    if (success && manifest.valid && manifest.size == size && manifest.chunkSize == chunkSize && manifest.crc == crc)
+    {
+        if (manifest.complete)
+            done = count;
+        else
+        {
+            // The chunks are uploaded in order then the existing chunks are always the leading ones,
+            // the first missing chunk is found by the binary search.
+            size_t lo = 0, hi = count;
+            while (success && lo < hi)
             {
-                MB_String s = path;
-                s += firebase_pgm_str_1; // "/"
-                s += nodes[i];
-                deleteNode(fbdo, s);
+                size_t mid = lo + (hi - lo) / 2;
+                MB_String s = chunkPath;
+                s += mid;
+                if (mPathExisted(fbdo, toStringPtr(s)))
+                    lo = mid + 1;
+                else if (fbdo->session.response.code != FIREBASE_ERROR_HTTP_CODE_OK &&
+                         fbdo->session.response.code != FIREBASE_ERROR_PATH_NOT_EXIST)
+                    success = false;
+                else
+                    hi = mid;
             }
+            done = lo;
+        }
+    }
+    else if (success)
+    {
+        manifest.complete = false;
+        MB_String hash;
+        sha256Hex(sha, hash);
+        FirebaseJson json;
+        json.set("manifest/size", (int)size);
+        json.set("manifest/chunkSize", (int)chunkSize);
+        json.set("manifest/count", (int)count);
+        json.set("manifest/crc", (const char *)crcStr);
+        json.set("manifest/sha256", hash.c_str());
+        json.set("manifest/complete", false);
+        // replace the old chunks
+        success = buildRequest(fbdo, rtdb_set_nocontent, toStringPtr(_path), toStringPtr(_NO_PAYLOAD),
+                               d_json, _NO_SUB_TYPE, toAddr(json), _NO_QUERY, _NO_PRIORITY, toStringPtr(_NO_ETAG),
+                               _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
+    }
 
-            delete[] nodes;
-            nodes = nullptr;
+    RTDB_UploadStatusInfo in;
+    int progress = -1;
+    unsigned long ms = millis();
+    size_t sent = 0;
+
+    // Each chunk is the independent node, the upload can be resumed from any chunk.
+    for (size_t i = done; success && i < count; i++)
+    {
+        size_t len = i == count - 1 ? size - i * chunkSize : chunkSize;
+        if (readFileChunk(_fileName, storageType, i * chunkSize, buf, len) != (int)len)
+        {
+            fbdo->session.response.code = MB_FS_ERROR_FILE_IO_ERROR;
+            success = false;
+            break;
+        }
+
+        MB_String s = chunkPath;
+        s += i;
+        MB_String data = Core.bh.encodeToString(&Core.mbfs, buf, len);
+        success = buildRequest(fbdo, rtdb_set_nocontent, toStringPtr(s), toStringPtr(data),
+                               d_string, _NO_SUB_TYPE, _NO_REF, _NO_QUERY, _NO_PRIORITY, toStringPtr(_NO_ETAG),
+                               _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
+        if (success)
+            sent += len;
+
+        int p = (float)(i + 1) / count * 100;
+        if (success && callback && p != progress && (p == 100 || progress + ESP_REPORT_PROGRESS_INTERVAL <= p))
+        {
+            progress = p;
+            makeUploadStatus(in, _fileName, _path, firebase_rtdb_upload_status_upload, p, 0, millis() - ms, "");
+            in.throughput = (uint64_t)sent * 1000 / (millis() - ms > 0 ? millis() - ms : 1);
+            sendUploadCallback(fbdo, in, callback, nullptr);
         }
     }
 
-    query.clear();
-    return ret;
+    Core.mbfs.delP(&buf);
+
+    if (success && !manifest.complete)
+    {
+        MB_String s = _path;
+        s += MBSTRING_FLASH_MCR("/manifest/complete");
+        success = setBool(fbdo, s.c_str(), true);
+    }
+
+    if (callback)
+    {
+        if (success)
+        {
+            makeUploadStatus(in, _fileName, _path, firebase_rtdb_upload_status_complete, 100, size, millis() - ms, "");
+            in.throughput = (uint64_t)sent * 1000 / (millis() - ms > 0 ? millis() - ms : 1);
+        }
+        else
+            makeUploadStatus(in, _fileName, _path, firebase_rtdb_upload_status_error, 0, 0, 0, fbdo->errorReason());
+        sendUploadCallback(fbdo, in, callback, nullptr);
+    }
+
+    return success;
+}
+
+bool FB_RTDB::mGetFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr nodePath,
+                             MB_StringPtr fileName, bool ota, RTDB_DownloadProgressCallback callback)
+{
+    if (fbdo->session.rtdb.pause)
+        return true;
+
+    // The file is opened for each chunk, the file lock is not held during the chunk requests.
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
+    MB_String _path = nodePath, _fileName = fileName;
+    Core.ut.makePath(_path);
+    Core.ut.makePath(_fileName);
+    while (_path.length() > 1 && _path[_path.length() - 1] == '/')
+        _path.pop_back();
+
+    struct firebase_rtdb_file_manifest_t manifest;
+
+    if (!readFileManifest(fbdo, _path, manifest))
+        return false;
+
+    if (!manifest.valid || !manifest.complete)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_FILE_CHUNKS_INCOMPLETE;
+        return false;
+    }
+
+    size_t read = 0;
+    uint32_t fileCrc = 0;
+    br_sha256_context sha;
+    br_sha256_init(&sha);
+    bool success = true;
+
+    if (ota)
+    {
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+        if (!Update.begin(manifest.size))
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_FW_UPDATE_TOO_LOW_FREE_SKETCH_SPACE;
+            success = false;
+        }
+#else
+        fbdo->session.response.code = FIREBASE_ERROR_FW_UPDATE_BEGIN_FAILED;
+        success = false;
+#endif
+    }
+    else
+    {
+        // continue the file from the checkpoint of the previous download of the same file
+        bool resume = loadChunksCheckpoint(_fileName, storageType, manifest, read, fileCrc, sha);
+        if (!resume)
+        {
+            read = 0;
+            fileCrc = 0;
+            br_sha256_init(&sha);
+        }
+
+        // the new file is created (also the empty file of the zero-length manifest)
+        if (!resume && !writeFileChunk(_fileName, storageType, nullptr, 0, false))
+        {
+            fbdo->session.response.code = MB_FS_ERROR_FILE_IO_ERROR;
+            success = false;
+        }
+    }
+
+    if (!success)
+        return false;
+
+    // The response buffer should fit the encoded chunk.
+    uint16_t respSize = fbdo->session.resp_size;
+    size_t len = Core.bh.encodedLength(manifest.chunkSize) + 16;
+    fbdo->session.resp_size = len > 0xfffc ? 0xfffc : len;
+
+    RTDB_DownloadStatusInfo in;
+    int progress = -1;
+    unsigned long ms = millis();
+    MB_VECTOR<uint8_t> data;
+
+    MB_String chunkPath = _path;
+    chunkPath += MBSTRING_FLASH_MCR("/chunks/");
+
+    for (size_t i = read / manifest.chunkSize; success && i < manifest.count; i++)
+    {
+        MB_String s = chunkPath;
+        s += i;
+
+        // The dropped connection is reconnected by the next request, the written data and the running hash
+        // are kept then only the failed chunk is downloaded again.
+        for (int retry = 0; retry <= FIREBASE_RTDB_FILE_CHUNK_RETRY; retry++)
+        {
+            success = getString(fbdo, s.c_str());
+            if (success || fbdo->session.response.code >= 0 || fbdo->session.response.code == FIREBASE_ERROR_PATH_NOT_EXIST)
+                break;
+        }
+
+        if (success && fbdo->session.rtdb.resp_data_type != d_string)
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_FILE_CHUNKS_INCOMPLETE;
+            success = false;
+        }
+
+        data.clear();
+        if (success && !Core.bh.decodeToArray(&Core.mbfs, fbdo->session.rtdb.raw, data))
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_FILE_CHUNKS_INCOMPLETE;
+            success = false;
+        }
+
+        fbdo->clearJson();
+        fbdo->session.rtdb.raw.clear();
+
+        if (!success)
+            break;
+
+        if (ota)
+            success = Core.bh.updateWrite(data.data(), data.size());
+        else
+            success = writeFileChunk(_fileName, storageType, data.data(), data.size(), true);
+
+        if (!success)
+        {
+            fbdo->session.response.code = ota ? FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED : MB_FS_ERROR_FILE_IO_ERROR;
+            break;
+        }
+
+        read += data.size();
+        fileCrc = Core.ut.crc32(fileCrc, data.data(), data.size());
+        br_sha256_update(&sha, data.data(), data.size());
+
+        int p = (float)(i + 1) / manifest.count * 100;
+        if (callback && p != progress && (p == 100 || progress + ESP_REPORT_PROGRESS_INTERVAL <= p))
+        {
+            progress = p;
+            makeDownloadStatus(in, _fileName, _path, firebase_rtdb_download_status_download, p, manifest.size, millis() - ms, "");
+            sendDownloadCallback(fbdo, in, callback, nullptr);
+        }
+    }
+
+    fbdo->session.resp_size = respSize;
+
+    if (success)
+    {
+        MB_String hash;
+        if (manifest.sha256.length() > 0)
+            sha256Hex(sha, hash);
+
+        if (read != manifest.size || fileCrc != manifest.crc || hash != manifest.sha256)
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_FILE_CHUNKS_CRC_MISMATCH;
+            success = false;
+        }
+    }
+
+    if (ota)
+    {
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+        if (success && !Update.end())
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_FW_UPDATE_END_FAILED;
+            success = false;
+        }
+#endif
+    }
+    else
+    {
+        MB_String ckp = _fileName;
+        ckp += MBSTRING_FLASH_MCR(".ckp");
+
+        // The checkpoint is saved when the download was interrupted, the verification failure starts over.
+        if (!success && read > 0 && read < manifest.size && fbdo->session.response.code != FIREBASE_ERROR_FILE_CHUNKS_CRC_MISMATCH)
+            saveChunksCheckpoint(_fileName, storageType, manifest, read, fileCrc, sha);
+        else
+        {
+            firebase_mutex_guard fileGuard(Core.internal.file_mutex);
+            Core.mbfs.remove(ckp, mbfs_type storageType);
+        }
+    }
+
+    if (callback)
+    {
+        if (success)
+            makeDownloadStatus(in, _fileName, _path, firebase_rtdb_download_status_complete, 100, manifest.size, millis() - ms, "");
+        else
+            makeDownloadStatus(in, _fileName, _path, firebase_rtdb_download_status_error, 0, 0, 0, fbdo->errorReason());
+        sendDownloadCallback(fbdo, in, callback, nullptr);
+    }
+
+    return success;
 }
 
 bool FB_RTDB::mBeginStream(FirebaseData *fbdo, MB_StringPtr path)
@@ -561,6 +1336,8 @@ bool FB_RTDB::mBeginStream(FirebaseData *fbdo, MB_StringPtr path)
     if (!Core.config)
         return false;
 
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
 #if defined(MB_ARDUINO_PICO)
     if (!Core.waitIdle(fbdo->session.response.code))
         return false;
@@ -576,6 +1353,8 @@ bool FB_RTDB::mBeginStream(FirebaseData *fbdo, MB_StringPtr path)
     fbdo->session.rtdb.data_tmo = false;
     fbdo->session.rtdb.stream_path = path;
 
+    replica.begin(toAddr(*fbdo), fbdo->session.rtdb.stream_path);
+
     if (!handleStreamRequest(fbdo, fbdo->session.rtdb.stream_path))
     {
         if (!fbdo->tokenReady())
@@ -597,16 +1376,24 @@ bool FB_RTDB::mBeginMultiPathStream(FirebaseData *fbdo, MB_StringPtr parentPath)
 
 bool FB_RTDB::readStream(FirebaseData *fbdo)
 {
-    return handleStreamRead(fbdo);
+    // the stream is being read or used by other task
+    if (!fbdo->session.mutex.tryLock())
+        return false;
+
+    bool ret = handleStreamRead(fbdo);
+    fbdo->session.mutex.unlock();
+    return ret;
 }
 
 bool FB_RTDB::endStream(FirebaseData *fbdo)
 {
+    firebase_mutex_guard guard(fbdo->session.mutex);
     fbdo->session.rtdb.pause = true;
     fbdo->session.rtdb.stream_stop = true;
     fbdo->session.con_mode = firebase_con_mode_undefined;
     fbdo->closeSession();
     clearDataStatus(fbdo);
+    replica.invalidate(toAddr(*fbdo));
     return true;
 }
 
@@ -676,6 +1463,9 @@ bool FB_RTDB::handleStreamRead(FirebaseData *fbdo)
     {
         fbdo->session.rtdb.new_stream = true;
 
+        // the changes were missed while disconnected, wait for the full data of the new connection
+        replica.invalidate(toAddr(*fbdo));
+
         if (!Core.waitIdle(fbdo->session.response.code))
             return exitStream(fbdo, false);
 
@@ -792,62 +1582,222 @@ void FB_RTDB::removeMultiPathStreamCallback(FirebaseData *fbdo)
 
     fbdo->_multiPathDataCallback = NULL;
     fbdo->_timeoutCallback = NULL;
+
+    // the stream task exits by itself when no session left
     fbdo->setSession(true, false);
+}
+
+void FB_RTDB::runStreamTask()
+{
+    if (!Core.config || !Core.internal.stream_loop_task_enable)
+        return;
 
 #if defined(ESP32)
-    if (Core.internal.sessions.size() == 0)
+
+    static FB_RTDB *_this = this;
+
+    // one task serves all stream sessions
+    firebase_mutex_guard guard(Core.internal.session_mutex);
+    if (Core.internal.stream_task_handle)
+        return;
+
+    MB_String taskName = "Stream_";
+    taskName += random(1, 100);
+
+    TaskFunction_t taskCode = [](void *param)
+    {
+        FirebaseConfig *config = (FirebaseConfig *)param;
+        for (;;)
+        {
+            Core.internal.session_mutex.lock();
+            if (!Core.internal.stream_loop_task_enable || Core.internal.sessions.size() == 0)
+            {
+                Core.internal.stream_task_handle = NULL;
+                Core.internal.session_mutex.unlock();
+                break;
+            }
+            Core.internal.session_mutex.unlock();
+
+            _this->mRunStream();
+            _this->waitStream(Core.internal.stream_task_delay_ms);
+        }
+
+        vTaskDelete(NULL);
+    };
+
+    xTaskCreatePinnedToCore(taskCode, taskName.c_str(), Core.internal.stream_task_stack_size,
+                            Core.config, Core.internal.stream_task_priority,
+                            &Core.internal.stream_task_handle,
+                            Core.internal.stream_task_cpu_core);
+
+#elif defined(FIREBASE_HOST_STREAM_TASK)
+
+    static FB_RTDB *_this = this;
+
+    // one thread serves all stream sessions
+    firebase_mutex_guard guard(Core.internal.session_mutex);
+    if (Core.internal.stream_task_running)
+        return;
+
+    // the thread that exited is joined before its stack is reused
+    if (Core.internal.stream_task_stack)
+        pthread_join(Core.internal.stream_task_handle, NULL);
+    else
+        Core.internal.stream_task_stack = new uint8_t[Core.internal.stream_task_stack_size];
+
+    void *(*taskCode)(void *) = [](void *param) -> void *
     {
-        if (Core.internal.stream_task_handle)
-            vTaskDelete(Core.internal.stream_task_handle);
+        for (;;)
+        {
+            Core.internal.session_mutex.lock();
+            if (!Core.internal.stream_loop_task_enable || Core.internal.sessions.size() == 0)
+            {
+                Core.internal.stream_task_running = false;
+                Core.internal.session_mutex.unlock();
+                break;
+            }
+            Core.internal.session_mutex.unlock();
+
+            _this->mRunStream();
+            _this->waitStream(Core.internal.stream_task_delay_ms);
+        }
+
+        return NULL;
+    };
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, Core.internal.stream_task_stack, Core.internal.stream_task_stack_size);
+    Core.internal.stream_task_running = pthread_create(&Core.internal.stream_task_handle, &attr, taskCode, NULL) == 0;
+    pthread_attr_destroy(&attr);
+
+    // no thread to join on the next start
+    if (!Core.internal.stream_task_running)
+    {
+        delete[] Core.internal.stream_task_stack;
+        Core.internal.stream_task_stack = nullptr;
+    }
+
+#else
+    mRunStream();
+
+#if defined(ESP8266)
+    Core.set_scheduled_callback(std::bind(&FB_RTDB::runStreamTask, this));
+#endif
 
-        Core.internal.stream_task_handle = NULL;
-    }
 #endif
 }
 
-void FB_RTDB::runStreamTask()
+#if defined(ESP32) || defined(FIREBASE_HOST_STREAM_TASK)
+void FB_RTDB::waitStream(uint32_t pollDelay)
 {
-    if (!Core.config || !Core.internal.stream_loop_task_enable)
-        return;
-
-#if defined(ESP32)
+#if defined(FIREBASE_HOST_STREAM_TASK)
+    MB_VECTOR<struct pollfd> fds;
+#else
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    int maxfd = -1;
+#endif
+    bool poll = false;
 
-    static FB_RTDB *_this = this;
+    for (size_t id = 0; id < Core.internal.sessions.size(); id++)
+    {
+        FirebaseData *fbdo = FirebaseData::lockSession(Core.internal.sessions, id);
 
-    MB_String taskName = "Stream_";
-    taskName += random(1, 100);
+        // the session that is being used by other task
+        if (!fbdo)
+        {
+            poll = true;
+            continue;
+        }
 
-    TaskFunction_t taskCode = [](void *param)
-    {
-        FirebaseConfig *config = (FirebaseConfig *)param;
-        const TickType_t xDelay = Core.internal.stream_task_delay_ms / portTICK_PERIOD_MS;
-        for (;;)
+        if (fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_timeoutCallback)
         {
-            if (!Core.internal.stream_loop_task_enable)
-                break;
-            _this->mRunStream();
-            vTaskDelay(xDelay);
+            int fd = fbdo->tcpClient.fd();
+
+            // The session without socket (external client, not connected or reconnecting), the data that
+            // was already buffered by the client and the idle check are served without waiting.
+            if (fd < 0 || fbdo->session.con_mode != firebase_con_mode_rtdb_stream ||
+                millis() - fbdo->session.rtdb.stream_check_millis >= FIREBASE_STREAM_IDLE_CHECK_INTERVAL ||
+                fbdo->tcpClient.available() > 0)
+                fbdo->session.rtdb.stream_ready = true;
+            else
+            {
+#if defined(FIREBASE_HOST_STREAM_TASK)
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                fds.push_back(pfd);
+#else
+                FD_SET(fd, &rfds);
+                if (fd > maxfd)
+                    maxfd = fd;
+#endif
+            }
+
+            if (fbdo->session.rtdb.stream_ready)
+                poll = true;
         }
 
-        Core.internal.stream_task_handle = NULL;
+        fbdo->unlockSession();
+    }
 
-        vTaskDelete(NULL);
-    };
+    // wait for the socket readable or the earliest idle check, or the polling delay when
+    // any session can't be waited
+    uint32_t wait = poll ? pollDelay : FIREBASE_STREAM_IDLE_CHECK_INTERVAL;
 
-    xTaskCreatePinnedToCore(taskCode, taskName.c_str(), Core.internal.stream_task_stack_size,
-                            Core.config, Core.internal.stream_task_priority,
-                            &Core.internal.stream_task_handle,
-                            Core.internal.stream_task_cpu_core);
+#if defined(FIREBASE_HOST_STREAM_TASK)
+    if (fds.size() == 0)
+    {
+        delay(wait);
+        return;
+    }
 
+    int ret = ::poll(fds.data(), fds.size(), wait);
 #else
-    mRunStream();
+    if (maxfd < 0)
+    {
+        vTaskDelay(wait / portTICK_PERIOD_MS);
+        return;
+    }
 
-#if defined(ESP8266)
-    Core.set_scheduled_callback(std::bind(&FB_RTDB::runStreamTask, this));
+    struct timeval tv;
+    tv.tv_sec = wait / 1000;
+    tv.tv_usec = (wait % 1000) * 1000;
+
+    fd_set ready = rfds;
+    int ret = select(maxfd + 1, &ready, NULL, NULL, &tv);
 #endif
 
+    for (size_t id = 0; ret != 0 && id < Core.internal.sessions.size(); id++)
+    {
+        FirebaseData *fbdo = FirebaseData::lockSession(Core.internal.sessions, id);
+        if (!fbdo)
+            continue;
+
+        int fd = fbdo->tcpClient.fd();
+
+        // the socket was closed or replaced by other task while waiting (ret < 0), read it to recover
+#if defined(FIREBASE_HOST_STREAM_TASK)
+        for (size_t i = 0; fd >= 0 && i < fds.size(); i++)
+        {
+            if (fds[i].fd == fd && (ret < 0 || fds[i].revents != 0))
+                fbdo->session.rtdb.stream_ready = true;
+        }
+#else
+        if (fd >= 0 && FD_ISSET(fd, &rfds) && (ret < 0 || FD_ISSET(fd, &ready)))
+            fbdo->session.rtdb.stream_ready = true;
 #endif
+
+        fbdo->unlockSession();
+    }
+
+    // let the other tasks run when the sockets are readable immediately
+    if (ret != 0)
+        FBUtils::idle();
 }
+#endif
 
 void FB_RTDB::mStopStreamLoopTask()
 {
@@ -865,24 +1815,41 @@ void FB_RTDB::mRunStream()
     for (size_t id = 0; id < Core.internal.sessions.size(); id++)
     {
 
-        fbdo = addrTo<FirebaseData *>(Core.internal.sessions[id].ptr);
+        // the session that is being used by other task will be read in the next round
+        fbdo = FirebaseData::lockSession(Core.internal.sessions, id);
 
         if (fbdo)
         {
-            if ((fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_timeoutCallback))
+            if ((fbdo->_dataAvailableCallback || fbdo->_multiPathDataCallback || fbdo->_timeoutCallback) &&
+                fbdo->session.rtdb.stream_ready)
             {
+#if defined(ESP32) || defined(FIREBASE_HOST_STREAM_TASK)
+                // the stream task waits for the next data, the manual run (runStream) reads every time
+                if (Core.internal.stream_loop_task_enable)
+                {
+                    fbdo->session.rtdb.stream_ready = false;
+                    fbdo->session.rtdb.stream_check_millis = millis();
+                }
+#endif
                 if (Core.isExpired())
                 {
                     fbdo->session.rtdb.stream_tmo_Millis = millis();
                     fbdo->session.rtdb.data_tmo = false;
+                    fbdo->unlockSession();
                     return;
                 }
 
                 readStream(fbdo);
 
+                // deliver the queued events when no worker
+                if (fbdo->session.rtdb.stream_queue.slots.size() > 0 && !streamWorkerRunning())
+                    processStreamQueue(fbdo);
+
                 if (fbdo->streamTimeout() && fbdo->_timeoutCallback)
                     fbdo->sendStreamToCB(fbdo->session.response.code);
             }
+
+            fbdo->unlockSession();
         }
     }
 }
@@ -926,7 +1893,25 @@ void FB_RTDB::addQueueData(FirebaseData *fbdo, struct firebase_rtdb_request_info
         qItem.etag = req->data.etag;
         qItem.async = req->async;
         qItem.blobSize = req->data.blobSize;
+
+        // The write that its data does not refer to the user variable is kept in the offline journal.
+        if (fbdo->_qMan._journal.length() > 0 && req->method != http_get && req->data.type != d_blob &&
+            req->data.address.priority == 0)
+        {
+            if (req->data.address.din > 0 && req->data.type == d_json)
+                qItem.payload = addrTo<FirebaseJson *>(req->data.address.din)->raw();
+            else if (req->data.address.din > 0 && req->data.type == d_array)
+                qItem.payload = addrTo<FirebaseJsonArray *>(req->data.address.din)->raw();
+            qItem.address.din = 0;
+
+            if (writeJournal(fbdo, qItem))
+                return;
+        }
+
         fbdo->addQueue(&qItem);
+
+        if (qItem.qID > 0 && fbdo->session.rtdb.queue_ID == qItem.qID)
+            appendQueueRecord(fbdo, qItem, firebase_rtdb_queue_record_add);
     }
 }
 
@@ -938,7 +1923,7 @@ void FB_RTDB::runErrorQueueTask()
 
     for (size_t id = 0; id < Core.internal.queueSessions.size(); id++)
     {
-        FirebaseData *fbdo = addrTo<FirebaseData *>(Core.internal.queueSessions[id].ptr);
+        FirebaseData *fbdo = FirebaseData::lockSession(Core.internal.queueSessions, id);
 
         if (fbdo)
         {
@@ -946,6 +1931,8 @@ void FB_RTDB::runErrorQueueTask()
                 processErrorQueue(fbdo, fbdo->_queueInfoCallback);
             else
                 processErrorQueue(fbdo, NULL);
+
+            fbdo->unlockSession();
         }
     }
 
@@ -962,6 +1949,8 @@ void FB_RTDB::processErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfoCallb
 {
     FBUtils::idle();
 
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
     if (!fbdo->reconnect())
         return;
 
@@ -1004,11 +1993,17 @@ void FB_RTDB::processErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfoCallb
                              MB_StringPtr(toAddr(item.filename), mb_string_sub_type_mb_string),
                              (firebase_mem_storage_type)item.storageType))
             {
+                appendQueueRecord(fbdo, item, firebase_rtdb_queue_record_remove);
                 fbdo->clearQueueItem(&item);
                 fbdo->_qMan.remove(i);
             }
         }
     }
+
+    // write the records that were deferred while the storage was busy
+    flushQueueRecords(fbdo);
+
+    processOfflineJournal(fbdo, callback);
 }
 
 bool FB_RTDB::isErrorQueueExisted(FirebaseData *fbdo, uint32_t errorQueueID)
@@ -1060,7 +2055,7 @@ void FB_RTDB::beginAutoRunErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfo
         {
             for (size_t i = 0; i < Core.internal.queueSessions.size(); i++)
             {
-                FirebaseData *_fbdo = addrTo<FirebaseData *>(Core.internal.queueSessions[i].ptr);
+                FirebaseData *_fbdo = FirebaseData::lockSession(Core.internal.queueSessions, i);
 
                 if (_fbdo)
                 {
@@ -1068,6 +2063,8 @@ void FB_RTDB::beginAutoRunErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfo
                         _this->processErrorQueue(_fbdo, _fbdo->_queueInfoCallback);
                     else
                         _this->processErrorQueue(_fbdo, NULL);
+
+                    _fbdo->unlockSession();
                 }
 
                 vTaskDelay(xDelay);
@@ -1123,21 +2120,519 @@ void FB_RTDB::clearErrorQueue(FirebaseData *fbdo)
     }
 }
 
-void FB_RTDB::setMaxErrorQueue(FirebaseData *fbdo, uint8_t num)
+void FB_RTDB::setMaxErrorQueue(FirebaseData *fbdo, uint8_t num)
+{
+    fbdo->_qMan._maxQueue = num;
+
+    if (fbdo->_qMan.size() > num)
+    {
+        for (uint8_t i = fbdo->_qMan.size() - 1; i >= num; i--)
+        {
+            if (!fbdo->_qMan._queueCollection)
+                return;
+
+            QueueItem item = fbdo->_qMan._queueCollection->at(i);
+            fbdo->clearQueueItem(&item);
+        }
+    }
+}
+
+void FB_RTDB::encodeQueueRecord(MB_VECTOR<uint8_t> &out, const QueueItem &item, uint8_t op)
+{
+    // The record is the body length, the body and the CRC32 of body.
+    // The body is the operation, queue ID and for the added queue, the queue data.
+    size_t start = out.size();
+    for (int i = 0; i < 4; i++)
+        out.push_back(0);
+
+    out.push_back(op);
+    putQueueValue(out, item.qID);
+
+    if (op == firebase_rtdb_queue_record_add)
+    {
+        out.push_back((uint8_t)item.dataType);
+        out.push_back((uint8_t)item.subType);
+        out.push_back((uint8_t)item.method);
+        out.push_back((uint8_t)item.storageType);
+        out.push_back((uint8_t)item.async);
+        putQueueValue(out, item.address.din);
+        putQueueValue(out, item.address.dout);
+        putQueueValue(out, item.address.query);
+        putQueueValue(out, item.address.priority);
+        putQueueValue(out, item.blobSize);
+
+        const MB_String *s[4] = {&item.path, &item.payload, &item.etag, &item.filename};
+        for (int i = 0; i < 4; i++)
+        {
+            putQueueValue(out, s[i]->length());
+            for (size_t j = 0; j < s[i]->length(); j++)
+                out.push_back((*s[i])[j]);
+        }
+    }
+
+    uint32_t len = out.size() - start - 4;
+    for (int i = 0; i < 4; i++)
+        out[start + i] = (len >> (8 * i)) & 0xff;
+
+    putQueueValue(out, Core.ut.crc32(0, out.data() + start + 4, len));
+}
+
+void FB_RTDB::putQueueValue(MB_VECTOR<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((value >> (8 * i)) & 0xff);
+}
+
+uint32_t FB_RTDB::getQueueValue(const uint8_t *buf, size_t &pos)
+{
+    uint32_t v = (uint32_t)buf[pos] | (uint32_t)buf[pos + 1] << 8 | (uint32_t)buf[pos + 2] << 16 | (uint32_t)buf[pos + 3] << 24;
+    pos += 4;
+    return v;
+}
+
+bool FB_RTDB::decodeQueueRecord(const uint8_t *buf, size_t len, QueueItem &item, uint8_t &op)
+{
+    size_t pos = 1;
+
+    if (len < 5)
+        return false;
+
+    op = buf[0];
+    item.qID = getQueueValue(buf, pos);
+
+    if (op == firebase_rtdb_queue_record_remove)
+        return true;
+
+    if (op != firebase_rtdb_queue_record_add || len < 46)
+        return false;
+
+    item.dataType = (firebase_data_type)buf[pos++];
+    item.subType = buf[pos++];
+    item.method = (firebase_request_method)buf[pos++];
+    item.storageType = (firebase_mem_storage_type)buf[pos++];
+    item.async = buf[pos++];
+    item.address.din = getQueueValue(buf, pos);
+    item.address.dout = getQueueValue(buf, pos);
+    item.address.query = getQueueValue(buf, pos);
+    item.address.priority = getQueueValue(buf, pos);
+    item.blobSize = getQueueValue(buf, pos);
+
+    MB_String *s[4] = {&item.path, &item.payload, &item.etag, &item.filename};
+    for (int i = 0; i < 4; i++)
+    {
+        if (pos + 4 > len)
+            return false;
+        size_t n = getQueueValue(buf, pos);
+        if (pos + n > len)
+            return false;
+        s[i]->clear();
+        s[i]->append(reinterpret_cast<const char *>(buf + pos), n);
+        pos += n;
+    }
+
+    return true;
+}
+
+void FB_RTDB::appendQueueRecord(FirebaseData *fbdo, const QueueItem &item, uint8_t op)
+{
+    if (fbdo->_qMan._file.length() == 0)
+        return;
+
+    encodeQueueRecord(fbdo->_qMan._pending, item, op);
+    flushQueueRecords(fbdo);
+}
+
+bool FB_RTDB::flushQueueRecords(FirebaseData *fbdo)
+{
+    if (fbdo->_qMan._file.length() == 0 || fbdo->_qMan._pending.size() == 0)
+        return true;
+
+    firebase_mem_storage_type storageType = (firebase_mem_storage_type)fbdo->_qMan._storageType;
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    // The storage is used by other file, the records will be written later.
+    if (Core.mbfs.ready(mbfs_type storageType))
+        return false;
+
+    // The file of the empty queue is truncated to the header instead of keeping the records of removed queues.
+    bool empty = fbdo->_qMan.size() == 0;
+
+    if (Core.mbfs.open(fbdo->_qMan._file, mbfs_type storageType, empty ? mb_fs_open_mode_write : mb_fs_open_mode_append) < 0)
+        return false;
+
+    bool ret = empty ? Core.mbfs.write(mbfs_type storageType, (uint8_t *)"FBQ1", 4) == 4
+                     : Core.mbfs.write(mbfs_type storageType, fbdo->_qMan._pending.data(),
+                                       fbdo->_qMan._pending.size()) == (int)fbdo->_qMan._pending.size();
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (ret)
+        fbdo->_qMan._pending.clear();
+
+    return ret;
+}
+
+bool FB_RTDB::mBeginOfflineJournal(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType,
+                                   size_t maxSize, size_t segmentSize)
+{
+    QueueManager &qm = fbdo->_qMan;
+    MB_String _filename = filename;
+
+    if (_filename.length() == 0 || (storageType != mem_storage_type_flash && storageType != mem_storage_type_sd))
+    {
+        fbdo->session.response.code = MB_FS_ERROR_FILE_IO_ERROR;
+        return false;
+    }
+
+    if (segmentSize < FIREBASE_RTDB_JOURNAL_MIN_SEGMENT_SIZE)
+        segmentSize = FIREBASE_RTDB_JOURNAL_MIN_SEGMENT_SIZE;
+
+    size_t segments = maxSize / segmentSize;
+
+    qm._journal = _filename;
+    qm._journalStorageType = storageType;
+    qm._journalSegmentSize = segmentSize;
+    qm._journalSegments = segments < 2 ? 2 : (segments > 255 ? 255 : segments);
+    qm._journalHead = 0;
+    qm._journalTail = 0;
+    qm._journalTailSize = 0;
+    qm._journalReadPos = 8;
+    qm._journalSeq = 1;
+    qm._journalDone = 0;
+    qm._journalCount = 0;
+
+    uint32_t minAdd = 0, maxAdd = 0;
+
+    // Find the oldest and newest segments and the records that were not replayed from the previous session.
+    for (uint8_t i = 0; i < qm._journalSegments; i++)
+    {
+        firebase_rtdb_journal_segment_t seg;
+        MB_String name;
+        journalSegmentName(fbdo, i, name);
+
+        if (!readJournalSegment(fbdo, name, seg))
+            continue;
+
+        if (qm._journalTail == 0 || seg.seq < qm._journalHead)
+            qm._journalHead = seg.seq;
+
+        if (qm._journalTail == 0 || seg.seq > qm._journalTail)
+        {
+            qm._journalTail = seg.seq;
+            // The new records can't be appended after the corrupted record, start the new segment instead.
+            qm._journalTailSize = seg.corrupted ? segmentSize : seg.size;
+        }
+
+        if (seg.maxAdd > 0 && (minAdd == 0 || seg.minAdd < minAdd))
+            minAdd = seg.minAdd;
+        if (seg.maxAdd > maxAdd)
+            maxAdd = seg.maxAdd;
+        if (seg.done > qm._journalDone)
+            qm._journalDone = seg.done;
+    }
+
+    if (qm._journalTail == 0)
+        qm._journalHead = qm._journalTail = 1;
+
+    if (maxAdd > 0)
+    {
+        qm._journalSeq = maxAdd + 1;
+        qm._journalCount = maxAdd - (qm._journalDone >= minAdd ? qm._journalDone : minAdd - 1);
+        if (qm._journalDone > maxAdd)
+            qm._journalCount = 0;
+    }
+
+    if (qm._journalDone >= qm._journalSeq)
+        qm._journalSeq = qm._journalDone + 1;
+
+    return true;
+}
+
+void FB_RTDB::endOfflineJournal(FirebaseData *fbdo)
+{
+    fbdo->_qMan._journal.clear();
+    fbdo->_qMan._journalCount = 0;
+}
+
+size_t FB_RTDB::offlineJournalCount(FirebaseData *fbdo)
+{
+    return fbdo->_qMan._journalCount;
+}
+
+void FB_RTDB::journalSegmentName(FirebaseData *fbdo, uint32_t seq, MB_String &name)
+{
+    // The segment files are used as the ring, <filename>.0 to <filename>.<segments - 1>
+    name = fbdo->_qMan._journal;
+    name += '.';
+    name += (int)(seq % fbdo->_qMan._journalSegments);
+}
+
+bool FB_RTDB::readJournalSegment(FirebaseData *fbdo, const MB_String &name, firebase_rtdb_journal_segment_t &seg)
+{
+    firebase_mem_storage_type storageType = (firebase_mem_storage_type)fbdo->_qMan._journalStorageType;
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    int size = Core.mbfs.open(name, mbfs_type storageType, mb_fs_open_mode_read);
+    if (size < 0)
+        return false;
+
+    // "FBJ1" and the segment sequence number followed by the queue records
+    uint8_t head[8];
+    size_t hpos = 4;
+    if (size < 8 || Core.mbfs.read(mbfs_type storageType, head, 8) != 8 || memcmp(head, "FBJ1", 4) != 0)
+    {
+        Core.mbfs.close(mbfs_type storageType);
+        return false;
+    }
+
+    seg.seq = getQueueValue(head, hpos);
+    seg.size = 8;
+
+    MB_VECTOR<uint8_t> buf;
+    int len = 0;
+
+    while ((len = readQueueRecord(storageType, seg.size, size, buf)) > 0)
+    {
+        FBUtils::idle();
+
+        seg.size += 8 + len;
+        hpos = 1;
+        uint32_t seq = getQueueValue(buf.data(), hpos);
+
+        if (buf[0] == firebase_rtdb_queue_record_add)
+        {
+            if (seg.minAdd == 0)
+                seg.minAdd = seq;
+            seg.maxAdd = seq;
+        }
+        else if (buf[0] == firebase_rtdb_queue_record_remove && seq > seg.done)
+            seg.done = seq;
+    }
+
+    seg.corrupted = (int)seg.size < size;
+
+    Core.mbfs.close(mbfs_type storageType);
+
+    return true;
+}
+
+bool FB_RTDB::writeJournal(FirebaseData *fbdo, QueueItem &item)
+{
+    QueueManager &qm = fbdo->_qMan;
+    firebase_mem_storage_type storageType = (firebase_mem_storage_type)qm._journalStorageType;
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    // The storage is used by other file
+    if (Core.mbfs.ready(mbfs_type storageType))
+        return false;
+
+    MB_String name;
+
+    if (qm._journalTailSize >= qm._journalSegmentSize)
+    {
+        qm._journalTail++;
+        qm._journalTailSize = 0;
+    }
+
+    if (qm._journalTailSize == 0)
+    {
+        // The oldest segment is dropped to keep the journal size in the limit.
+        while (qm._journalTail - qm._journalHead >= qm._journalSegments)
+            dropJournalSegment(fbdo);
+
+        journalSegmentName(fbdo, qm._journalTail, name);
+
+        uint8_t head[8] = {'F', 'B', 'J', '1'};
+        for (int i = 0; i < 4; i++)
+            head[4 + i] = (qm._journalTail >> (8 * i)) & 0xff;
+
+        if (Core.mbfs.open(name, mbfs_type storageType, mb_fs_open_mode_write) < 0)
+            return false;
+
+        bool ret = Core.mbfs.write(mbfs_type storageType, head, 8) == 8;
+        Core.mbfs.close(mbfs_type storageType);
+
+        if (!ret)
+            return false;
+
+        qm._journalTailSize = 8;
+    }
+    else
+        journalSegmentName(fbdo, qm._journalTail, name);
+
+    item.qID = qm._journalSeq;
+
+    MB_VECTOR<uint8_t> buf;
+    encodeQueueRecord(buf, item, firebase_rtdb_queue_record_add);
+
+    if (Core.mbfs.open(name, mbfs_type storageType, mb_fs_open_mode_append) < 0)
+        return false;
+
+    bool ret = Core.mbfs.write(mbfs_type storageType, buf.data(), buf.size()) == (int)buf.size();
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (!ret)
+    {
+        // the partial record can't be appended after
+        qm._journalTailSize = qm._journalSegmentSize;
+        return false;
+    }
+
+    qm._journalTailSize += buf.size();
+    qm._journalSeq++;
+    qm._journalCount++;
+
+    return true;
+}
+
+void FB_RTDB::dropJournalSegment(FirebaseData *fbdo)
+{
+    QueueManager &qm = fbdo->_qMan;
+    firebase_rtdb_journal_segment_t seg;
+    MB_String name;
+    journalSegmentName(fbdo, qm._journalHead, name);
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    if (readJournalSegment(fbdo, name, seg) && seg.maxAdd > qm._journalDone)
+    {
+        // the records that were not replayed
+        size_t dropped = seg.maxAdd - (qm._journalDone >= seg.minAdd ? qm._journalDone : seg.minAdd - 1);
+        qm._journalCount = qm._journalCount > dropped ? qm._journalCount - dropped : 0;
+    }
+
+    Core.mbfs.remove(name, mbfs_type qm._journalStorageType);
+    qm._journalHead++;
+    qm._journalReadPos = 8;
+}
+
+void FB_RTDB::processOfflineJournal(FirebaseData *fbdo, FirebaseData::QueueInfoCallback callback)
 {
-    fbdo->_qMan._maxQueue = num;
-
-    if (fbdo->_qMan.size() > num)
+    QueueManager &qm = fbdo->_qMan;
+    firebase_mem_storage_type storageType = (firebase_mem_storage_type)qm._journalStorageType;
+    MB_VECTOR<uint8_t> buf;
+    MB_String name;
+
+    // The records are replayed in the order that they were written, the replay stops at the failed record
+    // and it will be retried in the next run.
+    while (qm._journal.length() > 0 && (qm._journalCount > 0 || qm._journalHead < qm._journalTail))
     {
-        for (uint8_t i = fbdo->_qMan.size() - 1; i >= num; i--)
+        FBUtils::idle();
+
+        journalSegmentName(fbdo, qm._journalHead, name);
+
+        int len = -1;
+
         {
-            if (!fbdo->_qMan._queueCollection)
+            firebase_mutex_guard guard(Core.internal.file_mutex);
+
+            if (Core.mbfs.ready(mbfs_type storageType))
                 return;
 
-            QueueItem item = fbdo->_qMan._queueCollection->at(i);
-            fbdo->clearQueueItem(&item);
+            int size = Core.mbfs.open(name, mbfs_type storageType, mb_fs_open_mode_read);
+            if (size >= 0)
+            {
+                if (Core.mbfs.seek(mbfs_type storageType, qm._journalReadPos))
+                    len = readQueueRecord(storageType, qm._journalReadPos, size, buf);
+                Core.mbfs.close(mbfs_type storageType);
+            }
+        }
+
+        if (len <= 0)
+        {
+            // All records of this segment were replayed
+            if (qm._journalHead == qm._journalTail)
+            {
+                qm._journalCount = 0;
+                break;
+            }
+
+            mDeleteStorageFile(toStringPtr(name), storageType);
+            qm._journalHead++;
+            qm._journalReadPos = 8;
+            continue;
+        }
+
+        QueueItem item;
+        uint8_t op = 0;
+        if (!decodeQueueRecord(buf.data(), len, item, op))
+            item.qID = 0;
+
+        if (op != firebase_rtdb_queue_record_add || item.qID <= qm._journalDone)
+        {
+            qm._journalReadPos += 8 + len;
+            continue;
+        }
+
+        QueueInfo qinfo;
+        if (callback)
+        {
+            qinfo._isQueue = true;
+            qinfo._dataType = fbdo->getDataType(item.dataType);
+            qinfo._path = item.path;
+            qinfo._currentQueueID = item.qID;
+            qinfo._method = fbdo->getMethod(item.method);
+            qinfo._totalQueue = qm._journalCount;
+            qinfo._isQueueFull = false;
+            callback(qinfo);
+        }
+
+        // The queue flag is set to prevent the failed request from adding to the journal again.
+        if (!buildRequest(fbdo, item.method, MB_StringPtr(toAddr(item.path), mb_string_sub_type_mb_string),
+                          MB_StringPtr(toAddr(item.payload), mb_string_sub_type_mb_string), item.dataType,
+                          item.subType, _NO_REF, _NO_QUERY, _NO_PRIORITY,
+                          MB_StringPtr(toAddr(item.etag), mb_string_sub_type_mb_string),
+                          item.async, true, _NO_BLOB_SIZE,
+                          MB_StringPtr(toAddr(item.filename), mb_string_sub_type_mb_string),
+                          (firebase_mem_storage_type)item.storageType))
+        {
+            // The replay is resumed from this record after the transport error.
+            if (fbdo->session.response.code < 0)
+                return;
+
+            // The record that was rejected by the server (e.g. by the rules) will never succeed,
+            // it is dropped and reported to not block the records behind it.
+            if (callback)
+            {
+                qinfo._httpCode = fbdo->session.response.code;
+                qinfo._errorReason = fbdo->errorReason().c_str();
+                callback(qinfo);
+            }
+        }
+
+        qm._journalReadPos += 8 + len;
+        qm._journalDone = item.qID;
+        if (qm._journalCount > 0)
+            qm._journalCount--;
+
+        // The replayed record is marked in its segment which it will not be replayed again after restart.
+        buf.clear();
+        encodeQueueRecord(buf, item, firebase_rtdb_queue_record_remove);
+        firebase_mutex_guard guard(Core.internal.file_mutex);
+        if (!Core.mbfs.ready(mbfs_type storageType) &&
+            Core.mbfs.open(name, mbfs_type storageType, mb_fs_open_mode_append) >= 0)
+        {
+            if (Core.mbfs.write(mbfs_type storageType, buf.data(), buf.size()) == (int)buf.size() &&
+                qm._journalHead == qm._journalTail)
+                qm._journalTailSize += buf.size();
+            Core.mbfs.close(mbfs_type storageType);
         }
     }
+
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
+    // Start the new segment after all records were replayed which the journal does not hold the flash space.
+    if (qm._journal.length() > 0 && qm._journalCount == 0 && qm._journalTailSize > 0 &&
+        !Core.mbfs.ready(mbfs_type storageType))
+    {
+        journalSegmentName(fbdo, qm._journalTail, name);
+        Core.mbfs.remove(name, mbfs_type storageType);
+        qm._journalHead = ++qm._journalTail;
+        qm._journalTailSize = 0;
+        qm._journalReadPos = 8;
+    }
 }
 
 bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
@@ -1145,6 +2640,8 @@ bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebas
 
     MB_String _filename = filename;
 
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
     int ret = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_write);
 
     if (ret < 0)
@@ -1153,40 +2650,44 @@ bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebas
         return false;
     }
 
-    // Close file and open later.
-    Core.mbfs.close(mbfs_type storageType);
-
-    if ((storageType == mem_storage_type_flash || storageType == mem_storage_type_sd) &&
-        !Core.mbfs.ready(mbfs_type storageType))
-        return false;
-
-    FirebaseJsonArray arr;
-
-    // required for ESP32 core 2.0.x
-    Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_write);
+    // "FBQ1" and the records of all queues, see encodeQueueRecord.
+    MB_VECTOR<uint8_t> buf;
+    for (int i = 0; i < 4; i++)
+        buf.push_back("FBQ1"[i]);
 
     for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
     {
         if (!fbdo->_qMan._queueCollection)
             continue;
 
-        QueueItem item = fbdo->_qMan._queueCollection->at(i);
-        arr.clear();
-        arr.add((uint8_t)item.dataType, (uint8_t)item.subType, (uint8_t)item.method,
-                (uint8_t)item.storageType, (uint8_t)item.async);
-        arr.add(item.address.din, item.address.dout, item.address.query,
-                item.address.priority, item.blobSize);
-        arr.add(item.path, item.payload, item.etag, item.filename);
-        Core.mbfs.write(mbfs_type storageType, (uint8_t *)arr.raw(), strlen(arr.raw()));
+        encodeQueueRecord(buf, fbdo->_qMan._queueCollection->at(i), firebase_rtdb_queue_record_add);
     }
 
+    bool success = Core.mbfs.write(mbfs_type storageType, buf.data(), buf.size()) == (int)buf.size();
     Core.mbfs.close(mbfs_type storageType);
+
+    if (!success)
+    {
+        fbdo->session.response.code = MB_FS_ERROR_FILE_IO_ERROR;
+        return false;
+    }
+
+    // the later added and removed queues are appended to this file
+    fbdo->_qMan._file = _filename;
+    fbdo->_qMan._storageType = storageType;
+    fbdo->_qMan._pending.clear();
+
     return true;
 }
 
 bool FB_RTDB::mRestoreErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
 {
-    return openErrorQueue(fbdo, filename, storageType, 1) != 0;
+    if (openErrorQueue(fbdo, filename, storageType, 1) == 0)
+        return false;
+
+    // Rewrite the file without the removed queues and the incomplete record from the power loss
+    // which the new records can be appended to.
+    return mSaveErrorQueue(fbdo, filename, storageType);
 }
 
 uint8_t FB_RTDB::mErrorQueueCount(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
@@ -1196,15 +2697,89 @@ uint8_t FB_RTDB::mErrorQueueCount(FirebaseData *fbdo, MB_StringPtr filename, fir
 
 bool FB_RTDB::mDeleteStorageFile(MB_StringPtr filename, firebase_mem_storage_type storageType)
 {
+    firebase_mutex_guard guard(Core.internal.file_mutex);
     return Core.mbfs.remove(MB_String(filename), mbfs_type storageType);
 }
 
+int FB_RTDB::readQueueRecord(firebase_mem_storage_type storageType, int pos, int size, MB_VECTOR<uint8_t> &buf)
+{
+    uint8_t head[4];
+    size_t hpos = 0;
+
+    if (pos + 8 > size || Core.mbfs.read(mbfs_type storageType, head, 4) != 4)
+        return -1;
+
+    uint32_t len = getQueueValue(head, hpos);
+    if (len == 0 || pos + 8 + (int)len > size)
+        return -1;
+
+    buf.resize(len + 4);
+    if (Core.mbfs.read(mbfs_type storageType, buf.data(), len + 4) != (int)len + 4)
+        return -1;
+
+    hpos = len;
+    if (getQueueValue(buf.data(), hpos) != Core.ut.crc32(0, buf.data(), len))
+        return -1;
+
+    return len;
+}
+
+uint8_t FB_RTDB::readQueueRecords(FirebaseData *fbdo, firebase_mem_storage_type storageType, int size, uint8_t mode)
+{
+    MB_VECTOR<QueueItem> items;
+    MB_VECTOR<uint8_t> buf;
+    int pos = 4, len = 0;
+
+    // The records are read until the end of file or the incomplete or corrupted record.
+    while ((len = readQueueRecord(storageType, pos, size, buf)) > 0)
+    {
+        FBUtils::idle();
+
+        pos += 8 + len;
+
+        QueueItem item;
+        uint8_t op = 0;
+        if (!decodeQueueRecord(buf.data(), len, item, op))
+            break;
+
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            if (items[i].qID == item.qID)
+            {
+                items.erase(items.begin() + i);
+                break;
+            }
+        }
+
+        if (op == firebase_rtdb_queue_record_add)
+            items.push_back(item);
+    }
+
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (mode == 1)
+    {
+        if (!fbdo->_qMan._queueCollection)
+            fbdo->_qMan._queueCollection = new MB_VECTOR<struct QueueItem>();
+
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            if (!isErrorQueueExisted(fbdo, items[i].qID))
+                fbdo->_qMan._queueCollection->push_back(items[i]);
+        }
+    }
+
+    return items.size() > 255 ? 255 : items.size();
+}
+
 uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, MB_StringPtr filename,
                                 firebase_mem_storage_type storageType, uint8_t mode)
 {
     uint8_t count = 0;
     MB_String _filename = filename;
 
+    firebase_mutex_guard guard(Core.internal.file_mutex);
+
     int ret = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_read);
 
     if (ret < 0)
@@ -1219,6 +2794,13 @@ uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, MB_StringPtr filename,
         return 0;
     }
 
+    uint8_t head[4];
+    if (Core.mbfs.read(mbfs_type storageType, head, 4) == 4 && memcmp(head, "FBQ1", 4) == 0)
+        return readQueueRecords(fbdo, storageType, ret, mode);
+
+    // the JSON queue file from the previous version
+    Core.mbfs.seek(mbfs_type storageType, 0);
+
     QueueItem item;
 
 #if defined(MBFS_ESP32_SDFAT_ENABLED)
@@ -1512,6 +3094,9 @@ bool FB_RTDB::processRequest(FirebaseData *fbdo, struct firebase_rtdb_request_in
 
     FBUtils::idle();
 
+    // the request holds its session only, the other sessions run in parallel
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
     if (preRequestCheck(fbdo, req) <= 0)
         return false;
 
@@ -1557,7 +3142,15 @@ bool FB_RTDB::processRequest(FirebaseData *fbdo, struct firebase_rtdb_request_in
     uint8_t errCount = 0;
     uint8_t maxRetry = fbdo->session.rtdb.max_retry > 0 ? fbdo->session.rtdb.max_retry : 1;
 
-    for (int i = 0; i < maxRetry; i++)
+    // The get request under the replicated stream path is served from the replica without network I/O.
+    bool cached = readReplica(fbdo, req);
+    if (cached)
+    {
+        ret = fbdo->session.response.code == FIREBASE_ERROR_HTTP_CODE_OK;
+        setPtrValue(fbdo, req);
+    }
+
+    for (int i = 0; !cached && i < maxRetry; i++)
     {
         ret = handleRequest(fbdo, req);
         setPtrValue(fbdo, req);
@@ -1569,6 +3162,10 @@ bool FB_RTDB::processRequest(FirebaseData *fbdo, struct firebase_rtdb_request_in
                 errCount++;
     }
 
+    // The written data is applied to the replica as its stream event may arrive later.
+    if (ret && !cached)
+        writeReplica(fbdo, req);
+
     if (!ret && errCount == maxRetry && fbdo->_qMan._maxQueue > 0)
     {
 #if defined(ENABLE_ERROR_QUEUE) || defined(FIREBASE_ENABLE_ERROR_QUEUE)
@@ -1632,6 +3229,11 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
 {
     FBUtils::idle();
 
+    firebase_mutex_guard guard(fbdo->session.mutex);
+
+    // the file of upload, download, backup and restore is kept opened until the response was read
+    firebase_mutex_guard fileGuard(Core.internal.file_mutex, req->filename.length() > 0);
+
     if (preRequestCheck(fbdo, req) <= 0)
         return false;
 
@@ -1643,9 +3245,21 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
     if (!fbdo->tcpClient.connected())
         fbdo->session.rtdb.async_count = 0;
 
-    if ((fbdo->session.rtdb.async && !req->async) ||
-        fbdo->session.rtdb.async_count > Core.config->async_close_session_max_request)
+    if (fbdo->session.rtdb.pipeline.enable)
+    {
+        // Read the in-flight responses before the non-async request and before the session was
+        // timed out and will be closed by rescon, otherwise keep up to max_in_flight requests.
+        // The failure was already reported via the result callback and the session was closed,
+        // this request will be sent on the new connection.
+        size_t limit = 0;
+        if (req->async && millis() - fbdo->session.last_conn_ms <= fbdo->session.conn_timeout)
+            limit = fbdo->session.rtdb.pipeline.max_in_flight - 1;
+        waitPipeline(fbdo, limit);
+    }
+    else if ((fbdo->session.rtdb.async && !req->async) ||
+             fbdo->session.rtdb.async_count > Core.config->async_close_session_max_request)
     {
+        // the responses of async requests were not read, close the session to discard them
         fbdo->session.rtdb.async_count = 0;
         fbdo->closeSession();
     }
@@ -1666,11 +3280,19 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
     fbdo->session.rtdb.req_data_type = req->data.type;
     fbdo->session.rtdb.data_mismatch = false;
     fbdo->session.rtdb.async = req->async;
-    if (req->async)
+    if (req->async && !fbdo->session.rtdb.pipeline.enable)
         fbdo->session.rtdb.async_count++;
 
     if (sendRequest(fbdo, req))
     {
+        if (req->async && fbdo->session.rtdb.pipeline.enable)
+        {
+            RTDB_AsyncResultInfo info;
+            info.id = ++fbdo->session.rtdb.pipeline.last_id;
+            info.method = req->method;
+            info.path = req->path;
+            fbdo->session.rtdb.pipeline.pending.push_back(info);
+        }
 
         if (req->method == rtdb_stream)
         {
@@ -1734,6 +3356,7 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
                                  req->fileSize,
                                  0,
                                  "");
+                in.throughput = req->throughput;
                 sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
             }
         }
@@ -1751,11 +3374,46 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
         }
     }
     else
+    {
+        // the partially sent request can't be followed by the in-flight responses
+        if (fbdo->session.rtdb.pipeline.pending.size() > 0)
+            fbdo->closeSession();
         return false;
+    }
 
     return true;
 }
 
+size_t FB_RTDB::nextUploadChunk(FirebaseData *fbdo, struct firebase_rtdb_upload_rate_t &rate)
+{
+    if (rate.chunk == 0)
+        rate.chunk = rate.max;
+
+    // The write that fits the free space of the send buffer is not split into the partial TLS record
+    // or the partial cork buffer.
+    int avail = fbdo->tcpClient.availableForWrite();
+    if (avail >= FIREBASE_RTDB_MIN_UPLOAD_CHUNK && (size_t)avail < rate.chunk)
+        return avail;
+
+    return rate.chunk;
+}
+
+void FB_RTDB::updateUploadRate(struct firebase_rtdb_upload_rate_t &rate, size_t len, unsigned long ms)
+{
+    uint32_t r = (uint64_t)len * 1000 / (ms > 0 ? ms : 1);
+
+    // grow the write size while the throughput keeps up, shrink it when the larger write stalls
+    if ((uint64_t)r * 4 >= (uint64_t)rate.rate * 3)
+        rate.chunk = rate.chunk * 2 > rate.max ? rate.max : rate.chunk * 2;
+    else
+        rate.chunk = rate.chunk / 2 < FIREBASE_RTDB_MIN_UPLOAD_CHUNK ? FIREBASE_RTDB_MIN_UPLOAD_CHUNK : rate.chunk / 2;
+
+    if (rate.chunk > rate.max)
+        rate.chunk = rate.max;
+
+    rate.rate = r;
+}
+
 void FB_RTDB::reportUploadProgress(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req, size_t readBytes)
 {
     if (!req)
@@ -1774,6 +3432,7 @@ void FB_RTDB::reportUploadProgress(FirebaseData *fbdo, struct firebase_rtdb_requ
         fbdo->tcpClient.dataTime = millis() - fbdo->tcpClient.dataStart;
 
         req->progress = p;
+        req->throughput = (uint64_t)readBytes * 1000 / (fbdo->tcpClient.dataTime > 0 ? fbdo->tcpClient.dataTime : 1);
 
         fbdo->session.rtdb.cbUploadInfo.status = firebase_rtdb_upload_status_upload;
         if (req->uploadCallback)
@@ -1787,6 +3446,7 @@ void FB_RTDB::reportUploadProgress(FirebaseData *fbdo, struct firebase_rtdb_requ
                              0,
                              fbdo->tcpClient.dataTime,
                              "");
+            in.throughput = req->throughput;
             sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
         }
     }
@@ -1888,7 +3548,7 @@ int FB_RTDB::preRequestCheck(FirebaseData *fbdo, struct firebase_rtdb_request_in
         code = FIREBASE_ERROR_TOKEN_NOT_READY;
     else if (req->path.length() == 0 ||
              (Core.config->database_url.length() == 0 && Core.config->host.length() == 0) ||
-             (strlen(Core.getToken()) == 0 && !Core.config->signer.test_mode))
+             (Core.tokenLength() == 0 && fbdo->session.rtdb.auth_secret.length() == 0 && !Core.config->signer.test_mode))
         code = FIREBASE_ERROR_MISSING_CREDENTIALS;
     else if (req->method != rtdb_stream &&
              (req->method == http_put || req->method == http_post || req->method == http_patch ||
@@ -1906,11 +3566,27 @@ int FB_RTDB::preRequestCheck(FirebaseData *fbdo, struct firebase_rtdb_request_in
 }
 
 bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    // hold the header and payload pieces to send them in as few TLS records as possible
+    fbdo->tcpClient.cork();
+
+    bool ret = mSendRequest(fbdo, req);
+
+    if (fbdo->tcpClient.uncork() < 0)
+    {
+        if (fbdo->session.response.code >= 0)
+            fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool FB_RTDB::mSendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
 {
 
     fbdo->session.http_code = 0;
 
-    char *buf = nullptr;
     int len = 0;
     size_t toRead = 0;
     bool ret = false;
@@ -1939,7 +3615,7 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
 
     fbdo->session.max_payload_length = 0;
 
-    fbdo->tcpClient.setSession(&fbdo->bsslSession);
+    Core.setSSLSession(&fbdo->tcpClient, &fbdo->bsslSession);
     fbdo->tcpClient.begin(Core.config->database_url.c_str(), FIREBASE_PORT, &fbdo->session.response.code);
 
     if (req->task_type == firebase_rtdb_task_upload_rules)
@@ -2117,14 +3793,18 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
             Core.mbfs.close(mbfs_type req->storageType);
             Core.mbfs.open(filenme, mbfs_type req->storageType, mb_fs_open_mode_read);
 
-            while (len)
+            // the buffer is allocated once for the transfer
+            struct firebase_rtdb_upload_rate_t rate;
+            rate.max = bufSize;
+            uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufSize, false));
+
+            while (len > 0)
             {
-                toRead = len;
-                if ((int)toRead > bufSize)
-                    toRead = bufSize - 1;
+                toRead = nextUploadChunk(fbdo, rate);
+                if ((int)toRead > len)
+                    toRead = len;
 
-                buf = reinterpret_cast<char *>(Core.mbfs.newP(bufSize, false));
-                int read = Core.mbfs.read(mbfs_type req->storageType, (uint8_t *)buf, toRead);
+                int read = Core.mbfs.read(mbfs_type req->storageType, buf, toRead);
                 readLen += read;
 
                 reportUploadProgress(fbdo, req, readLen);
@@ -2132,21 +3812,21 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
                 if (read != (int)toRead)
                     break;
 
-                buf[toRead] = '\0';
-
-                fbdo->tcpSend(buf);
-
-                Core.mbfs.delP(&buf);
+                unsigned long writeMs = millis();
+                fbdo->tcpWrite(buf, toRead);
+                updateUploadRate(rate, toRead, millis() - writeMs);
 
                 if (fbdo->session.response.code < 0)
-                    return false;
+                    break;
 
                 len -= toRead;
-
-                if (len <= 0)
-                    break;
             }
 
+            Core.mbfs.delP(&buf);
+
+            if (fbdo->session.response.code < 0)
+                return false;
+
             reportUploadProgress(fbdo, req, req->fileSize);
         }
 
@@ -2178,22 +3858,46 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
     out.bufLen = bufSize;
     uint8_t *outBuf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(out.bufLen));
     out.outT = outBuf;
-    unsigned char *base64EncBuf = Core.bh.creatBase64EncBuffer(&Core.mbfs, false);
-    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(3));
 
-    while (Core.mbfs.available(mbfs_type storageType))
+    // read the block that its encoded data fits the output buffer,
+    // only the last block can be the size that is not multiple of 3 which is padded.
+    int inLen = (out.bufLen / 4) * 3;
+    if (inLen < 3)
+        inLen = 3;
+    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(inLen));
+    int keep = 0;
+
+    struct firebase_rtdb_upload_rate_t rate;
+    rate.max = out.bufLen;
+
+    while (total < size)
     {
-        // read 3 bytes from stream
-        int read = Core.mbfs.read(mbfs_type storageType, data, 3);
-        if (read)
-        {
-            if (!Core.bh.encode<uint8_t>(&Core.mbfs, base64EncBuf, data, read, out, read != 3 /* write remaining */))
-                break;
-            total += read;
-            reportUploadProgress(fbdo, req, total);
-        }
-        else
+        // the encoded block of this size is written at once
+        int blockLen = (nextUploadChunk(fbdo, rate) / 4) * 3;
+        if (blockLen < keep + 3)
+            blockLen = keep + 3;
+        if (blockLen > inLen)
+            blockLen = inLen;
+
+        int read = Core.mbfs.read(mbfs_type storageType, data + keep, blockLen - keep);
+        if (read <= 0)
+            break;
+
+        int avail = keep + read;
+        bool last = total + avail >= size;
+        int len = last ? avail : avail - avail % 3;
+
+        unsigned long writeMs = millis();
+        if (!Core.bh.encode<uint8_t>(&Core.mbfs, data, len, out, true /* write remaining */))
             break;
+        updateUploadRate(rate, (len + 2) / 3 * 4, millis() - writeMs);
+
+        total += len;
+        keep = avail - len;
+        if (keep > 0)
+            memmove(data, data + len, keep);
+
+        reportUploadProgress(fbdo, req, total);
     }
 
     // remainig data to wrire? write it
@@ -2201,7 +3905,6 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
         Core.bh.writeOutput(&Core.mbfs, out);
 
     Core.mbfs.delP(&data);
-    Core.mbfs.delP(&base64EncBuf);
     Core.mbfs.delP(&outBuf);
 
     return size == total;
@@ -2209,22 +3912,19 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
 
 bool FB_RTDB::waitResponse(FirebaseData *fbdo, firebase_rtdb_request_info_t *req)
 {
-#if defined(ESP32) || defined(MB_ARDUINO_PICO)
-
-    // if currently perform stream payload handling process, skip it.
-    if (Core.internal.fb_processing && fbdo->session.con_mode == firebase_con_mode_rtdb_stream)
-        return true;
+    // if the stream payload of this session is currently handled by other task, skip it.
+    if (fbdo->session.con_mode == firebase_con_mode_rtdb_stream)
+    {
+        if (!fbdo->session.mutex.tryLock())
+            return true;
+    }
+    else
+        fbdo->session.mutex.lock();
 
-    // set the blocking flag
-    Core.internal.fb_processing = true;
     bool ret = handleResponse(fbdo, req);
-    // reset the blocking flag
-    Core.internal.fb_processing = false;
+    fbdo->session.mutex.unlock();
 
     return ret;
-#else
-    return handleResponse(fbdo, req);
-#endif
 }
 
 int FB_RTDB::openFile(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, mb_fs_open_mode mode, bool closeSession)
@@ -2255,7 +3955,8 @@ bool FB_RTDB::handleResponse(FirebaseData *fbdo, firebase_rtdb_request_info_t *r
     if (fbdo->session.rtdb.pause)
         return true;
 
-    if (!fbdo->tcpClient.connected())
+    // the data that was already buffered (e.g. the trailing cancel or auth_revoked event) is still readable
+    if (!fbdo->tcpClient.connected() && fbdo->tcpClient.available() <= 0)
     {
         fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
 
@@ -2352,6 +4053,9 @@ waits:
             // keep it as a first payload
             payload += tcpHandler.header;
 
+            if (fbdo->session.con_mode != firebase_con_mode_rtdb_stream)
+                response.dataHash = FBUtils::hashUpdate(response.dataHash, tcpHandler.header.c_str(), tcpHandler.header.length());
+
             // clear header buffer
             tcpHandler.header.clear();
         }
@@ -2439,6 +4143,10 @@ waits:
                     FBUtils::idle();
                     payload += pChunk;
 
+                    // the stream event data are hashed when the events were parsed
+                    if (fbdo->session.con_mode != firebase_con_mode_rtdb_stream)
+                        response.dataHash = FBUtils::hashUpdate(response.dataHash, pChunk.c_str(), pChunk.length());
+
                     // early parsing currently available http response for data types, event types, and event data
                     // which these information will be used for download task
                     if (!parseTCPResponse(fbdo, req, tcpHandler, response))
@@ -2451,12 +4159,22 @@ waits:
                                                                       payload[payload.length() - ofs] == '"' &&
                                                                       payload[payload.length() - ofs + 1] == '}';
 
+                    // JSON stream reader assigned? feed the chunk and drop it instead of keeping the whole response
+                    if (fbdo->session.rtdb.json_reader && !response.isEvent &&
+                        response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK &&
+                        (response.dataType == d_json || response.dataType == d_array))
+                    {
+                        fbdo->session.rtdb.json_reader->feed(payload.c_str(), payload.length());
+                        payload.clear();
+                    }
+
                     if (response.dataType == d_file)
                     {
 #if defined(MBFS_FLASH_FS)
 
                         // In case file is available in stream with no download request,
                         // we store this file data to temp file (/fb_bin_0.tmp) that user can read from stream data
+                        firebase_mutex_guard guard(Core.internal.file_mutex);
 
                         Core.mbfs.remove(pgm2Str(firebase_rtdb_pgm_str_10 /* "/fb_bin_0.tmp" */), mb_fs_mem_storage_type_flash);
                         int sz = Core.mbfs.open(pgm2Str(firebase_rtdb_pgm_str_10 /* "/fb_bin_0.tmp" */),
@@ -2515,6 +4233,8 @@ skip:
 
     endDownload(fbdo, req, tcpHandler, response);
 
+    endJsonReader(fbdo, response);
+
     parsePayload(fbdo, req, response, payload);
 
     handleNoContent(fbdo, response);
@@ -2523,6 +4243,25 @@ skip:
            (fbdo->session.con_mode == firebase_con_mode_rtdb_stream && fbdo->session.response.code == FIREBASE_ERROR_HTTP_CODE_UNDEFINED);
 }
 
+void FB_RTDB::endJsonReader(FirebaseData *fbdo, struct server_response_data_t &response)
+{
+    FirebaseJsonStreamReader *reader = fbdo->session.rtdb.json_reader;
+
+    if (!reader || response.isEvent || response.httpCode != FIREBASE_ERROR_HTTP_CODE_OK ||
+        (response.dataType != d_json && response.dataType != d_array))
+        return;
+
+    // the payload was consumed by reader, no raw data and no hash for this response
+    fbdo->session.rtdb.raw.clear();
+    fbdo->session.rtdb.data_available = false;
+
+    if (!reader->end() && fbdo->session.response.code == FIREBASE_ERROR_HTTP_CODE_OK)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_INVALID_JSON_DATA;
+        Core.errorToString(fbdo->session.response.code, fbdo->session.error);
+    }
+}
+
 void FB_RTDB::trimEndJson(MB_String &payload)
 {
     size_t p = 0;
@@ -2664,6 +4403,7 @@ void FB_RTDB::endDownload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req,
     else if (fbdo->session.rtdb.resp_data_type == d_file)
     {
         // to make sure the file was closed
+        firebase_mutex_guard guard(Core.internal.file_mutex);
         Core.mbfs.close(mbfs_type fbdo->session.rtdb.storage_type);
         fbdo->session.rtdb.raw.clear();
     }
@@ -2752,118 +4492,267 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
     if (!fbdo->streamAvailable())
         return;
 
-    // to allow other subsequence request which can be occurred in the user stream
-    // callback
-    Core.internal.fb_processing = false;
+    fbdo->session.rtdb.data_type_str = fbdo->getDataType(fbdo->session.rtdb.resp_data_type);
 
+    // the event is delivered by the worker
+    if (fbdo->session.rtdb.stream_queue.slots.size() > 0)
+    {
+        pushStreamEvent(fbdo);
+        fbdo->session.rtdb.data_available = false;
+        return;
+    }
+
+    if (fbdo->session.rtdb.resp_data_type == d_blob && !fbdo->session.rtdb.blob)
+    {
+        fbdo->session.rtdb.isBlobPtr = true;
+        fbdo->session.rtdb.blob = new MB_VECTOR<uint8_t>();
+    }
+
+    if (fbdo->_dataAvailableCallback)
+        fbdo->initJson();
+    else if (!fbdo->session.jsonPtr)
+        fbdo->session.jsonPtr = new FirebaseJson();
+
+    fillStreamInfo(fbdo, fbdo->session.rtdb.stream);
+    fbdo->session.rtdb.stream.blob = fbdo->session.rtdb.blob;
+
+    deliverStreamEvent(fbdo, &fbdo->session.rtdb.stream, fbdo->session.jsonPtr, fbdo->session.arrPtr);
+    fbdo->session.rtdb.data_available = false;
+}
+
+void FB_RTDB::fillStreamInfo(FirebaseData *fbdo, struct firebase_stream_info_t &info)
+{
+    info.stream_path = fbdo->session.rtdb.stream_path;
+    info.path = fbdo->session.rtdb.path;
+    info.data = fbdo->session.rtdb.raw;
+    info.data_type = fbdo->session.rtdb.resp_data_type;
+    info.data_type_str = fbdo->session.rtdb.data_type_str;
+    info.event_type_str = fbdo->session.rtdb.event_type;
+    info.payload_length = fbdo->session.payload_length;
+    info.max_payload_length = fbdo->session.max_payload_length;
+}
+
+void FB_RTDB::deliverStreamEvent(FirebaseData *fbdo, struct firebase_stream_info_t *info, FirebaseJson *json, FirebaseJsonArray *arr)
+{
     if (fbdo->_dataAvailableCallback)
     {
         FIREBASE_STREAM_CLASS s;
-        s.begin(&fbdo->session.rtdb.stream);
+        s.begin(info);
 
-        fbdo->initJson();
+        if (info->data_type == d_json)
+        {
+            json->setJsonData(info->data.c_str());
+            arr->clear();
+        }
+
+        if (info->data_type == d_array)
+        {
+            arr->setJsonArrayData(info->data.c_str());
+            json->clear();
+        }
+
+        s.jsonPtr = json;
+        s.arrPtr = arr;
+
+        fbdo->_dataAvailableCallback(s);
+
+        s.empty();
+    }
+    else if (fbdo->_multiPathDataCallback)
+    {
+        FIREBASE_MP_STREAM_CLASS s;
+        s.begin(info);
+
+        if (info->data_type == d_json)
+        {
+            json->setJsonData(info->data.c_str());
+            info->m_json = json;
+        }
+        else
+            json->clear();
+
+        fbdo->_multiPathDataCallback(s);
+        s.empty();
+    }
+}
+
+void FB_RTDB::swapStreamEvent(struct firebase_rtdb_stream_event_t &a, struct firebase_rtdb_stream_event_t &b)
+{
+    a.info.stream_path.swap(b.info.stream_path);
+    a.info.path.swap(b.info.path);
+    a.info.data.swap(b.info.data);
+    a.info.data_type_str.swap(b.info.data_type_str);
+    a.info.event_type_str.swap(b.info.event_type_str);
+
+    uint8_t type = a.info.data_type;
+    a.info.data_type = b.info.data_type;
+    b.info.data_type = type;
+
+    size_t len = a.info.payload_length;
+    a.info.payload_length = b.info.payload_length;
+    b.info.payload_length = len;
+
+    len = a.info.max_payload_length;
+    a.info.max_payload_length = b.info.max_payload_length;
+    b.info.max_payload_length = len;
+
+    a.blob.swap(b.blob);
+    a.info.blob = &a.blob;
+    b.info.blob = &b.blob;
+}
+
+size_t FB_RTDB::coalesceStreamEvents(struct firebase_rtdb_stream_queue_t &q, const MB_String &path)
+{
+    size_t size = q.slots.size(), kept = 0;
+    bool root = path.length() == 0 || strcmp_P(path.c_str(), firebase_pgm_str_1 /* "/" */) == 0;
 
-        if (fbdo->session.rtdb.resp_data_type == d_json)
+    // the events of the path and its children were replaced by the put event,
+    // move the remaining events to the front in order
+    for (size_t i = 0; i < q.count; i++)
+    {
+        firebase_rtdb_stream_event_t &e = q.slots[(q.head + i) % size];
+        const MB_String &p = e.info.path;
+
+        if (root || (strncmp(p.c_str(), path.c_str(), path.length()) == 0 &&
+                     (p.length() == path.length() || p[path.length()] == '/')))
+            continue;
+
+        if (kept != i)
+            swapStreamEvent(q.slots[(q.head + kept) % size], e);
+        kept++;
+    }
+
+    size_t removed = q.count - kept;
+    q.count = kept;
+    q.coalesced += removed;
+    return removed;
+}
+
+bool FB_RTDB::pushStreamEvent(FirebaseData *fbdo)
+{
+    firebase_rtdb_stream_queue_t &q = fbdo->session.rtdb.stream_queue;
+
+    q.mutex.lock();
+
+    size_t size = q.slots.size();
+
+    if (q.count == size && q.policy == firebase_rtdb_stream_queue_policy_block)
+    {
+        unsigned long ms = millis();
+        while (q.count == size && millis() - ms < FIREBASE_STREAM_QUEUE_BLOCK_TIMEOUT)
         {
-            fbdo->session.jsonPtr->setJsonData(fbdo->session.rtdb.raw.c_str());
-            fbdo->session.arrPtr->clear();
+            q.mutex.unlock();
+
+            // the callback of the oldest event is called here when no worker,
+            // sleep to let the lower priority worker run
+            if (streamWorkerRunning())
+                delay(1);
+            else
+                processStreamQueue(fbdo, 1);
+
+            q.mutex.lock();
         }
 
-        if (fbdo->session.rtdb.resp_data_type == d_array)
+        if (q.count == size)
         {
-            fbdo->session.arrPtr->setJsonArrayData(fbdo->session.rtdb.raw.c_str());
-            fbdo->session.jsonPtr->clear();
+            q.dropped++;
+            q.mutex.unlock();
+            return false;
         }
+    }
+    else if (q.count == size && q.policy == firebase_rtdb_stream_queue_policy_coalesce &&
+             strcmp_P(fbdo->session.rtdb.event_type.c_str(), firebase_pgm_str_16 /* "put" */) == 0)
+        coalesceStreamEvents(q, fbdo->session.rtdb.path);
 
-        s.jsonPtr = fbdo->session.jsonPtr;
-        s.arrPtr = fbdo->session.arrPtr;
+    if (q.count == size)
+    {
+        q.head = (q.head + 1) % size;
+        q.count--;
+        q.dropped++;
+    }
 
-        s.sif->stream_path = fbdo->session.rtdb.stream_path.c_str();
-        s.sif->data = fbdo->session.rtdb.raw.c_str();
-        s.sif->path = fbdo->session.rtdb.path.c_str();
-        s.sif->payload_length = fbdo->session.payload_length;
-        s.sif->max_payload_length = fbdo->session.max_payload_length;
+    firebase_rtdb_stream_event_t &e = q.slots[(q.head + q.count) % size];
+    fillStreamInfo(fbdo, e.info);
 
-        s.sif->data_type = fbdo->session.rtdb.resp_data_type;
-        fbdo->session.rtdb.data_type_str = fbdo->getDataType(s.sif->data_type);
-        s.sif->data_type_str = fbdo->session.rtdb.data_type_str.c_str();
-        s.sif->event_type_str = fbdo->session.rtdb.event_type.c_str();
+    e.blob.clear();
+    if (e.info.data_type == d_blob && fbdo->session.rtdb.blob)
+        e.blob = *fbdo->session.rtdb.blob;
+    e.info.blob = &e.blob;
 
-        if (fbdo->session.rtdb.resp_data_type == d_blob)
-        {
-            if (!fbdo->session.rtdb.blob)
-            {
-                fbdo->session.rtdb.isBlobPtr = true;
-                fbdo->session.rtdb.blob = new MB_VECTOR<uint8_t>();
-            }
-            s.sif->blob = fbdo->session.rtdb.blob;
-        }
+    q.count++;
+    q.mutex.unlock();
 
-        fbdo->_dataAvailableCallback(s);
-        fbdo->session.rtdb.data_available = false;
+#if defined(ESP32)
+    if (!Core.internal.stream_worker_task_handle)
+        runStreamWorkerTask();
 
-        s.empty();
-    }
-    else if (fbdo->_multiPathDataCallback)
-    {
-        FIREBASE_MP_STREAM_CLASS s;
-        s.begin(&fbdo->session.rtdb.stream);
-        s.sif->data_type = fbdo->session.rtdb.resp_data_type;
-        s.sif->path = fbdo->session.rtdb.path;
-        s.sif->data_type_str = fbdo->getDataType(s.sif->data_type);
-        s.sif->event_type_str = fbdo->session.rtdb.event_type;
-        s.sif->payload_length = fbdo->session.payload_length;
-        s.sif->max_payload_length = fbdo->session.max_payload_length;
-
-        if (!fbdo->session.jsonPtr)
-            fbdo->session.jsonPtr = new FirebaseJson();
-
-        if (fbdo->session.rtdb.resp_data_type == d_json)
-            fbdo->session.jsonPtr->setJsonData(fbdo->session.rtdb.raw.c_str());
-
-        if (s.sif->data_type == d_json)
-            s.sif->m_json = fbdo->session.jsonPtr;
-        else
-        {
-            fbdo->session.jsonPtr->clear();
-            s.sif->data = fbdo->session.rtdb.raw.c_str();
-        }
+    if (Core.internal.stream_worker_task_handle)
+        xTaskNotifyGive(Core.internal.stream_worker_task_handle);
+#endif
 
-        fbdo->_multiPathDataCallback(s);
-        fbdo->session.rtdb.data_available = false;
-        s.empty();
-    }
+    return true;
 }
 
-void FB_RTDB::splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload)
+void FB_RTDB::processStreamQueue(FirebaseData *fbdo, size_t max)
 {
-    int ofs = 0;
-    int pos1 = 0, pos2 = 0, pos3 = 0;
+    firebase_rtdb_stream_queue_t &q = fbdo->session.rtdb.stream_queue;
+
+    firebase_mutex_guard guard(q.worker);
+
+    if (!q.json)
+        q.json = new FirebaseJson();
+
+    if (!q.arr)
+        q.arr = new FirebaseJsonArray();
 
-    while (pos1 > -1)
+    for (size_t n = 0; max == 0 || n < max; n++)
     {
-        if (Core.sh.find(payloads, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos1))
-        {
-            ofs = pos1 + 1;
-            if (Core.sh.find(payloads, firebase_rtdb_pgm_str_13 /* "data: " */, false, ofs, pos2))
-            {
-                ofs = pos2 + 1;
-                if (Core.sh.find(payloads, firebase_pgm_str_12 /* "\n" */, false, ofs, pos3))
-                    ofs = pos3 + 1;
-                else
-                    pos3 = payloads.length();
+        q.mutex.lock();
 
-                payload.push_back(payloads.substr(pos1, pos3 - pos1));
-            }
+        if (q.count == 0)
+        {
+            q.mutex.unlock();
+            break;
         }
+
+        swapStreamEvent(q.current, q.slots[q.head]);
+        q.head = (q.head + 1) % q.slots.size();
+        q.count--;
+
+        q.mutex.unlock();
+
+        deliverStreamEvent(fbdo, &q.current.info, q.json, q.arr);
     }
 }
 
-void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
+bool FB_RTDB::streamWorkerRunning()
+{
+#if defined(ESP32)
+    return Core.internal.stream_worker_task_handle != NULL;
+#else
+    return false;
+#endif
+}
+
+void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload, const struct firebase_sse_event_t &event)
 {
     struct server_response_data_t response;
 
-    Core.hh.parseRespPayload(&Core.sh, payload, response, false);
+    // copy only the event fields, the data type is checked in place
+    response.isEvent = true;
+    response.hasEventData = true;
+    payload.substr(response.eventType, event.type.ofs, event.type.len);
+    response.payloadOfs = event.data.ofs;
+    response.payloadLen = event.data.len;
+    response.dataHash = event.hash;
+
+    if (event.hasPath)
+    {
+        payload.substr(response.eventPath, event.path.ofs, event.path.len);
+        payload.substr(response.eventData, event.data.ofs, event.data.len);
+    }
+
+    Core.hh.parseRespDataType(&Core.sh, payload, response.payloadOfs, response, false);
 
     fbdo->session.rtdb.resp_data_type = response.dataType;
     fbdo->session.content_length = response.payloadLen;
@@ -2881,10 +4770,13 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
         }
 
         fbdo->session.rtdb.raw.clear();
-        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, payload.c_str() + response.payloadOfs, *fbdo->session.rtdb.blob);
+        MB_String blob;
+        payload.substr(blob, response.payloadOfs, response.payloadLen);
+        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, blob, *fbdo->session.rtdb.blob);
     }
     else if (fbdo->session.rtdb.resp_data_type == d_file)
     {
+        firebase_mutex_guard guard(Core.internal.file_mutex);
         Core.mbfs.close(mbfs_type fbdo->session.rtdb.storage_type);
         fbdo->session.rtdb.raw.clear();
     }
@@ -2892,6 +4784,9 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
     if (Core.sh.compare(response.eventType, 0, firebase_pgm_str_16 /* "put" */) ||
         Core.sh.compare(response.eventType, 0, firebase_pgm_str_17 /* "patch" */))
     {
+        if (event.hasPath && !replica.empty())
+            replica.apply(toAddr(*fbdo), response.eventType, response.eventPath,
+                          payload.c_str() + event.data.ofs, event.data.len);
 
         handlePayload(fbdo, response, payload);
 
@@ -2926,6 +4821,7 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
                  Core.sh.compare(response.eventType, 0, firebase_rtdb_pgm_str_15 /* "auth_revoked" */))
         {
             fbdo->session.rtdb.event_type = response.eventType;
+            replica.invalidate(toAddr(*fbdo));
             // make stream available status
             fbdo->session.rtdb.stream_data_changed = true;
             fbdo->session.rtdb.data_available = true;
@@ -2946,35 +4842,22 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
         // stream data?
         if (response.isEvent)
         {
-            int pos = 0, ofs = 0, jsonCount = 0;
+            int ofs = 0;
             bool validJson = false;
+            struct firebase_sse_event_t event;
 
-            // counting the occurences of JSON sets
-            while (pos > -1)
-            {
-                if (Core.sh.find(payload, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos))
-                {
-                    ofs = pos + 1;
-                    jsonCount++;
-                }
-            }
-
-            // we need to spit the tream data if stream data contains multiple sets of JSON
+            // the stream data may contain multiple events
             // that happens in case simultaneously children data changes.
-            // {json1}{json..}{json n}
-            // Then we pase each JSON and send to callback function.
-            MB_VECTOR<MB_String> payloadList;
-            splitStreamPayload(payload, payloadList);
-            for (size_t i = 0; i < payloadList.size(); i++)
+            // Then we parse each event in place and send to callback function.
+            while (Core.hh.parseSSE(payload.c_str(), payload.length(), ofs, event))
             {
-                if (Core.ut.validJS(payloadList[i].c_str()))
+                if (event.valid)
                 {
                     validJson = true;
-                    parseStreamPayload(fbdo, payloadList[i].c_str());
+                    parseStreamPayload(fbdo, payload, event);
                     sendCB(fbdo);
                 }
             }
-            payloadList.clear(); // clear payload after splitting
             payload.clear();
 
             if (validJson)
@@ -3014,6 +4897,11 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
                 {
                     handlePayload(fbdo, response, payload.c_str());
 
+                    // the evicted child of the replica is filled by the network get
+                    if (req->method == http_get && req->data.address.query == 0 && !replica.empty() &&
+                        fbdo->session.response.code == FIREBASE_ERROR_HTTP_CODE_OK)
+                        replica.fill(req->path, payload);
+
                     if (fbdo->session.rtdb.priority_val_flag)
                         fbdo->session.rtdb.path =
                             fbdo->session.rtdb.path.substr(0, fbdo->session.rtdb.path.length() -
@@ -3032,34 +4920,133 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
                 }
             }
 
-            // mismatch data type check
-            if (Core.config->rtdb.data_type_stricted && req->method == http_get &&
-                req->data.type != d_timestamp &&
-                !response.noContent && response.httpCode < 400)
-            {
-                bool _reqType = req->data.type == d_integer ||
-                                req->data.type == d_float ||
-                                req->data.type == d_double;
-                bool _respType = fbdo->session.rtdb.resp_data_type == d_integer ||
-                                 fbdo->session.rtdb.resp_data_type == d_float ||
-                                 fbdo->session.rtdb.resp_data_type == d_double;
-
-                if (req->data.type == fbdo->session.rtdb.resp_data_type ||
-                    (_reqType && _respType) ||
-                    (fbdo->session.rtdb.priority > 0 && fbdo->session.rtdb.resp_data_type == d_json))
-                    fbdo->session.rtdb.data_mismatch = false;
-                else if (req->data.type != d_any)
-                {
-                    fbdo->session.rtdb.data_mismatch = true;
-                    fbdo->session.response.code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
-                }
-            }
+            checkDataType(fbdo, req, response);
         }
     }
 
     payload.clear();
 }
 
+void FB_RTDB::checkDataType(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct server_response_data_t &response)
+{
+    // mismatch data type check
+    if (Core.config->rtdb.data_type_stricted && req->method == http_get &&
+        req->data.type != d_timestamp &&
+        !response.noContent && response.httpCode < 400)
+    {
+        bool _reqType = req->data.type == d_integer ||
+                        req->data.type == d_float ||
+                        req->data.type == d_double;
+        bool _respType = fbdo->session.rtdb.resp_data_type == d_integer ||
+                         fbdo->session.rtdb.resp_data_type == d_float ||
+                         fbdo->session.rtdb.resp_data_type == d_double;
+
+        if (req->data.type == fbdo->session.rtdb.resp_data_type ||
+            (_reqType && _respType) ||
+            (fbdo->session.rtdb.priority > 0 && fbdo->session.rtdb.resp_data_type == d_json))
+            fbdo->session.rtdb.data_mismatch = false;
+        else if (req->data.type != d_any)
+        {
+            fbdo->session.rtdb.data_mismatch = true;
+            fbdo->session.response.code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
+        }
+    }
+}
+
+bool FB_RTDB::readReplica(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    if (req->method != http_get || req->data.address.query > 0 || req->data.etag.length() > 0 ||
+        req->data.type == d_blob || req->data.type == d_file || req->data.type == d_file_ota || replica.empty())
+        return false;
+
+    MB_String payload;
+
+    if (!replica.read(req->path, payload))
+        return false;
+
+    struct server_response_data_t response;
+    Core.hh.parseRespDataType(&Core.sh, payload, 0, response, false);
+
+    // the blob and file data are read from the server
+    if (response.dataType == d_blob || response.dataType == d_file)
+        return false;
+
+    response.httpCode = FIREBASE_ERROR_HTTP_CODE_OK;
+    response.payloadLen = payload.length();
+    // the replica JSON was re-serialized and does not hash as the server payload does,
+    // keep the hash of last server data to not report the false data change
+    response.dataHash = fbdo->session.rtdb.data_hash;
+
+    fbdo->session.response.code = FIREBASE_ERROR_HTTP_CODE_OK;
+    fbdo->session.rtdb.req_method = req->method;
+    fbdo->session.rtdb.req_data_type = req->data.type;
+    fbdo->session.rtdb.data_mismatch = false;
+    fbdo->session.rtdb.path_not_found = false;
+    fbdo->session.rtdb.path = req->path;
+    fbdo->session.rtdb.resp_data_type = response.dataType;
+    fbdo->session.content_length = response.payloadLen;
+
+    handlePayload(fbdo, response, payload);
+    checkDataType(fbdo, req, response);
+
+    fbdo->session.rtdb.data_available = fbdo->session.rtdb.raw.length() > 0;
+
+    return true;
+}
+
+void FB_RTDB::writeReplica(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    bool patch = req->method == http_patch || req->method == rtdb_update_nocontent;
+
+    if (!patch && req->method != http_put && req->method != rtdb_set_nocontent && req->method != http_post &&
+        req->method != http_delete && req->method != rtdb_restore)
+        return;
+
+    if (replica.empty())
+        return;
+
+    MB_String path = req->path, payload;
+
+    // The async write result, blob, file and the restored data are not known, the written child is evicted.
+    bool known = !req->async && req->method != rtdb_restore && req->data.type != d_blob &&
+                 req->data.type != d_file && req->data.type != d_file_ota;
+
+    if (known && req->method == http_post)
+    {
+        // the pushed data is put at the push name
+        known = fbdo->session.rtdb.push_name.length() > 0;
+        path += firebase_pgm_str_1; // "/"
+        path += fbdo->session.rtdb.push_name;
+    }
+
+    if (known)
+    {
+        if (req->method == http_delete)
+            payload = firebase_pgm_str_59; // "null"
+        else if (req->data.address.din > 0 && req->data.type == d_json)
+        {
+            FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
+            if (json)
+                payload = json->raw();
+        }
+        else if (req->data.address.din > 0 && req->data.type == d_array)
+        {
+            FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(req->data.address.din);
+            if (arr)
+                payload = arr->raw();
+        }
+        else
+        {
+            payload = req->pre_payload;
+            payload += req->payload;
+            payload += req->post_payload;
+        }
+    }
+
+    replica.write(known ? path : req->path, patch, known && payload.length() > 0 ? payload.c_str() : nullptr,
+                  payload.length());
+}
+
 void FB_RTDB::handlePayload(FirebaseData *fbdo, struct server_response_data_t &response, const MB_String &payload)
 {
 
@@ -3083,9 +5070,9 @@ void FB_RTDB::handlePayload(FirebaseData *fbdo, struct server_response_data_t &r
         if (fbdo->session.rtdb.resp_data_type == d_string)
             fbdo->setRaw(true); // if double quotes string, trim it.
 
-        uint16_t crc = Core.ut.calCRC(&Core.mbfs, fbdo->session.rtdb.raw.c_str());
-        response.dataChanged = fbdo->session.rtdb.data_crc != crc;
-        fbdo->session.rtdb.data_crc = crc;
+        // the hash was computed while the payload chunks or event data were read
+        response.dataChanged = fbdo->session.rtdb.data_hash != response.dataHash;
+        fbdo->session.rtdb.data_hash = response.dataHash;
     }
 }
 
@@ -3155,36 +5142,46 @@ bool FB_RTDB::hasPayload(struct firebase_rtdb_request_info_t *req)
     return getHTTPMethod(req) == http_put || getHTTPMethod(req) == http_post || getHTTPMethod(req) == http_patch;
 }
 
-bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+uint16_t FB_RTDB::updateHostHeader()
 {
-    firebase_request_method http_method = getHTTPMethod(req);
-    fbdo->session.rtdb.shallow_flag = false;
-    fbdo->session.rtdb.priority_val_flag = false;
-
-    bool hasServerValue = false;
-
-    if (req->data.type == d_json)
+    // rebuild when the database URL or custom headers were changed
+    if (hostHeaderGen == 0 || hostHeaderURL != Core.config->database_url ||
+        hostHeaderCustom != Core.config->signer.customHeaders)
     {
-        int p;
-        if (req->data.address.din > 0 && req->data.type == d_json)
-            hasServerValue = Core.sh.find(addrTo<FirebaseJson *>(req->data.address.din)->raw(),
-                                          firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
-        else
-            hasServerValue = Core.sh.find(req->payload, firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
+        hostHeaderURL = Core.config->database_url;
+        hostHeaderCustom = Core.config->signer.customHeaders;
+        hostHeader.clear();
+        Core.hh.addHostHeader(hostHeader, Core.config->database_url.c_str());
+        Core.hh.addUAHeader(hostHeader);
+        Core.hh.getCustomHeaders(&Core.sh, hostHeader, Core.config->signer.customHeaders);
+        if (++hostHeaderGen == 0)
+            hostHeaderGen = 1;
     }
 
-    MB_String header;
+    return hostHeaderGen;
+}
+
+void FB_RTDB::buildHeaderTemplate(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req, firebase_request_method http_method,
+                                  struct firebase_rtdb_header_template_t &tmpl)
+{
+    tmpl.head.clear();
+    tmpl.mid.clear();
+    tmpl.tail.clear();
+    tmpl.auth = 0;
 
-    Core.hh.addRequestHeaderFirst(header, fbdo->session.classic_request &&
-                                                  (http_method == http_put || http_method == http_delete)
-                                              ? http_post
-                                              : http_method);
+    // the parts after the token are written to mid
+    MB_String *header = &tmpl.head;
 
-    Core.ut.makePath(req->path);
-    header += req->path;
+    Core.hh.addRequestHeaderFirst(*header, fbdo->session.classic_request &&
+                                                   (http_method == http_put || http_method == http_delete)
+                                               ? http_post
+                                               : http_method);
 
-    if (req->method == http_patch || req->method == rtdb_update_nocontent)
-        header += firebase_pgm_str_1; // "/"
+    *header += req->path;
+
+    if ((req->method == http_patch || req->method == rtdb_update_nocontent) &&
+        (req->path.length() == 0 || req->path[req->path.length() - 1] != '/'))
+        *header += firebase_pgm_str_1; // "/"
 
     bool appendAuth = false;
     bool hasQueryParams = false;
@@ -3201,167 +5198,302 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
 
     if (appendAuth)
     {
-        header += firebase_rtdb_pgm_str_18; // ".json"
-        if (Core.getTokenType() != token_type_oauth2_access_token && !Core.config->signer.test_mode)
-            Core.uh.addParam(header, firebase_rtdb_pgm_str_19 /* "auth=" */, "", hasQueryParams, true);
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        if (Core.getTokenType() != token_type_oauth2_access_token && !Core.config->signer.test_mode)
-            fbdo->tcpSend(Core.internal.auth_token.c_str());
-
-        if (fbdo->session.response.code < 0)
-            return false;
+        *header += firebase_rtdb_pgm_str_18; // ".json"
+        if (fbdo->session.rtdb.auth_secret.length() > 0 ||
+            (Core.getTokenType() != token_type_oauth2_access_token && !Core.config->signer.test_mode))
+        {
+            Core.uh.addParam(*header, firebase_rtdb_pgm_str_19 /* "auth=" */, "", hasQueryParams, true);
+            tmpl.auth = 1;
+            header = &tmpl.mid;
+        }
     }
 
     if (fbdo->session.rtdb.read_tmo > 0)
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_20 /* "timeout=" */,
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_20 /* "timeout=" */,
                          MB_String(fbdo->session.rtdb.read_tmo) + firebase_rtdb_pgm_str_21 /* "ms" */, hasQueryParams);
 
-    Core.uh.addParam(header, firebase_rtdb_pgm_str_22 /* "writeSizeLimit=" */,
+    Core.uh.addParam(*header, firebase_rtdb_pgm_str_22 /* "writeSizeLimit=" */,
                      fbdo->session.rtdb.write_limit, hasQueryParams);
 
     if (req->method == rtdb_get_shallow)
-    {
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_23 /* "shallow=true" */, "", hasQueryParams, true);
-        fbdo->session.rtdb.shallow_flag = true;
-    }
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_23 /* "shallow=true" */, "", hasQueryParams, true);
 
     QueryFilter *query = req->data.address.query > 0 ? addrTo<QueryFilter *>(req->data.address.query) : nullptr;
-    bool hasQuery = false;
     if (req->method == http_get && query && query->_orderBy.length() > 0)
     {
-        hasQuery = true;
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_24 /* "orderBy=" */, query->_orderBy, hasQueryParams);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_25 /* "&limitToFirst=" */, query->_limitToFirst, hasQueryParams);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_26 /* "&limitToLast=" */, query->_limitToLast, hasQueryParams);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_27 /* "&startAt=" */, query->_startAt, hasQueryParams);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_30 /* "&endAt=" */, query->_endAt, hasQueryParams);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_31 /* "&equalTo=" */, query->_equalTo, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_24 /* "orderBy=" */, query->_orderBy, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_25 /* "&limitToFirst=" */, query->_limitToFirst, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_26 /* "&limitToLast=" */, query->_limitToLast, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_27 /* "&startAt=" */, query->_startAt, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_30 /* "&endAt=" */, query->_endAt, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_31 /* "&equalTo=" */, query->_equalTo, hasQueryParams);
     }
 
     if (req->method == rtdb_backup)
     {
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_32 /* "format=export" */, "", hasQueryParams, true);
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_28 /* "download=" */, fbdo->session.rtdb.filename, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_32 /* "format=export" */, "", hasQueryParams, true);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_28 /* "download=" */, fbdo->session.rtdb.filename, hasQueryParams);
     }
 
     if (req->method == http_get && req->filename.length() > 0)
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_28 /* "download=" */, fbdo->session.rtdb.filename, hasQueryParams);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_28 /* "download=" */, fbdo->session.rtdb.filename, hasQueryParams);
 
     if (req->async || req->method == rtdb_get_nocontent ||
         req->method == rtdb_restore || req->method == rtdb_set_nocontent ||
         req->method == rtdb_update_nocontent)
-        Core.uh.addParam(header, firebase_rtdb_pgm_str_29 /* "print=silent" */, "", hasQueryParams, true);
+        Core.uh.addParam(*header, firebase_rtdb_pgm_str_29 /* "print=silent" */, "", hasQueryParams, true);
 
-    Core.hh.addRequestHeaderLast(header);
-    Core.hh.addHostHeader(header, Core.config->database_url.c_str());
-    Core.hh.addUAHeader(header);
-    Core.hh.getCustomHeaders(&Core.sh, header, Core.config->signer.customHeaders);
+    Core.hh.addRequestHeaderLast(*header);
+    *header += hostHeader;
 
-    if (Core.getTokenType() == token_type_oauth2_access_token)
+    if (tmpl.auth == 0 && Core.getTokenType() == token_type_oauth2_access_token)
     {
-        Core.hh.addAuthHeaderFirst(header, token_type_oauth2_access_token);
-
-        if (Core.config->signer.tokens.auth_type.length() > 0 &&
-            Core.config->signer.tokens.auth_type[Core.config->signer.tokens.auth_type.length() - 1] != ' ')
-            header += firebase_pgm_str_9; // " "
-
-        fbdo->tcpSend(header.c_str());
-        header.clear();
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        fbdo->tcpSend(Core.internal.auth_token.c_str());
-
-        if (fbdo->session.response.code < 0)
-            return false;
-
-        Core.hh.addNewLine(header);
+        Core.hh.addAuthHeaderFirst(*header, token_type_oauth2_access_token);
+        tmpl.auth = 2;
+        header = &tmpl.mid;
+        Core.hh.addNewLine(*header);
     }
 
-    // Timestamp cannot use with ETag header, due to internal server error
-    if (!hasServerValue && !hasQuery && req->data.type != d_timestamp &&
-        (req->method == http_delete || req->method == http_get ||
-         req->method == rtdb_get_nocontent || req->method == http_put ||
-         req->method == rtdb_set_nocontent || req->method == http_post))
-        header += firebase_rtdb_pgm_str_33; // "X-Firebase-ETag: true\r\n"
-
-    if (fbdo->session.rtdb.req_etag.length() > 0 &&
-        (req->method == http_put || req->method == rtdb_set_nocontent || req->method == http_delete))
-    {
-        header += firebase_rtdb_pgm_str_34; // "if-match: "
-        header += fbdo->session.rtdb.req_etag;
-        Core.hh.addNewLine(header);
-    }
+    // the remaining headers depend on the request method only
+    header = &tmpl.tail;
 
     if (fbdo->session.classic_request && http_method != http_get && http_method != http_post && http_method != http_patch)
     {
-        header += firebase_rtdb_pgm_str_36; // "X-HTTP-Method-Override: "
+        *header += firebase_rtdb_pgm_str_36; // "X-HTTP-Method-Override: "
         if (http_method == http_put || http_method == http_delete)
-            Core.hh.addRequestHeaderFirst(header, http_method);
-        Core.hh.addNewLine(header);
+            Core.hh.addRequestHeaderFirst(*header, http_method);
+        Core.hh.addNewLine(*header);
     }
 
     if (req->method == rtdb_stream)
     {
-        fbdo->session.rtdb.http_req_conn_type = firebase_http_connection_type_keep_alive;
-        Core.hh.addConnectionHeader(header, false);
-        header += firebase_rtdb_pgm_str_35; //  "Accept: text/event-stream\r\n"
+        Core.hh.addConnectionHeader(*header, false);
+        *header += firebase_rtdb_pgm_str_35; //  "Accept: text/event-stream\r\n"
     }
     else
     {
-        // required for ESP32 core sdk v2.0.x.
-        fbdo->session.rtdb.http_req_conn_type = firebase_http_connection_type_keep_alive;
         bool keepAlive = false;
 #if defined(USE_CONNECTION_KEEP_ALIVE_MODE)
         keepAlive = true;
 #endif
-        Core.hh.addConnectionHeader(header, keepAlive);
-        header += firebase_rtdb_pgm_str_37; // "Keep-Alive: timeout=30, max=100\r\n"
+        Core.hh.addConnectionHeader(*header, keepAlive);
+        *header += firebase_rtdb_pgm_str_37; // "Keep-Alive: timeout=30, max=100\r\n"
     }
 
     if (req->method != rtdb_backup && req->method != rtdb_restore)
-        header += firebase_rtdb_pgm_str_38; // "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n"
+        *header += firebase_rtdb_pgm_str_38; // "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n"
+}
+
+bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    firebase_request_method http_method = getHTTPMethod(req);
+    fbdo->session.rtdb.shallow_flag = req->method == rtdb_get_shallow;
+    fbdo->session.rtdb.priority_val_flag = req->method == rtdb_get_priority || req->method == rtdb_set_priority;
+    // required for ESP32 core sdk v2.0.x.
+    fbdo->session.rtdb.http_req_conn_type = firebase_http_connection_type_keep_alive;
+
+    Core.ut.makePath(req->path);
+
+    QueryFilter *query = req->data.address.query > 0 ? addrTo<QueryFilter *>(req->data.address.query) : nullptr;
+    bool hasQuery = req->method == http_get && query && query->_orderBy.length() > 0;
+
+    // Timestamp cannot use with ETag header, due to internal server error
+    bool addETag = !hasQuery && req->data.type != d_timestamp &&
+                   (req->method == http_delete || req->method == http_get ||
+                    req->method == rtdb_get_nocontent || req->method == http_put ||
+                    req->method == rtdb_set_nocontent || req->method == http_post);
+
+    // the server value in payload also cannot use with ETag header
+    if (addETag && req->data.type == d_json)
+    {
+        int p;
+        if (req->data.address.din > 0)
+            addETag = !Core.sh.find(addrTo<FirebaseJson *>(req->data.address.din)->raw(),
+                                    firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
+        else
+            addETag = !Core.sh.find(req->payload, firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
+    }
+
+    bool secret = fbdo->session.rtdb.auth_secret.length() > 0;
+    uint8_t auth = secret ? 1 : (Core.getTokenType() == token_type_oauth2_access_token ? 2 : (Core.config->signer.test_mode ? 0 : 1));
+
+    // the requests with query, redirection, file name or database secret are not kept
+    bool reusable = !hasQuery && !secret && fbdo->session.rtdb.redirect_url.length() == 0 && req->filename.length() == 0 &&
+                    req->method != rtdb_backup && req->method != rtdb_restore && req->method != rtdb_stream;
+
+    struct firebase_rtdb_header_template_t *tmpl = &fbdo->session.rtdb.header_tmpl;
+    struct firebase_rtdb_header_template_t once;
+
+    // the shared Host header can't be rebuilt by other task while it is copied to the template
+    hostHeaderMutex.lock();
+    uint16_t gen = updateHostHeader();
+
+    if (!reusable)
+    {
+        tmpl = &once;
+        buildHeaderTemplate(fbdo, req, http_method, *tmpl);
+    }
+    else if (tmpl->gen != gen || tmpl->auth != auth || tmpl->method != req->method || tmpl->async != req->async ||
+             tmpl->classic != fbdo->session.classic_request || tmpl->read_tmo != fbdo->session.rtdb.read_tmo ||
+             tmpl->path != req->path || tmpl->write_limit != fbdo->session.rtdb.write_limit)
+    {
+        buildHeaderTemplate(fbdo, req, http_method, *tmpl);
+        tmpl->gen = gen;
+        tmpl->method = req->method;
+        tmpl->async = req->async;
+        tmpl->classic = fbdo->session.classic_request;
+        tmpl->read_tmo = fbdo->session.rtdb.read_tmo;
+        tmpl->path = req->path;
+        tmpl->write_limit = fbdo->session.rtdb.write_limit;
+    }
+
+    hostHeaderMutex.unlock();
+
+    size_t len = tmpl->head.length() + tmpl->mid.length() + tmpl->tail.length() + 64;
+    if (tmpl->auth > 0)
+        len += (secret ? fbdo->session.rtdb.auth_secret.length() : Core.tokenLength()) + 1;
+    if (fbdo->session.rtdb.req_etag.length() > 0)
+        len += fbdo->session.rtdb.req_etag.length() + 12;
+
+    MB_String header;
+    header.reserve(len);
+    header = tmpl->head;
+
+    if (tmpl->auth > 0)
+    {
+        if (tmpl->auth == 2 && Core.config->signer.tokens.auth_type.length() > 0 &&
+            Core.config->signer.tokens.auth_type[Core.config->signer.tokens.auth_type.length() - 1] != ' ')
+            header += firebase_pgm_str_9; // " "
+        if (secret)
+            header += fbdo->session.rtdb.auth_secret;
+        else
+            Core.appendAuthToken(header);
+    }
+
+    header += tmpl->mid;
+    header += tmpl->tail;
+
+    if (addETag)
+        header += firebase_rtdb_pgm_str_33; // "X-Firebase-ETag: true\r\n"
 
-    if (req->method == rtdb_get_priority || req->method == rtdb_set_priority)
-        fbdo->session.rtdb.priority_val_flag = true;
+    if (fbdo->session.rtdb.req_etag.length() > 0 &&
+        (req->method == http_put || req->method == rtdb_set_nocontent || req->method == http_delete))
+    {
+        header += firebase_rtdb_pgm_str_34; // "if-match: "
+        header += fbdo->session.rtdb.req_etag;
+        Core.hh.addNewLine(header);
+    }
 
     if (hasPayload(req))
         Core.hh.addContentLengthHeader(header, getPayloadLen(req));
 
     Core.hh.addNewLine(header);
 
+    // the whole header in one write
     fbdo->tcpSend(header.c_str());
-    header.clear();
 
-    if (fbdo->session.response.code < 0)
-        return false;
+    return fbdo->session.response.code >= 0;
+}
 
-    return true;
+void FB_RTDB::setStreamReplica(FirebaseData *fbdo, bool enable)
+{
+    if (enable)
+        replica.add(toAddr(*fbdo), fbdo->session.rtdb.stream_path);
+    else
+        replica.remove(toAddr(*fbdo));
 }
 
-void FB_RTDB::removeStreamCallback(FirebaseData *fbdo)
+void FB_RTDB::setReplicaMaxSize(size_t size)
 {
-    fbdo->setSession(true, false);
+    replica.setMaxSize(size);
+}
 
-    fbdo->_dataAvailableCallback = NULL;
-    fbdo->_timeoutCallback = NULL;
+void FB_RTDB::setStreamQueue(FirebaseData *fbdo, size_t size, firebase_rtdb_stream_queue_policy policy)
+{
+    firebase_rtdb_stream_queue_t &q = fbdo->session.rtdb.stream_queue;
+
+    // the stream reading and the event delivering are paused while the slots are changed
+    firebase_mutex_guard guard(fbdo->session.mutex);
+    firebase_mutex_guard worker(q.worker);
+    firebase_mutex_guard lock(q.mutex);
+
+    q.slots.clear();
+    q.slots.resize(size);
+    for (size_t i = 0; i < size; i++)
+        q.slots[i].info.blob = &q.slots[i].blob;
+
+    q.head = 0;
+    q.count = 0;
+    q.policy = policy;
+    q.dropped = 0;
+    q.coalesced = 0;
+
+#if defined(ESP32)
+    if (size > 0)
+        runStreamWorkerTask();
+#endif
+}
 
-    if (Core.internal.sessions.size() == 0)
-    {
 #if defined(ESP32)
-        if (Core.internal.stream_task_handle)
-            vTaskDelete(Core.internal.stream_task_handle);
+void FB_RTDB::setStreamWorkerTask(size_t stackSize, uint8_t priority, uint8_t cpuCore)
+{
+    Core.internal.stream_worker_task_stack_size = stackSize;
+    Core.internal.stream_worker_task_priority = priority;
+    Core.internal.stream_worker_task_cpu_core = cpuCore;
+}
 
-        Core.internal.stream_task_handle = NULL;
+void FB_RTDB::runStreamWorkerTask()
+{
+    static FB_RTDB *_this = this;
+
+    firebase_mutex_guard guard(Core.internal.session_mutex);
+    if (Core.internal.stream_worker_task_handle)
+        return;
+
+    TaskFunction_t taskCode = [](void *param)
+    {
+        for (;;)
+        {
+            // wake up by the new event
+            ulTaskNotifyTake(pdTRUE, FIREBASE_STREAM_IDLE_CHECK_INTERVAL / portTICK_PERIOD_MS);
+
+            Core.internal.session_mutex.lock();
+            if (!Core.internal.stream_loop_task_enable || Core.internal.sessions.size() == 0)
+            {
+                Core.internal.stream_worker_task_handle = NULL;
+                Core.internal.session_mutex.unlock();
+                break;
+            }
+            Core.internal.session_mutex.unlock();
+
+            for (size_t id = 0; id < Core.internal.sessions.size(); id++)
+            {
+                FirebaseData *fbdo = FirebaseData::lockSession(Core.internal.sessions, id, true);
+                if (fbdo)
+                {
+                    _this->processStreamQueue(fbdo);
+                    fbdo->unlockSession(true);
+                }
+            }
+        }
+
+        vTaskDelete(NULL);
+    };
+
+    xTaskCreatePinnedToCore(taskCode, "Stream_Worker", Core.internal.stream_worker_task_stack_size,
+                            NULL, Core.internal.stream_worker_task_priority,
+                            &Core.internal.stream_worker_task_handle,
+                            Core.internal.stream_worker_task_cpu_core);
+}
 #endif
-    }
+
+void FB_RTDB::removeStreamCallback(FirebaseData *fbdo)
+{
+    // the stream task exits by itself when no session left
+    fbdo->setSession(true, false);
+
+    fbdo->_dataAvailableCallback = NULL;
+    fbdo->_timeoutCallback = NULL;
 }
 
 void FB_RTDB::clearDataStatus(FirebaseData *fbdo)
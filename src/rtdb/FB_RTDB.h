@@ -38,6 +38,8 @@
 #include "./FB_Utils.h"
 #include "./session/FB_Session.h"
 #include "QueueInfo.h"
+#include "RTDBBatch.h"
+#include "RTDBReplica.h"
 #include "./stream/FB_MP_Stream.h"
 #include "./stream/FB_Stream.h"
 
@@ -55,13 +57,15 @@ class FB_RTDB
   friend class FIREBASE_CLASS;
 
 #if defined(ENABLE_ERROR_QUEUE) || defined(FIREBASE_ENABLE_ERROR_QUEUE)
-#if !defined(ESP32) && !defined(ESP8266) && !defined(MB_ARDUINO_PICO)
+#if !defined(ESP32) && !defined(ESP8266) && !defined(MB_ARDUINO_PICO) && !defined(FIREBASE_HOST_MUTEX)
 #undef ENABLE_ERROR_QUEUE
 #undef FIREBASE_ENABLE_ERROR_QUEUE
 #endif
 #endif
 
 public:
+  typedef RTDBBatch Batch;
+
   FB_RTDB();
   ~FB_RTDB();
 
@@ -1586,6 +1590,42 @@ public:
                         _IS_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
   }
 
+  /** Write all path and value pairs in the batch at once (multi-location update).
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param batch The pointer to FB_RTDB::Batch (RTDBBatch) object that holds the items to write.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The items are sent as one PATCH request at the database root with print=silent,
+   * no payload will be returned from the server.
+   *
+   * Call [Batch object].result(index) or [Batch object].success(index) to get the result of each item.
+   */
+  bool commitBatch(FirebaseData *fbdo, Batch *batch) { return mCommitBatch(fbdo, batch, _NO_ASYNC); }
+
+  bool commitBatchAsync(FirebaseData *fbdo, Batch *batch) { return mCommitBatch(fbdo, batch, _IS_ASYNC); }
+
+  /** Read the available responses of pipelined async requests without blocking.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Boolean value, indicates the connection is still usable.
+   *
+   * @note The result of each completed request is reported via the callback function
+   * assigned by FirebaseData::setAsyncResultCallback.
+   * This should be called in loop when the pipelining was enabled with FirebaseData::setPipelining.
+   */
+  bool processPipeline(FirebaseData *fbdo);
+
+  /** Wait for the responses of all pipelined async requests.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Boolean value, indicates all in-flight requests were answered by the server.
+   *
+   * @note The wait time is limited by config.timeout.serverResponse since the last received response data.
+   * The requests that were not answered are reported with error code via the result callback.
+   */
+  bool flushPipeline(FirebaseData *fbdo);
+
   /** Read generic type of value at the defined node.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -1909,6 +1949,38 @@ public:
                         _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
   }
 
+  /** Read (get) the JSON at the defined node and parse it incrementally with FirebaseJsonStreamReader.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param reader The pointer to FirebaseJsonStreamReader that was assigned with the callback.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The response payload is fed to the reader as it is read from the network and is not kept
+   * in [FirebaseData object], the memory usage does not depend on the size of the node.
+   *
+   * The reader callback will be called for every object, array and value in the JSON payload.
+   */
+  template <typename T = const char *>
+  bool getJSON(FirebaseData *fbdo, T path, FirebaseJsonStreamReader *reader)
+  {
+    return mGetJSONStream(fbdo, toStringPtr(path), d_json, _NO_QUERY, reader);
+  }
+
+  /** Read (get) the JSON at the defined node with query and parse it incrementally with FirebaseJsonStreamReader.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param query QueryFilter class to set query parameters to filter data.
+   * @param reader The pointer to FirebaseJsonStreamReader that was assigned with the callback.
+   * @return Boolean value, indicates the success of the operation.
+   */
+  template <typename T = const char *>
+  bool getJSON(FirebaseData *fbdo, T path, QueryFilter *query, FirebaseJsonStreamReader *reader)
+  {
+    return mGetJSONStream(fbdo, toStringPtr(path), d_json, getAddr(query), reader);
+  }
+
   /** Read (get) the array at the defined node.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2006,6 +2078,36 @@ public:
                         _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
   }
 
+  /** Read (get) the array at the defined node and parse it incrementally with FirebaseJsonStreamReader.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param reader The pointer to FirebaseJsonStreamReader that was assigned with the callback.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The response payload is fed to the reader as it is read from the network and is not kept
+   * in [FirebaseData object].
+   */
+  template <typename T = const char *>
+  bool getArray(FirebaseData *fbdo, T path, FirebaseJsonStreamReader *reader)
+  {
+    return mGetJSONStream(fbdo, toStringPtr(path), d_array, _NO_QUERY, reader);
+  }
+
+  /** Read (get) the array at the defined node with query and parse it incrementally with FirebaseJsonStreamReader.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param query QueryFilter class to set query parameters to filter data.
+   * @param reader The pointer to FirebaseJsonStreamReader that was assigned with the callback.
+   * @return Boolean value, indicates the success of the operation.
+   */
+  template <typename T = const char *>
+  bool getArray(FirebaseData *fbdo, T path, QueryFilter *query, FirebaseJsonStreamReader *reader)
+  {
+    return mGetJSONStream(fbdo, toStringPtr(path), d_array, getAddr(query), reader);
+  }
+
   /** Read (get) the blob (binary data) at the defined node.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2086,6 +2188,71 @@ public:
                         _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE), mem_storage_type_undefined, callback);
   }
 
+  /** Upload the file from storage memory as the chunked file at the defined node.
+   *
+   * The file is split into the fixed size chunks which each chunk is stored as the base64 string
+   * at <nodePath>/chunks/<index> and the file size, chunk size, chunk count, CRC32 and SHA-256 are stored
+   * at <nodePath>/manifest.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+   * @param nodePath The path to the node that the chunked file will be stored.
+   * @param fileName  The file path includes its name.
+   * @param callback Optional. The callback function that accept RTDB_UploadStatusInfo data.
+   * @param chunkSize Optional. The binary bytes per chunk.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The node content will be replaced when the upload starts.
+   *
+   * When the manifest of the same file (size, chunk size and CRC) exists at the node from the
+   * interrupted upload, only the missing chunks will be uploaded.
+   */
+  template <typename T1 = const char *, typename T2 = const char *>
+  bool setFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, T1 nodePath, T2 fileName,
+                     RTDB_UploadProgressCallback callback = NULL, size_t chunkSize = FIREBASE_RTDB_FILE_CHUNK_SIZE)
+  {
+    return mSetFileChunks(fbdo, storageType, toStringPtr(nodePath), toStringPtr(fileName), chunkSize, callback);
+  }
+
+  /** Download the chunked file at the defined node and save to storage memory.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+   * @param nodePath The path to the node that the chunked file was stored using setFileChunks.
+   * @param fileName  The file path includes its name.
+   * @param callback Optional. The callback function that accept RTDB_DownloadStatusInfo data.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The chunks are downloaded in order and the file CRC32 and SHA-256 are verified with the manifest.
+   *
+   * The failed chunk download is retried after reconnection, FIREBASE_RTDB_FILE_CHUNK_RETRY times.
+   * When the download was interrupted, the written offset and the running hash are saved to <fileName>.ckp
+   * and the next download of the same file continues from that offset.
+   */
+  template <typename T1 = const char *, typename T2 = const char *>
+  bool getFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, T1 nodePath,
+                     T2 fileName, RTDB_DownloadProgressCallback callback = NULL)
+  {
+    return mGetFileChunks(fbdo, storageType, toStringPtr(nodePath), toStringPtr(fileName), false, callback);
+  }
+
+  /** Download a firmware file that was stored as the chunked file from the database.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param fwPath  The path to the node that the firmware was stored using setFileChunks.
+   * @param callback Optional. The callback function that accept RTDB_DownloadStatusInfo data.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The failed chunk download is retried after reconnection, FIREBASE_RTDB_FILE_CHUNK_RETRY times,
+   * without restarting the update. The update will not be ended when the firmware size, CRC32 or SHA-256
+   * does not match the manifest.
+   */
+  template <typename T = const char *>
+  bool downloadOTAChunks(FirebaseData *fbdo, T fwPath, RTDB_DownloadProgressCallback callback = NULL)
+  {
+    return mGetFileChunks(fbdo, mem_storage_type_undefined, toStringPtr(fwPath), toStringPtr(_NO_FILE), true, callback);
+  }
+
   /** Delete all child nodes at the defined node.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2123,11 +2290,14 @@ public:
    * @param fbdo The pointer to Firebase Data Object.
    * @param path The parent path of children nodes that is being deleted.
    * @param timestampNode The sub-child node that keep the timestamp.
-   * @param limit The maximum number of children nodes to delete at once, 30 is maximum.
+   * @param limit The maximum number of children nodes to delete in this call.
    * @param dataRetentionPeriod The period in seconds of data in the past which will be retained.
    * @return Boolean value, indicates the success of the operation.
    *
-   * @note The databaseSecret can be empty if the auth type is OAuth2.0 or legacy and required if auth type
+   * @note The expired nodes are queried in pages of up to 30 nodes and all nodes of each page
+   * are deleted at once with one multi-path update request.
+   *
+   * The databaseSecret can be empty if the auth type is OAuth2.0 or legacy and required if auth type
    * is Email/Password sign-in.
    */
   template <typename T1 = const char *, typename T2 = const char *, typename T3 = size_t, typename T4 = unsigned long>
@@ -2180,6 +2350,66 @@ public:
    */
   bool endStream(FirebaseData *fbdo);
 
+  /** Enable or disable the local replica of the stream data.
+   *
+   * The put and patch events of the stream are applied to the local copy of the stream path data
+   * and the get requests of any Firebase Data object under that path are served from the replica
+   * without the network request while the stream is connected.
+   *
+   * @param fbdo The pointer to Firebase Data Object that used for stream.
+   * @param enable The boolean value to enable the replica.
+   *
+   * @note This should be called before beginStream, the replica is available after the stream received
+   * the data of the stream path.
+   *
+   * The get requests with query, ETag, blob and file are always sent to the server.
+   *
+   * The replica should be disabled before the Firebase Data Object is deleted.
+   */
+  void setStreamReplica(FirebaseData *fbdo, bool enable);
+
+  /** Set the maximum memory size of all stream replicas.
+   *
+   * The least recently read children of the stream paths are removed from the replicas when the size
+   * exceeds the limit, and they are served from the server until the next get of the child node.
+   *
+   * @param size The size in bytes, the default size is FIREBASE_RTDB_REPLICA_MAX_SIZE.
+   */
+  void setReplicaMaxSize(size_t size);
+
+  /** Set the stream event queue which decouples the stream callback from the stream reading.
+   *
+   * The stream events are copied to the pre-allocated slots of the queue and delivered to the stream
+   * callback by the worker task (ESP32) or after the stream sessions were read (other devices),
+   * the slow callback does not delay the socket reading, keep-alive handling and other streams.
+   *
+   * @param fbdo The pointer to Firebase Data Object that used for stream.
+   * @param size The number of event slots, 0 to disable the queue and call the stream callback directly.
+   * @param policy The policy when the queue is full.
+   * firebase_rtdb_stream_queue_policy_drop_oldest, the oldest event is removed (default).
+   * firebase_rtdb_stream_queue_policy_coalesce, the queued events of the put event path and its children
+   * are removed as they were replaced by the new event, or the oldest event when none.
+   * firebase_rtdb_stream_queue_policy_block, the stream reading waits for the free slot up to
+   * FIREBASE_STREAM_QUEUE_BLOCK_TIMEOUT.
+   *
+   * @note The queue depth and the number of dropped and coalesced events can be read from
+   * FirebaseData.streamQueueDepth, FirebaseData.streamQueueDropped and FirebaseData.streamQueueCoalesced.
+   */
+  void setStreamQueue(FirebaseData *fbdo, size_t size,
+                      firebase_rtdb_stream_queue_policy policy = firebase_rtdb_stream_queue_policy_drop_oldest);
+
+#if defined(ESP32)
+  /** Set the stream event queue worker task.
+   *
+   * @param stackSize The task reserved stack memory in byte (8192 is default).
+   * @param priority The task priority (2 is default), it should be lower than the stream task priority.
+   * @param cpuCore The CPU core that runs the task (1 is default).
+   *
+   * @note This should be called before setStreamQueue.
+   */
+  void setStreamWorkerTask(size_t stackSize, uint8_t priority, uint8_t cpuCore);
+#endif
+
   /** Set the stream callback functions.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2317,6 +2547,9 @@ public:
    *
    * The Firebase read (get) operation will not save.
    *
+   * The queues are saved as the binary records with CRC32, after the file was saved, the later added
+   * and removed queues are appended to this file as the small records instead of rewriting the whole file.
+   *
    * @param fbdo The pointer to Firebase Data Object.
    * @param filename Filename to be saved.
    * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
@@ -2339,6 +2572,10 @@ public:
   }
 
   /** Restore the Firebase Error Queues from the queue file (flash memory).
+   *
+   * The records after the incomplete or corrupted record (e.g. from the power loss while writing) are ignored.
+   * The JSON queue file that saved from the previous library version can be restored and it will be
+   * rewritten in the binary format.
    *
    * @param fbdo The pointer to Firebase Data Object.
    * @param filename Filename to be read and restore queues.
@@ -2445,6 +2682,43 @@ public:
    */
   void clearErrorQueue(FirebaseData *fbdo);
 
+  /** Start the persistent offline journal which the failed and offline writes are kept in.
+   *
+   * The writes are appended to the segment files <filename>.0, <filename>.1,... and they are replayed
+   * in the order that they were written by processErrorQueue (or the error queue auto run process)
+   * when the network is available. The replayed writes are marked in the journal and the remaining writes
+   * are replayed after restart when this function was called with the same filename and sizes.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param filename The base name of segment files.
+   * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+   * @param maxSize The maximum size in bytes of all segment files, the oldest segment is removed when the journal is full.
+   * @param segmentSize The size in bytes of each segment file.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The get, blob and priority writes are kept in the Error Queue collection (RAM) because their data are the
+   * references to the user variables.
+   */
+  template <typename T = const char *>
+  bool beginOfflineJournal(FirebaseData *fbdo, T filename, firebase_mem_storage_type storageType,
+                           size_t maxSize = FIREBASE_RTDB_JOURNAL_MAX_SIZE, size_t segmentSize = FIREBASE_RTDB_JOURNAL_SEGMENT_SIZE)
+  {
+    return mBeginOfflineJournal(fbdo, toStringPtr(filename), storageType, maxSize, segmentSize);
+  }
+
+  /** Stop using the offline journal, the segment files are kept in the storage.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   */
+  void endOfflineJournal(FirebaseData *fbdo);
+
+  /** Get the number of writes in the offline journal that were not replayed.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of writes.
+   */
+  size_t offlineJournalCount(FirebaseData *fbdo);
+
 #endif
 
   template <typename T1 = const char *, typename T2>
@@ -2596,10 +2870,14 @@ private:
   void clearDataStatus(FirebaseData *fbdo);
   bool handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  bool mSendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   int preRequestCheck(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   firebase_request_method getHTTPMethod(firebase_rtdb_request_info_t *req);
   bool hasPayload(struct firebase_rtdb_request_info_t *req);
   bool sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  void buildHeaderTemplate(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req, firebase_request_method http_method,
+                           struct firebase_rtdb_header_template_t &tmpl);
+  uint16_t updateHostHeader();
   int getPayloadLen(firebase_rtdb_request_info_t *req);
   bool waitResponse(FirebaseData *fbdo, firebase_rtdb_request_info_t *req);
   bool handleResponse(FirebaseData *fbdo, firebase_rtdb_request_info_t *req);
@@ -2608,6 +2886,9 @@ private:
   void parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct server_response_data_t &response,
                     MB_String payload);
   void handlePayload(FirebaseData *fbdo, struct server_response_data_t &response, const MB_String &payload);
+  void checkDataType(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct server_response_data_t &response);
+  bool readReplica(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  void writeReplica(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool processRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_String &filePath,
                           firebase_mem_storage_type storageType, struct firebase_rtdb_request_info_t *req);
@@ -2624,8 +2905,28 @@ private:
   bool mPathExisted(FirebaseData *fbdo, MB_StringPtr path);
   String mGetETag(FirebaseData *fbdo, MB_StringPtr path);
   bool mGetShallowData(FirebaseData *fbdo, MB_StringPtr path);
+  bool mCommitBatch(FirebaseData *fbdo, Batch *batch, bool async);
+  int readPipeline(FirebaseData *fbdo);
+  bool waitPipeline(FirebaseData *fbdo, size_t limit);
+  void completePipeline(FirebaseData *fbdo);
   bool mDeleteNodesByTimestamp(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr timestampNode,
                                MB_StringPtr limit, MB_StringPtr dataRetentionPeriod);
+  bool mSetFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr nodePath,
+                      MB_StringPtr fileName, size_t chunkSize, RTDB_UploadProgressCallback callback);
+  bool mGetFileChunks(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr nodePath,
+                      MB_StringPtr fileName, bool ota, RTDB_DownloadProgressCallback callback);
+  bool readFileManifest(FirebaseData *fbdo, const MB_String &path, struct firebase_rtdb_file_manifest_t &manifest);
+  int readFileChunk(const MB_String &fileName, firebase_mem_storage_type storageType, size_t offset, uint8_t *buf,
+                    size_t len);
+  bool writeFileChunk(const MB_String &fileName, firebase_mem_storage_type storageType, uint8_t *buf, size_t len,
+                      bool append);
+  void sha256Hex(const br_sha256_context &sha, MB_String &out);
+  bool loadChunksCheckpoint(const MB_String &fileName, firebase_mem_storage_type storageType,
+                            const struct firebase_rtdb_file_manifest_t &manifest, size_t &offset,
+                            uint32_t &crc, br_sha256_context &sha);
+  bool saveChunksCheckpoint(const MB_String &fileName, firebase_mem_storage_type storageType,
+                            const struct firebase_rtdb_file_manifest_t &manifest, size_t offset,
+                            uint32_t crc, const br_sha256_context &sha);
   bool mBeginMultiPathStream(FirebaseData *fbdo, MB_StringPtr parentPath);
   bool mBackup(FirebaseData *fbdo, firebase_mem_storage_type storageType, MB_StringPtr nodePath,
                MB_StringPtr fileName, RTDB_DownloadProgressCallback callback = NULL);
@@ -2643,6 +2944,9 @@ private:
   bool connectionError(FirebaseData *fbdo);
   bool handleStreamRead(FirebaseData *fbdo);
   bool exitStream(FirebaseData *fbdo, bool status);
+  bool mGetJSONStream(FirebaseData *fbdo, MB_StringPtr path, firebase_data_type type, uint32_t query_addr,
+                      FirebaseJsonStreamReader *reader);
+  void endJsonReader(FirebaseData *fbdo, struct server_response_data_t &response);
   void trimEndJson(MB_String &payload);
   void readBase64FileChunk(FirebaseData *fbdo, MB_String &payload, struct firebase_tcp_response_handler_t &tcpHandler,
                            struct server_response_data_t &response, int chunkSize, bool &streamDataComplete);
@@ -2658,13 +2962,24 @@ private:
   int handleRedirect(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct firebase_tcp_response_handler_t &tcpHandler,
                      struct server_response_data_t &response);
   void sendCB(FirebaseData *fbdo);
-  void splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload);
-  void parseStreamPayload(FirebaseData *fbdo, const MB_String &payload);
-  void storeToken(MB_String &atok, const char *databaseSecret);
-  void restoreToken(MB_String &atok, firebase_auth_token_type tk);
+  void fillStreamInfo(FirebaseData *fbdo, struct firebase_stream_info_t &info);
+  void deliverStreamEvent(FirebaseData *fbdo, struct firebase_stream_info_t *info, FirebaseJson *json, FirebaseJsonArray *arr);
+  void swapStreamEvent(struct firebase_rtdb_stream_event_t &a, struct firebase_rtdb_stream_event_t &b);
+  size_t coalesceStreamEvents(struct firebase_rtdb_stream_queue_t &q, const MB_String &path);
+  bool pushStreamEvent(FirebaseData *fbdo);
+  void processStreamQueue(FirebaseData *fbdo, size_t max = 0);
+  bool streamWorkerRunning();
+#if defined(ESP32)
+  void runStreamWorkerTask();
+#endif
+  void parseStreamPayload(FirebaseData *fbdo, const MB_String &payload, const struct firebase_sse_event_t &event);
+  void storeToken(FirebaseData *fbdo, const char *databaseSecret);
+  void restoreToken(FirebaseData *fbdo);
   bool mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr node, MB_StringPtr databaseSecret);
   bool mBeginStream(FirebaseData *fbdo, MB_StringPtr path);
   void mSetReadTimeout(FirebaseData *fbdo, MB_StringPtr millisec);
+  size_t nextUploadChunk(FirebaseData *fbdo, struct firebase_rtdb_upload_rate_t &rate);
+  void updateUploadRate(struct firebase_rtdb_upload_rate_t &rate, size_t len, unsigned long ms);
   void reportUploadProgress(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req, size_t readBytes);
   void reportDownloadProgress(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req, size_t readBytes);
   void makeUploadStatus(RTDB_UploadStatusInfo &info, const MB_String &local, const MB_String &remote,
@@ -2678,6 +2993,9 @@ private:
   void runStreamTask();
   void mStopStreamLoopTask();
   void mRunStream();
+#if defined(ESP32) || defined(FIREBASE_HOST_STREAM_TASK)
+  void waitStream(uint32_t pollDelay);
+#endif
 
 #if defined(ENABLE_ERROR_QUEUE) || defined(FIREBASE_ENABLE_ERROR_QUEUE)
 
@@ -2694,9 +3012,34 @@ private:
 #if defined(MBFS_ESP32_SDFAT_ENABLED)
   uint8_t readQueueFileSdFat(FirebaseData *fbdo, MBFS_SD_FILE &file, QueueItem &item, uint8_t mode);
 #endif
+  uint8_t readQueueRecords(FirebaseData *fbdo, firebase_mem_storage_type storageType, int size, uint8_t mode);
+  int readQueueRecord(firebase_mem_storage_type storageType, int pos, int size, MB_VECTOR<uint8_t> &buf);
+  void encodeQueueRecord(MB_VECTOR<uint8_t> &out, const QueueItem &item, uint8_t op);
+  bool decodeQueueRecord(const uint8_t *buf, size_t len, QueueItem &item, uint8_t &op);
+  void putQueueValue(MB_VECTOR<uint8_t> &out, uint32_t value);
+  uint32_t getQueueValue(const uint8_t *buf, size_t &pos);
+  void appendQueueRecord(FirebaseData *fbdo, const QueueItem &item, uint8_t op);
+  bool flushQueueRecords(FirebaseData *fbdo);
+  bool mBeginOfflineJournal(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType,
+                            size_t maxSize, size_t segmentSize);
+  void journalSegmentName(FirebaseData *fbdo, uint32_t seq, MB_String &name);
+  bool readJournalSegment(FirebaseData *fbdo, const MB_String &name, firebase_rtdb_journal_segment_t &seg);
+  bool writeJournal(FirebaseData *fbdo, QueueItem &item);
+  void dropJournalSegment(FirebaseData *fbdo);
+  void processOfflineJournal(FirebaseData *fbdo, FirebaseData::QueueInfoCallback callback);
 
 #endif
 
+  // The local copies of the stream paths data
+  RTDBReplica replica;
+
+  // The Host, User-Agent and custom headers which are the same for all requests
+  MB_String hostHeader;
+  MB_String hostHeaderURL;
+  MB_String hostHeaderCustom;
+  uint16_t hostHeaderGen = 0;
+  firebase_mutex hostHeaderMutex;
+
 protected:
   int getPrec(bool dbl)
   {
@@ -74,11 +74,22 @@ String QueueInfo::dataPath()
     return _path.c_str();
 }
 
+int QueueInfo::httpCode()
+{
+    return _httpCode;
+}
+
+String QueueInfo::errorReason()
+{
+    return _errorReason.c_str();
+}
+
 void QueueInfo::clear()
 {
     _dataType.clear();
     _method.clear();
     _path.clear();
+    _errorReason.clear();
 }
 
 #endif
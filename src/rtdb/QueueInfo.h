@@ -75,6 +75,8 @@ public:
     String dataType();
     String firebaseMethod();
     String dataPath();
+    int httpCode();
+    String errorReason();
 
 private:
     void clear();
@@ -82,9 +84,11 @@ private:
     uint32_t _currentQueueID = 0;
     bool _isQueueFull = false;
     bool _isQueue = false;
+    int _httpCode = 0;
     MB_String _dataType;
     MB_String _method;
     MB_String _path;
+    MB_String _errorReason;
 };
 
 #endif
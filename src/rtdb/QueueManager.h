@@ -53,6 +53,29 @@ private:
     void clear();
     MB_VECTOR<struct QueueItem> *_queueCollection = nullptr;
     uint8_t _maxQueue = 10;
+
+    // The queue file that the added and removed queues are appended to after it was saved or restored,
+    // the records are held in _pending while the storage is used by other file.
+    MB_String _file;
+    uint8_t _storageType = 0;
+    MB_VECTOR<uint8_t> _pending;
+
+    // The offline journal, see FB_RTDB::beginOfflineJournal.
+    MB_String _journal;
+    uint8_t _journalStorageType = 0;
+    uint8_t _journalSegments = 0;
+    size_t _journalSegmentSize = 0;
+    // the sequence numbers of the oldest segment and the segment that the records are appended to
+    uint32_t _journalHead = 0;
+    uint32_t _journalTail = 0;
+    // 0 when the file of tail segment was not created
+    size_t _journalTailSize = 0;
+    // the position of the next record to replay in the oldest segment
+    size_t _journalReadPos = 8;
+    // the sequence numbers of the next record and the last replayed record
+    uint32_t _journalSeq = 1;
+    uint32_t _journalDone = 0;
+    size_t _journalCount = 0;
 };
 
 #endif
@@ -0,0 +1,245 @@
+/**
+ * Google's Firebase RTDBBatch class, RTDBBatch.cpp version 1.0.0
+ *
+ * Created October 17, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_BATCH_CPP
+#define FIREBASE_RTDB_BATCH_CPP
+
+#include "RTDBBatch.h"
+
+RTDBBatch::RTDBBatch()
+{
+}
+
+RTDBBatch::~RTDBBatch()
+{
+    clear();
+}
+
+RTDBBatch &RTDBBatch::clear()
+{
+    items.clear();
+    return *this;
+}
+
+const char *RTDBBatch::path(size_t index) const
+{
+    if (index < items.size())
+        return items[index].path.c_str();
+    return "";
+}
+
+int RTDBBatch::result(size_t index) const
+{
+    if (index < items.size())
+        return items[index].code;
+    return 0;
+}
+
+bool RTDBBatch::success(size_t index) const
+{
+    int code = result(index);
+    return code == FIREBASE_ERROR_HTTP_CODE_OK || code == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT;
+}
+
+String RTDBBatch::payload()
+{
+    MB_String buf;
+    makePayload(buf);
+    return buf.c_str();
+}
+
+RTDBBatch &RTDBBatch::mSet(MB_StringPtr path, MB_StringPtr value, firebase_data_type type)
+{
+    MB_String _path = path, _value;
+
+    if (type == d_string)
+    {
+        MB_String s = value;
+        _value += firebase_pgm_str_4; // "\""
+        escape(_value, s);
+        _value += firebase_pgm_str_4; // "\""
+    }
+    else if (type == d_timestamp)
+        _value = firebase_rtdb_pgm_str_39; // "{\".sv\": \"timestamp\"}"
+    else if (type == d_null)
+        _value = firebase_pgm_str_59; // "null"
+    else
+    {
+        _value = value;
+        // empty FirebaseJson or FirebaseJsonArray
+        if (_value.length() == 0)
+            return *this;
+    }
+
+    return addItem(_path, _value);
+}
+
+RTDBBatch &RTDBBatch::mSetBlob(MB_StringPtr path, uint8_t *blob, size_t size)
+{
+    if (!blob)
+        return *this;
+
+    MB_String _path = path;
+    MB_String _value = firebase_rtdb_pgm_str_7; // "\"blob,base64,"
+    _value += Core.bh.encodeToString(&Core.mbfs, blob, size);
+    _value += firebase_pgm_str_4; // "\""
+
+    return addItem(_path, _value);
+}
+
+RTDBBatch &RTDBBatch::addItem(MB_String &path, MB_String &value)
+{
+    // The keys in multi-path update are relative to the root without the leading and trailing slashes.
+    while (path.length() > 0 && path[0] == '/')
+        path.erase(0, 1);
+    while (path.length() > 0 && path[path.length() - 1] == '/')
+        path.pop_back();
+
+    // The later value of the same path replaces the earlier one.
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (items[i].path == path)
+        {
+            items[i].value = value;
+            items[i].code = 0;
+            return *this;
+        }
+    }
+
+    item_t item;
+    item.path = path;
+    item.value = value;
+    items.push_back(item);
+    return *this;
+}
+
+void RTDBBatch::escape(MB_String &out, const MB_String &in)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char *p = in.c_str();
+    size_t start = 0, i = 0;
+
+    for (; p[i]; i++)
+    {
+        unsigned char c = p[i];
+        if (c != '"' && c != '\\' && c >= 0x20)
+            continue;
+
+        out.append(p + start, i - start);
+        out += '\\';
+
+        if (c == '"' || c == '\\')
+            out += (char)c;
+        else if (c == '\n')
+            out += 'n';
+        else if (c == '\r')
+            out += 'r';
+        else if (c == '\t')
+            out += 't';
+        else
+        {
+            out += 'u';
+            out += '0';
+            out += '0';
+            out += hex[c >> 4];
+            out += hex[c & 0x0f];
+        }
+        start = i + 1;
+    }
+
+    out.append(p + start, i - start);
+}
+
+bool RTDBBatch::validate()
+{
+    bool valid = true;
+
+    for (size_t i = 0; i < items.size(); i++)
+        items[i].code = 0;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const MB_String &path = items[i].path;
+
+        // the root itself and the keys contain . $ # [ ] are not allowed
+        bool ok = path.length() > 0 && !strpbrk(path.c_str(), (const char *)MBSTRING_FLASH_MCR(".$#[]"));
+
+        // the server rejects the update when a path is the ancestor of the other path
+        for (size_t j = 0; ok && j < items.size(); j++)
+        {
+            const MB_String &other = items[j].path;
+            if (j != i && other.length() > path.length() && other[path.length()] == '/' &&
+                strncmp(other.c_str(), path.c_str(), path.length()) == 0)
+                ok = false;
+        }
+
+        if (!ok)
+        {
+            items[i].code = FIREBASE_ERROR_INVALID_BATCH_PATH;
+            valid = false;
+        }
+    }
+
+    return valid;
+}
+
+void RTDBBatch::makePayload(MB_String &buf)
+{
+    size_t len = 2;
+    for (size_t i = 0; i < items.size(); i++)
+        len += items[i].path.length() + items[i].value.length() + 4;
+
+    buf.reserve(len);
+    buf = firebase_pgm_str_10; // "{"
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (i > 0)
+            buf += firebase_pgm_str_3; // ","
+        buf += firebase_pgm_str_4;     // "\""
+        escape(buf, items[i].path);
+        buf += firebase_pgm_str_4; // "\""
+        buf += firebase_pgm_str_2; // ":"
+        buf += items[i].value;
+    }
+
+    buf += firebase_pgm_str_11; // "}"
+}
+
+void RTDBBatch::setResult(int code)
+{
+    for (size_t i = 0; i < items.size(); i++)
+        items[i].code = code;
+}
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,190 @@
+/**
+ * Google's Firebase RTDBBatch class, RTDBBatch.h version 1.0.0
+ *
+ * Created October 17, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_BATCH_H
+#define FIREBASE_RTDB_BATCH_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+#include "./core/FirebaseCore.h"
+
+using namespace mb_string;
+
+/** The multi-location (multi-path) update builder.
+ *
+ * All collected path and value pairs are sent as one PATCH request at the database root
+ * with print=silent which they are written atomically, all of them succeed or all of them fail.
+ */
+class RTDBBatch
+{
+    friend class FB_RTDB;
+
+public:
+    RTDBBatch();
+    ~RTDBBatch();
+
+    /** Add the integer, boolean, float or double value to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @param value The value to write.
+     * @return The reference to this batch.
+     */
+    template <typename T1 = const char *, typename T2 = int>
+    auto set(T1 path, T2 value) -> typename enable_if<is_string<T1>::value && (is_num_int<T2>::value || is_bool<T2>::value ||
+                                                                               is_same<T2, float>::value || is_same<T2, double>::value),
+                                                      RTDBBatch &>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value, -1), d_any);
+    }
+
+    /** Add the string value to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @param value The string to write.
+     * @return The reference to this batch.
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    auto set(T1 path, T2 value) -> typename enable_if<is_string<T1>::value && is_string<T2>::value, RTDBBatch &>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value), d_string);
+    }
+
+    /** Add the FirebaseJson object to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @param json The pointer to FirebaseJson object.
+     * @return The reference to this batch.
+     */
+    template <typename T = const char *>
+    RTDBBatch &set(T path, FirebaseJson *json)
+    {
+        return mSet(toStringPtr(path), toStringPtr(json ? json->raw() : _NO_PAYLOAD), d_json);
+    }
+
+    /** Add the FirebaseJsonArray object to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @param arr The pointer to FirebaseJsonArray object.
+     * @return The reference to this batch.
+     */
+    template <typename T = const char *>
+    RTDBBatch &set(T path, FirebaseJsonArray *arr)
+    {
+        return mSet(toStringPtr(path), toStringPtr(arr ? arr->raw() : _NO_PAYLOAD), d_array);
+    }
+
+    /** Add the blob (binary data) to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @param blob The byte array of data.
+     * @param size The size of data in bytes.
+     * @return The reference to this batch.
+     */
+    template <typename T = const char *>
+    RTDBBatch &setBlob(T path, uint8_t *blob, size_t size) { return mSetBlob(toStringPtr(path), blob, size); }
+
+    /** Add the server timestamp to write to the defined path.
+     *
+     * @param path The node path relative to the database root.
+     * @return The reference to this batch.
+     */
+    template <typename T = const char *>
+    RTDBBatch &setTimestamp(T path) { return mSet(toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_timestamp); }
+
+    /** Add the node to delete.
+     *
+     * @param path The node path relative to the database root.
+     * @return The reference to this batch.
+     */
+    template <typename T = const char *>
+    RTDBBatch &remove(T path) { return mSet(toStringPtr(path), toStringPtr(_NO_PAYLOAD), d_null); }
+
+    /** Remove all items and their results.
+     */
+    RTDBBatch &clear();
+
+    /** Get the number of items in the batch.
+     *
+     * @return The number of items.
+     */
+    size_t size() const { return items.size(); }
+
+    /** Get the path of item.
+     *
+     * @param index The item index.
+     * @return The path string.
+     */
+    const char *path(size_t index) const;
+
+    /** Get the result of item from the last commit.
+     *
+     * @param index The item index.
+     * @return The HTTP status code or negative error code, 0 when the item was not committed.
+     *
+     * @note FIREBASE_ERROR_INVALID_BATCH_PATH will be set to the item that has the invalid path
+     * or its path is the ancestor of other item's path, the batch will not be sent in this case.
+     */
+    int result(size_t index) const;
+
+    /** Check whether the item was written in the last commit.
+     *
+     * @param index The item index.
+     * @return Boolean value, indicates the success of the item.
+     */
+    bool success(size_t index) const;
+
+    /** Get the multi-path payload of the batch.
+     *
+     * @return The JSON string of the payload.
+     */
+    String payload();
+
+private:
+    struct item_t
+    {
+        MB_String path;
+        MB_String value;
+        int code = 0;
+    };
+
+    MB_VECTOR<item_t> items;
+
+    RTDBBatch &mSet(MB_StringPtr path, MB_StringPtr value, firebase_data_type type);
+    RTDBBatch &mSetBlob(MB_StringPtr path, uint8_t *blob, size_t size);
+    RTDBBatch &addItem(MB_String &path, MB_String &value);
+    void escape(MB_String &out, const MB_String &in);
+    bool validate();
+    void makePayload(MB_String &buf);
+    void setResult(int code);
+};
+
+#endif
+
+#endif // ENABLE
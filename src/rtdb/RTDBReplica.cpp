@@ -0,0 +1,629 @@
+/**
+ * Google's Firebase RTDBReplica class, RTDBReplica.cpp version 1.0.0
+ *
+ * Created October 17, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_REPLICA_CPP
+#define FIREBASE_RTDB_REPLICA_CPP
+
+#include "RTDBReplica.h"
+
+RTDBReplica::RTDBReplica()
+{
+}
+
+RTDBReplica::~RTDBReplica()
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+        reset(nodes[i]);
+    nodes.clear();
+}
+
+void RTDBReplica::add(uint32_t owner, const MB_String &path)
+{
+    firebase_mutex_guard guard(mutex);
+
+    if (find(owner))
+        return;
+
+    node_t node;
+    node.owner = owner;
+    node.path = path;
+    nodes.push_back(node);
+}
+
+void RTDBReplica::remove(uint32_t owner)
+{
+    firebase_mutex_guard guard(mutex);
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].owner == owner)
+        {
+            reset(nodes[i]);
+            nodes.erase(nodes.begin() + i);
+            break;
+        }
+    }
+}
+
+void RTDBReplica::begin(uint32_t owner, const MB_String &path)
+{
+    firebase_mutex_guard guard(mutex);
+
+    node_t *node = find(owner);
+    if (!node)
+        return;
+
+    // wait for the full data of the new stream connection
+    reset(*node);
+    node->path = path;
+}
+
+void RTDBReplica::invalidate(uint32_t owner)
+{
+    firebase_mutex_guard guard(mutex);
+
+    node_t *node = find(owner);
+    if (node)
+        reset(*node);
+}
+
+void RTDBReplica::apply(uint32_t owner, const MB_String &event, const MB_String &path, const char *data, size_t len)
+{
+    firebase_mutex_guard guard(mutex);
+
+    node_t *node = find(owner);
+    if (!node)
+        return;
+
+    MB_JSON *item = MB_JSON_ParseWithLength(data, len);
+    if (!item)
+    {
+        reset(*node);
+        return;
+    }
+
+    MB_VECTOR<MB_String> keys;
+    splitPath(path, keys);
+
+    bool patch = strcmp_P(event.c_str(), firebase_pgm_str_17 /* "patch" */) == 0;
+
+    if (!patch && keys.size() == 0)
+    {
+        // the full data of the stream path
+        reset(*node);
+        node->root = item;
+        node->synced = true;
+    }
+    else if (!node->synced)
+        MB_JSON_Delete(item);
+    else if (!patch)
+    {
+        if (!putItem(*node, keys, item))
+            reset(*node);
+    }
+    else
+    {
+        // each child of the patch data replaces the child at the event path
+        bool ret = true;
+        MB_JSON *child = nullptr;
+        while (ret && item->child && (child = MB_JSON_DetachItemViaPointer(item, item->child)) != nullptr)
+        {
+            keys.push_back(MB_String(child->string ? child->string : ""));
+            ret = putItem(*node, keys, child);
+            keys.pop_back();
+        }
+        MB_JSON_Delete(item);
+
+        if (!ret)
+            reset(*node);
+    }
+
+    update(*node);
+}
+
+void RTDBReplica::write(const MB_String &path, bool patch, const char *data, size_t len)
+{
+    firebase_mutex_guard guard(mutex);
+
+    if (nodes.size() == 0)
+        return;
+
+    MB_JSON *item = data ? MB_JSON_ParseWithLength(data, len) : nullptr;
+
+    // the server values and the unparsable data are not known until the server sends them
+    if (!item || !strip(item))
+        putPath(path, nullptr);
+    else if (!patch)
+        putPath(path, item);
+    else
+    {
+        // each child of the patch data is the put at its (multi-location) path
+        for (MB_JSON *child = item->child; child; child = child->next)
+        {
+            MB_String childPath = path;
+            childPath += firebase_pgm_str_1; // "/"
+            childPath += child->string ? child->string : "";
+            putPath(childPath, child);
+        }
+    }
+
+    if (item)
+        MB_JSON_Delete(item);
+}
+
+bool RTDBReplica::empty()
+{
+    firebase_mutex_guard guard(mutex);
+    return nodes.size() == 0;
+}
+
+bool RTDBReplica::read(const MB_String &path, MB_String &out)
+{
+    firebase_mutex_guard guard(mutex);
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        node_t &node = nodes[i];
+        MB_VECTOR<MB_String> keys;
+
+        if (!node.synced || !node.root || !relativeKeys(node.path, path, keys))
+            continue;
+
+        MB_JSON *item = node.root;
+
+        if (keys.size() == 0)
+        {
+            // the evicted children are not available
+            for (size_t j = 0; j < node.children.size(); j++)
+            {
+                if (node.children[j].evicted)
+                    return false;
+            }
+        }
+        else
+        {
+            child_t *child = getChild(node, keys[0], false);
+            if (child && child->evicted)
+                return false;
+
+            for (size_t j = 0; item && j < keys.size(); j++)
+                item = getItem(item, keys[j]);
+        }
+
+        // the missing node is read from the server
+        if (!item || MB_JSON_IsNull(item) || (MB_JSON_IsObject(item) && !item->child))
+            return false;
+
+        if (keys.size() > 0)
+            getChild(node, keys[0], true)->lastUse = ++tick;
+
+        char *buf = MB_JSON_PrintUnformatted(item);
+        if (!buf)
+            return false;
+
+        out = buf;
+        MB_JSON_free(buf);
+        return true;
+    }
+
+    return false;
+}
+
+void RTDBReplica::fill(const MB_String &path, const MB_String &payload)
+{
+    firebase_mutex_guard guard(mutex);
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        node_t &node = nodes[i];
+        MB_VECTOR<MB_String> keys;
+
+        // only the whole evicted child can be filled
+        if (!node.synced || !relativeKeys(node.path, path, keys) || keys.size() != 1)
+            continue;
+
+        child_t *child = getChild(node, keys[0], false);
+        if (!child || !child->evicted)
+            continue;
+
+        MB_JSON *item = MB_JSON_ParseWithLength(payload.c_str(), payload.length());
+        if (!item)
+            continue;
+
+        if (!putItem(node, keys, item))
+            reset(node);
+
+        update(node);
+    }
+}
+
+void RTDBReplica::setMaxSize(size_t size)
+{
+    firebase_mutex_guard guard(mutex);
+    maxSize = size;
+    evict();
+}
+
+RTDBReplica::node_t *RTDBReplica::find(uint32_t owner)
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].owner == owner)
+            return &nodes[i];
+    }
+    return nullptr;
+}
+
+RTDBReplica::child_t *RTDBReplica::getChild(node_t &node, const MB_String &key, bool create)
+{
+    for (size_t i = 0; i < node.children.size(); i++)
+    {
+        if (node.children[i].key == key)
+            return &node.children[i];
+    }
+
+    if (!create)
+        return nullptr;
+
+    child_t child;
+    child.key = key;
+    node.children.push_back(child);
+    return &node.children[node.children.size() - 1];
+}
+
+bool RTDBReplica::relativeKeys(const MB_String &basePath, const MB_String &path, MB_VECTOR<MB_String> &keys)
+{
+    MB_VECTOR<MB_String> base;
+    keys.clear();
+    splitPath(basePath, base);
+    splitPath(path, keys);
+
+    if (keys.size() < base.size())
+        return false;
+
+    for (size_t i = 0; i < base.size(); i++)
+    {
+        if (keys[i] != base[i])
+            return false;
+    }
+
+    keys.erase(keys.begin(), keys.begin() + base.size());
+    return true;
+}
+
+void RTDBReplica::splitPath(const MB_String &path, MB_VECTOR<MB_String> &keys)
+{
+    const char *p = path.c_str();
+    size_t start = 0, i = 0;
+
+    for (;; i++)
+    {
+        if (p[i] == '/' || p[i] == 0)
+        {
+            if (i > start)
+            {
+                MB_String key;
+                key.append(p + start, i - start);
+                keys.push_back(key);
+            }
+
+            if (p[i] == 0)
+                break;
+
+            start = i + 1;
+        }
+    }
+}
+
+MB_JSON *RTDBReplica::getItem(MB_JSON *parent, const MB_String &key)
+{
+    if (MB_JSON_IsObject(parent))
+        return MB_JSON_GetObjectItemCaseSensitive(parent, key.c_str());
+
+    if (MB_JSON_IsArray(parent) && key.length() > 0 && strspn(key.c_str(), "0123456789") == key.length())
+        return MB_JSON_GetArrayItem(parent, atoi(key.c_str()));
+
+    return nullptr;
+}
+
+bool RTDBReplica::putItem(node_t &node, MB_VECTOR<MB_String> &keys, MB_JSON *item)
+{
+    child_t *child = getChild(node, keys[0], false);
+
+    // the change inside the evicted child is ignored, the whole child value replaces the evicted child
+    if (child && child->evicted)
+    {
+        if (keys.size() > 1)
+        {
+            MB_JSON_Delete(item);
+            return true;
+        }
+        child->evicted = false;
+        child->lastUse = ++tick;
+    }
+
+    bool remove = MB_JSON_IsNull(item);
+
+    if (!node.root || (!MB_JSON_IsObject(node.root) && !MB_JSON_IsArray(node.root)))
+    {
+        MB_JSON_Delete(node.root);
+        node.root = MB_JSON_CreateObject();
+    }
+
+    // the parents of the changed node, the empty parents are removed as the server does
+    MB_VECTOR<MB_JSON *> parents;
+    MB_JSON *parent = node.root;
+
+    for (size_t i = 0; i + 1 < keys.size(); i++)
+    {
+        parents.push_back(parent);
+        MB_JSON *next = getItem(parent, keys[i]);
+
+        if (!next || (!MB_JSON_IsObject(next) && !MB_JSON_IsArray(next)))
+        {
+            if (remove)
+            {
+                MB_JSON_Delete(item);
+                return true;
+            }
+
+            if (!MB_JSON_IsObject(parent))
+            {
+                MB_JSON_Delete(item);
+                return false;
+            }
+
+            next = MB_JSON_CreateObject();
+            if (MB_JSON_HasObjectItem(parent, keys[i].c_str()))
+                MB_JSON_ReplaceItemInObjectCaseSensitive(parent, keys[i].c_str(), next);
+            else
+                MB_JSON_AddItemToObject(parent, keys[i].c_str(), next);
+        }
+
+        parent = next;
+    }
+
+    const char *key = keys[keys.size() - 1].c_str();
+
+    // the array items can't be removed or appended at the index of server's array
+    if (!MB_JSON_IsObject(parent))
+    {
+        int index = atoi(key);
+        bool ret = !remove && getItem(parent, key) && MB_JSON_ReplaceItemInArray(parent, index, item);
+        if (!ret)
+            MB_JSON_Delete(item);
+        return ret;
+    }
+
+    if (remove)
+    {
+        MB_JSON_Delete(item);
+        MB_JSON_DeleteItemFromObjectCaseSensitive(parent, key);
+
+        for (int i = parents.size() - 1; i >= 0 && !parent->child; i--)
+        {
+            MB_JSON_DeleteItemFromObjectCaseSensitive(parents[i], keys[i].c_str());
+            parent = parents[i];
+        }
+    }
+    else if (MB_JSON_HasObjectItem(parent, key))
+        MB_JSON_ReplaceItemInObjectCaseSensitive(parent, key, item);
+    else
+        MB_JSON_AddItemToObject(parent, key, item);
+
+    return true;
+}
+
+void RTDBReplica::putPath(const MB_String &path, MB_JSON *item)
+{
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        node_t &node = nodes[i];
+        MB_VECTOR<MB_String> keys;
+
+        if (!node.synced)
+            continue;
+
+        if (relativeKeys(node.path, path, keys))
+        {
+            if (!item)
+                evictPath(node, keys);
+            else if (keys.size() == 0)
+            {
+                reset(node);
+                node.root = MB_JSON_Duplicate(item, true);
+                node.synced = node.root != nullptr;
+            }
+            else if (!putItem(node, keys, MB_JSON_Duplicate(item, true)))
+                reset(node);
+        }
+        else if (relativeKeys(path, node.path, keys))
+        {
+            // the write at the parent of the stream path replaces the whole node
+            MB_JSON *value = item;
+            for (size_t j = 0; value && j < keys.size(); j++)
+                value = getItem(value, keys[j]);
+
+            bool known = item != nullptr;
+            reset(node);
+            if (known)
+            {
+                node.root = value ? MB_JSON_Duplicate(value, true) : MB_JSON_CreateNull();
+                node.synced = node.root != nullptr;
+            }
+        }
+        else
+            continue;
+
+        update(node);
+    }
+}
+
+bool RTDBReplica::strip(MB_JSON *item)
+{
+    MB_JSON *child = item->child;
+
+    while (child)
+    {
+        MB_JSON *next = child->next;
+
+        // the priority is not the part of the stream data, other metadata (e.g. ".sv") is resolved by the server
+        if (child->string && child->string[0] == '.')
+        {
+            if (strcmp_P(child->string, firebase_rtdb_pgm_str_2 /* ".priority" */) != 0)
+                return false;
+            MB_JSON_Delete(MB_JSON_DetachItemViaPointer(item, child));
+        }
+        else if (!strip(child))
+            return false;
+
+        child = next;
+    }
+
+    return true;
+}
+
+void RTDBReplica::evictPath(node_t &node, const MB_VECTOR<MB_String> &keys)
+{
+    if (!MB_JSON_IsObject(node.root))
+    {
+        reset(node);
+        return;
+    }
+
+    if (keys.size() == 0)
+    {
+        while (node.root->child)
+            evictItem(node, node.root->child);
+        return;
+    }
+
+    // the whole child is read from the server and filled again
+    getChild(node, keys[0], true)->evicted = true;
+
+    MB_JSON *item = getItem(node.root, keys[0]);
+    if (item)
+        evictItem(node, item);
+}
+
+void RTDBReplica::evictItem(node_t &node, MB_JSON *item)
+{
+    getChild(node, item->string, true)->evicted = true;
+
+    size_t size = estimate(item);
+    node.size -= size < node.size ? size : node.size;
+    total -= size < total ? size : total;
+
+    MB_JSON_Delete(MB_JSON_DetachItemViaPointer(node.root, item));
+}
+
+void RTDBReplica::reset(node_t &node)
+{
+    if (node.root)
+        MB_JSON_Delete(node.root);
+    node.root = nullptr;
+    node.synced = false;
+    node.children.clear();
+    total -= node.size < total ? node.size : total;
+    node.size = 0;
+}
+
+void RTDBReplica::update(node_t &node)
+{
+    total -= node.size < total ? node.size : total;
+    node.size = node.root ? estimate(node.root) : 0;
+    total += node.size;
+
+    // the children that were removed from the tree are not needed to track
+    for (size_t i = 0; i < node.children.size(); i++)
+    {
+        if (!node.children[i].evicted && !getItem(node.root, node.children[i].key))
+        {
+            node.children.erase(node.children.begin() + i);
+            i--;
+        }
+    }
+
+    evict();
+}
+
+void RTDBReplica::evict()
+{
+    while (total > maxSize)
+    {
+        node_t *node = nullptr;
+        MB_JSON *item = nullptr;
+        uint32_t lastUse = 0;
+
+        // the least recently read child of the object nodes
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            if (!nodes[i].synced || !MB_JSON_IsObject(nodes[i].root))
+                continue;
+
+            for (MB_JSON *c = nodes[i].root->child; c; c = c->next)
+            {
+                child_t *child = getChild(nodes[i], c->string, false);
+                uint32_t use = child ? child->lastUse : 0;
+                if (!item || use < lastUse)
+                {
+                    node = &nodes[i];
+                    item = c;
+                    lastUse = use;
+                }
+            }
+        }
+
+        if (!item)
+            break;
+
+        evictItem(*node, item);
+    }
+}
+
+size_t RTDBReplica::estimate(const MB_JSON *item)
+{
+    size_t size = sizeof(MB_JSON);
+
+    if (item->string)
+        size += strlen(item->string) + 1;
+    if (item->valuestring)
+        size += strlen(item->valuestring) + 1;
+
+    for (const MB_JSON *c = item->child; c; c = c->next)
+        size += estimate(c);
+
+    return size;
+}
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,114 @@
+/**
+ * Google's Firebase RTDBReplica class, RTDBReplica.h version 1.0.0
+ *
+ * Created October 17, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_REPLICA_H
+#define FIREBASE_RTDB_REPLICA_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+
+using namespace mb_string;
+
+/** The local replica of the streamed nodes.
+ *
+ * The put and patch events of the stream are applied to the JSON tree of its stream path
+ * which the get requests under that path are served from without network I/O.
+ *
+ * The replica is synced by the full data that sent by the server when the stream was connected,
+ * the children of the stream path that were not read recently are evicted when the replica size
+ * exceeds the limit and they will be filled again by the next network get of that child node.
+ *
+ * The successful writes of this device are applied to the replica before their stream events arrive,
+ * the write that its data is unknown (blob, file, async, server values) evicts the written child instead.
+ */
+class RTDBReplica
+{
+    friend class FB_RTDB;
+
+public:
+    RTDBReplica();
+    ~RTDBReplica();
+
+private:
+    struct child_t
+    {
+        MB_String key;
+        uint32_t lastUse = 0;
+        bool evicted = false;
+    };
+
+    struct node_t
+    {
+        // the address of the stream Firebase Data object
+        uint32_t owner = 0;
+        MB_String path;
+        MB_JSON *root = nullptr;
+        size_t size = 0;
+        bool synced = false;
+        MB_VECTOR<child_t> children;
+    };
+
+    MB_VECTOR<node_t> nodes;
+    size_t maxSize = FIREBASE_RTDB_REPLICA_MAX_SIZE;
+    size_t total = 0;
+    uint32_t tick = 0;
+    // the stream task updates the replica while other tasks read it
+    firebase_mutex mutex;
+
+    void add(uint32_t owner, const MB_String &path);
+    void remove(uint32_t owner);
+    void begin(uint32_t owner, const MB_String &path);
+    void invalidate(uint32_t owner);
+    void apply(uint32_t owner, const MB_String &event, const MB_String &path, const char *data, size_t len);
+    void write(const MB_String &path, bool patch, const char *data, size_t len);
+    bool empty();
+    bool read(const MB_String &path, MB_String &out);
+    void fill(const MB_String &path, const MB_String &payload);
+    void setMaxSize(size_t size);
+
+    node_t *find(uint32_t owner);
+    child_t *getChild(node_t &node, const MB_String &key, bool create);
+    bool relativeKeys(const MB_String &base, const MB_String &path, MB_VECTOR<MB_String> &keys);
+    void splitPath(const MB_String &path, MB_VECTOR<MB_String> &keys);
+    MB_JSON *getItem(MB_JSON *parent, const MB_String &key);
+    bool putItem(node_t &node, MB_VECTOR<MB_String> &keys, MB_JSON *item);
+    void putPath(const MB_String &path, MB_JSON *item);
+    bool strip(MB_JSON *item);
+    void evictPath(node_t &node, const MB_VECTOR<MB_String> &keys);
+    void evictItem(node_t &node, MB_JSON *item);
+    void reset(node_t &node);
+    void update(node_t &node);
+    void evict();
+    size_t estimate(const MB_JSON *item);
+};
+
+#endif
+
+#endif // ENABLE
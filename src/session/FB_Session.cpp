@@ -45,6 +45,22 @@ FirebaseData::FirebaseData(Client *client)
 
 FirebaseData::~FirebaseData()
 {
+    // remove from the session lists and wait for the task that is using this session
+    setSession(true, false);
+    removeQueueSession();
+    session.mutex.lock();
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+    firebase_rtdb_stream_queue_t &q = session.rtdb.stream_queue;
+    q.worker.lock();
+    if (q.json)
+        delete q.json;
+    q.json = nullptr;
+    if (q.arr)
+        delete q.arr;
+    q.arr = nullptr;
+    q.worker.unlock();
+#endif
 
     clear();
 
@@ -65,6 +81,8 @@ FirebaseData::~FirebaseData()
         delete session.jsonPtr;
         session.jsonPtr = nullptr;
     }
+
+    session.mutex.unlock();
 }
 
 void FirebaseData::setGenericClient(Client *client, FB_NetworkConnectionRequestCallback networkConnectionCB,
@@ -133,9 +151,11 @@ void FirebaseData::addSession(firebase_con_mode mode)
 
     if (sessionPtr.ptr == 0)
     {
+        Core.internal.session_mutex.lock();
         sessionPtr.ptr = toAddr(*this);
         Core.internal.sessions.push_back(sessionPtr);
         session.con_mode = mode;
+        Core.internal.session_mutex.unlock();
     }
 }
 
@@ -143,6 +163,8 @@ void FirebaseData::setSession(bool remove, bool status)
 {
     if (sessionPtr.ptr > 0)
     {
+        firebase_mutex_guard guard(Core.internal.session_mutex);
+
         for (size_t i = 0; i < Core.internal.sessions.size(); i++)
         {
             if (sessionPtr.ptr > 0 && Core.internal.sessions[i].ptr == sessionPtr.ptr)
@@ -172,8 +194,10 @@ void FirebaseData::addQueueSession()
 
     if (queueSessionPtr.ptr == 0)
     {
+        Core.internal.session_mutex.lock();
         queueSessionPtr.ptr = toAddr(*this);
         Core.internal.queueSessions.push_back(queueSessionPtr);
+        Core.internal.session_mutex.unlock();
     }
 }
 #endif
@@ -184,6 +208,7 @@ void FirebaseData::removeQueueSession()
 
     if (queueSessionPtr.ptr > 0)
     {
+        firebase_mutex_guard guard(Core.internal.session_mutex);
         for (size_t i = 0; i < Core.internal.queueSessions.size(); i++)
         {
             if (queueSessionPtr.ptr > 0 && Core.internal.queueSessions[i].ptr == queueSessionPtr.ptr)
@@ -196,6 +221,19 @@ void FirebaseData::removeQueueSession()
     }
 }
 
+FirebaseData *FirebaseData::lockSession(MB_VECTOR<firebase_session_info> &list, size_t index, bool streamWorker)
+{
+    firebase_mutex_guard guard(Core.internal.session_mutex);
+
+    FirebaseData *fbdo = index < list.size() ? addrTo<FirebaseData *>(list[index].ptr) : nullptr;
+
+    // the destructor removes the session from the list before taking its lock
+    if (fbdo && !fbdo->sessionMutex(streamWorker).tryLock())
+        return nullptr;
+
+    return fbdo;
+}
+
 // Double quotes string trim.
 void FirebaseData::setRaw(bool trim)
 {
@@ -532,6 +570,21 @@ bool FirebaseData::streamAvailable()
     return ret;
 }
 
+size_t FirebaseData::streamQueueDepth()
+{
+    return session.rtdb.stream_queue.count;
+}
+
+uint32_t FirebaseData::streamQueueDropped()
+{
+    return session.rtdb.stream_queue.dropped;
+}
+
+uint32_t FirebaseData::streamQueueCoalesced()
+{
+    return session.rtdb.stream_queue.coalesced;
+}
+
 bool FirebaseData::mismatchDataType()
 {
     return session.rtdb.data_mismatch;
@@ -621,6 +674,42 @@ bool FirebaseData::isKeepAlive()
     return tcpClient.isKeepAlive();
 }
 
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+void FirebaseData::setPipelining(bool enable, uint8_t maxInFlight)
+{
+    if (maxInFlight < 1)
+        maxInFlight = 1;
+    else if (maxInFlight > 16)
+        maxInFlight = 16;
+
+    // the in-flight responses can't be read in non-pipelining mode and
+    // the unread responses of previous async requests can't be matched in pipelining mode
+    if ((!enable && session.rtdb.pipeline.pending.size() > 0) || (enable && session.rtdb.async_count > 0))
+    {
+        session.rtdb.async_count = 0;
+        closeSession();
+    }
+
+    session.rtdb.pipeline.enable = enable;
+    session.rtdb.pipeline.max_in_flight = maxInFlight;
+}
+
+void FirebaseData::setAsyncResultCallback(RTDB_AsyncResultCallback callback)
+{
+    session.rtdb.pipeline.cb = callback;
+}
+
+uint32_t FirebaseData::asyncRequestID()
+{
+    return session.rtdb.pipeline.last_id;
+}
+
+size_t FirebaseData::pendingAsyncRequests()
+{
+    return session.rtdb.pipeline.pending.size();
+}
+#endif
+
 String FirebaseData::payload()
 {
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
@@ -855,6 +944,7 @@ void FirebaseData::setSecure()
         }
         else
         {
+            firebase_mutex_guard guard(Core.internal.file_mutex);
             if (!tcpClient.setCertFile(Core.config->cert.file.c_str(), mbfs_type Core.getCAFileStorage()))
                 tcpClient.setCACert(NULL);
         }
@@ -910,7 +1000,7 @@ bool FirebaseData::waitResponse(struct firebase_tcp_response_handler_t &tcpHandl
 
 bool FirebaseData::isConnected(unsigned long &dataTime)
 {
-    return reconnect(dataTime) && tcpClient.connected();
+    return reconnect(dataTime) && (tcpClient.connected() || tcpClient.available() > 0);
 }
 #if defined(ENABLE_GC_STORAGE) || defined(FIREBASE_ENABLE_GC_STORAGE)
 void FirebaseData::createResumableTask(struct fb_gcs_upload_resumable_task_info_t &ruTask,
@@ -975,10 +1065,15 @@ bool FirebaseData::readPayload(MB_String *chunkOut, struct firebase_tcp_response
                     int readIndex = 0;
                     while (readIndex < tcpHandler.chunkBufSize && tcpHandler.payloadRead + readIndex < tcpHandler.payloadLen)
                     {
-                        int r = tcpClient.read();
-                        if (r > -1)
-                            pChunk[readIndex++] = (char)r;
-                        if (!reconnect(tcpHandler.dataTime))
+                        int toRead = tcpHandler.chunkBufSize - readIndex;
+                        if (tcpHandler.payloadRead + readIndex + toRead > tcpHandler.payloadLen)
+                            toRead = tcpHandler.payloadLen - tcpHandler.payloadRead - readIndex;
+
+                        int r = tcpClient.readBytes(pChunk + readIndex, toRead);
+                        if (r > 0)
+                            readIndex += r;
+                        // check the connection only while waiting for data
+                        else if (!reconnect(tcpHandler.dataTime))
                             break;
                     }
                     tcpHandler.bufferAvailable = readIndex;
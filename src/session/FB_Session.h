@@ -659,6 +659,30 @@ public:
   bool streamAvailable();
 #endif
 
+  /** Get the number of stream events that are waiting in the stream event queue (RTDB only).
+   *
+   * @return The number of queued events.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  size_t streamQueueDepth();
+#endif
+
+  /** Get the number of stream events that were dropped because the stream event queue was full (RTDB only).
+   *
+   * @return The number of dropped events.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  uint32_t streamQueueDropped();
+#endif
+
+  /** Get the number of queued stream events that were replaced by the later put event of the same or parent path (RTDB only).
+   *
+   * @return The number of coalesced events.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  uint32_t streamQueueCoalesced();
+#endif
+
   /** Get the matching between data type that intends to get from/store to database and the server's return payload data type (RTDB only).
    *
    * @return Boolean type status indicates whether the type of data being get from/store to database
@@ -749,6 +773,49 @@ public:
    */
   bool isKeepAlive();
 
+  /** Enable or disable the pipelining of async RTDB requests (RTDB only).
+   *
+   * @param enable The boolean to enable/disable the pipelining.
+   * @param maxInFlight The maximum number of async requests that are sent and waiting for their responses (1 - 16).
+   *
+   * @note When enabled, the async requests (setAsync, pushAsync, updateNodeAsync, deleteNodeAsync etc.)
+   * are written on the same keep-alive connection without waiting for the previous responses.
+   * The responses are read in the order of requests and the results are reported via the callback
+   * function assigned by setAsyncResultCallback.
+   *
+   * The in-flight responses are read when the next request is sent and the number of in-flight requests
+   * reaches maxInFlight, or when Firebase.RTDB.processPipeline or Firebase.RTDB.flushPipeline is called.
+   *
+   * The non-async request on the same FirebaseData object waits for all in-flight responses before sending.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  void setPipelining(bool enable, uint8_t maxInFlight = 4);
+#endif
+
+  /** Set the callback function to get the result of each pipelined async request (RTDB only).
+   *
+   * @param callback The callback function that accepts RTDB_AsyncResultInfo data.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  void setAsyncResultCallback(RTDB_AsyncResultCallback callback);
+#endif
+
+  /** Get the ID of last pipelined async request that was sent (RTDB only).
+   *
+   * @return The request ID which is the same as RTDB_AsyncResultInfo.id in the result callback.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  uint32_t asyncRequestID();
+#endif
+
+  /** Get the number of pipelined async requests that are waiting for their responses (RTDB only).
+   *
+   * @return The number of in-flight requests.
+   */
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+  size_t pendingAsyncRequests();
+#endif
+
   Firebase_TCP_Client tcpClient;
 
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
@@ -890,6 +957,18 @@ private:
   int tcpWrite(const uint8_t *data, size_t size);
   void addQueueSession();
   void removeQueueSession();
+  /* get the session in the list and take its lock (or the stream event queue worker lock),
+     return nullptr when it was removed or is being used by other task */
+  static FirebaseData *lockSession(MB_VECTOR<firebase_session_info> &list, size_t index, bool streamWorker = false);
+  void unlockSession(bool streamWorker = false) { sessionMutex(streamWorker).unlock(); }
+  firebase_mutex &sessionMutex(bool streamWorker)
+  {
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+    if (streamWorker)
+      return session.rtdb.stream_queue.worker;
+#endif
+    return session.mutex;
+  }
   void setRaw(bool trim);
   bool configReady()
   {
@@ -0,0 +1,60 @@
+/**
+ * The host implementation of the Arduino core functions.
+ */
+
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+#include <random>
+
+HardwareSerial Serial;
+
+static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+static std::mt19937 &rng()
+{
+    static thread_local std::mt19937 gen(1);
+    return gen;
+}
+
+long random(long max)
+{
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max)
+{
+    if (max <= min)
+        return min;
+    return min + (long)(rng()() % (unsigned long)(max - min));
+}
+
+void randomSeed(unsigned long seed)
+{
+    rng().seed(seed);
+}
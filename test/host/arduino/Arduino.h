@@ -0,0 +1,386 @@
+/**
+ * The minimal Arduino core for building the library on the host (Linux/macOS) for the tests and benchmarks.
+ *
+ * Only the API that is used by the library is provided, the time functions use the monotonic clock
+ * and Serial prints to stdout.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <cstddef>
+#include <string>
+
+using std::nullptr_t;
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcat_P strcat
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strstr_P strstr
+#define memcpy_P memcpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+#define HEX 16
+#define DEC 10
+
+class __FlashStringHelper;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+class String
+{
+public:
+    String() {}
+    String(const char *s) : s(s ? s : "") {}
+    String(const char *s, size_t len) : s(s, len) {}
+    String(const __FlashStringHelper *s) : s(reinterpret_cast<const char *>(s)) {}
+    String(const String &other) : s(other.s) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int v, unsigned char base = 10) { fromInt(v, base); }
+    explicit String(unsigned int v, unsigned char base = 10) { fromUInt(v, base); }
+    explicit String(long v, unsigned char base = 10) { fromInt(v, base); }
+    explicit String(unsigned long v, unsigned char base = 10) { fromUInt(v, base); }
+    explicit String(long long v, unsigned char base = 10) { fromInt(v, base); }
+    explicit String(unsigned long long v, unsigned char base = 10) { fromUInt(v, base); }
+    explicit String(float v, unsigned char digits = 2) { fromDouble(v, digits); }
+    explicit String(double v, unsigned char digits = 2) { fromDouble(v, digits); }
+
+    String &operator=(const String &other)
+    {
+        s = other.s;
+        return *this;
+    }
+    String &operator=(const char *c)
+    {
+        s = c ? c : "";
+        return *this;
+    }
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool reserve(unsigned int size)
+    {
+        s.reserve(size);
+        return true;
+    }
+    char charAt(unsigned int i) const { return i < s.length() ? s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char &operator[](unsigned int i) { return s[i]; }
+    void setCharAt(unsigned int i, char c)
+    {
+        if (i < s.length())
+            s[i] = c;
+    }
+
+    bool concat(const String &o)
+    {
+        s += o.s;
+        return true;
+    }
+    bool concat(const char *c)
+    {
+        s += c ? c : "";
+        return true;
+    }
+    bool concat(const char *c, unsigned int len)
+    {
+        s.append(c, len);
+        return true;
+    }
+    bool concat(char c)
+    {
+        s += c;
+        return true;
+    }
+    bool concat(int v) { return concat(String(v)); }
+    bool concat(unsigned int v) { return concat(String(v)); }
+    bool concat(long v) { return concat(String(v)); }
+    bool concat(unsigned long v) { return concat(String(v)); }
+    bool concat(float v) { return concat(String(v)); }
+    bool concat(double v) { return concat(String(v)); }
+
+    template <typename T>
+    String &operator+=(const T &v)
+    {
+        concat(v);
+        return *this;
+    }
+
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *c) const { return s == (c ? c : ""); }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *c) const { return !(*this == c); }
+    bool operator<(const String &o) const { return s < o.s; }
+    bool equals(const String &o) const { return s == o.s; }
+    bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(s.find(c, from)); }
+    int indexOf(const String &str, unsigned int from = 0) const { return find(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return find(s.rfind(c)); }
+    int lastIndexOf(const String &str) const { return find(s.rfind(str.s)); }
+    bool startsWith(const String &p) const { return s.compare(0, p.s.length(), p.s) == 0; }
+    bool endsWith(const String &p) const { return s.length() >= p.s.length() && s.compare(s.length() - p.s.length(), p.s.length(), p.s) == 0; }
+
+    String substring(unsigned int from) const { return from < s.length() ? String(s.c_str() + from) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+        {
+            unsigned int t = from;
+            from = to;
+            to = t;
+        }
+        if (from >= s.length())
+            return String();
+        if (to > s.length())
+            to = s.length();
+        return String(s.c_str() + from, to - from);
+    }
+
+    void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+    void remove(unsigned int index, unsigned int count)
+    {
+        if (index < s.length())
+            s.erase(index, count);
+    }
+    void replace(const String &from, const String &to)
+    {
+        if (from.s.empty())
+            return;
+        size_t pos = 0;
+        while ((pos = s.find(from.s, pos)) != std::string::npos)
+        {
+            s.replace(pos, from.s.length(), to.s);
+            pos += to.s.length();
+        }
+    }
+    void trim()
+    {
+        size_t b = 0, e = s.length();
+        while (b < e && isspace((unsigned char)s[b]))
+            b++;
+        while (e > b && isspace((unsigned char)s[e - 1]))
+            e--;
+        s = s.substr(b, e - b);
+    }
+    void toLowerCase()
+    {
+        for (auto &c : s)
+            c = tolower((unsigned char)c);
+    }
+    void toUpperCase()
+    {
+        for (auto &c : s)
+            c = toupper((unsigned char)c);
+    }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+
+private:
+    std::string s;
+
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    void fromInt(long long v, unsigned char base)
+    {
+        if (v < 0 && base == 10)
+        {
+            fromUInt((unsigned long long)(-v), base);
+            s.insert(s.begin(), '-');
+        }
+        else
+            fromUInt((unsigned long long)v, base);
+    }
+    void fromUInt(unsigned long long v, unsigned char base)
+    {
+        char buf[72];
+        int i = sizeof(buf) - 1;
+        buf[i] = 0;
+        do
+        {
+            int d = v % base;
+            buf[--i] = d < 10 ? '0' + d : 'a' + d - 10;
+            v /= base;
+        } while (v);
+        s = buf + i;
+    }
+    void fromDouble(double v, unsigned char digits)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        s = buf;
+    }
+};
+
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const String &s) : String(s) {}
+    StringSumHelper(const char *p) : String(p) {}
+};
+
+inline StringSumHelper operator+(const StringSumHelper &lhs, const String &rhs)
+{
+    StringSumHelper a(lhs);
+    a.concat(rhs);
+    return a;
+}
+
+inline StringSumHelper operator+(const String &lhs, const char *rhs)
+{
+    StringSumHelper a(lhs);
+    a.concat(rhs);
+    return a;
+}
+
+class Printable;
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*buf++);
+        return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    int getWriteError() { return write_error; }
+    void clearWriteError() { setWriteError(0); }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned int v, int base = DEC) { return print(String(v, base)); }
+    size_t print(long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        return len > 0 ? write(buf, (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1) : 0;
+    }
+
+protected:
+    void setWriteError(int err = 1) { write_error = err; }
+
+private:
+    int write_error = 0;
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() { return _timeout; }
+
+    size_t readBytes(uint8_t *buf, size_t len)
+    {
+        size_t n = 0;
+        unsigned long ms = millis();
+        while (n < len && millis() - ms < _timeout)
+        {
+            int c = read();
+            if (c < 0)
+            {
+                yield();
+                continue;
+            }
+            buf[n++] = (uint8_t)c;
+            ms = millis();
+        }
+        return n;
+    }
+    size_t readBytes(char *buf, size_t len) { return readBytes((uint8_t *)buf, len); }
+
+    String readStringUntil(char terminator)
+    {
+        String s;
+        int c;
+        while ((c = read()) >= 0 && c != terminator)
+            s.concat((char)c);
+        return s;
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t *buf, size_t size) override { return fwrite(buf, 1, size, stdout); }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#include "IPAddress.h"
+
+#endif
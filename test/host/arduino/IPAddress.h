@@ -0,0 +1,33 @@
+/**
+ * The host IPAddress, the IPv4 address only.
+ */
+
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+class IPAddress
+{
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+    IPAddress(uint32_t address) : addr(address) {}
+    operator uint32_t() const { return addr; }
+    bool operator==(const IPAddress &other) const { return addr == other.addr; }
+    uint8_t operator[](int index) const { return (addr >> (index * 8)) & 0xff; }
+    bool fromString(const char *address)
+    {
+        unsigned int a, b, c, d;
+        if (sscanf(address, "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+            return false;
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+
+private:
+    uint32_t addr = 0;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * The append throughput of MB_String.
+ *
+ * MB_String is compared with the model of its previous append (MB_String 1.2.12, the length was
+ * counted by strlen, the buffer was reallocated to the 4-byte rounded size on each append and
+ * there was no inline buffer) and with std::string.
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include <chrono>
+#include <string>
+
+class LegacyString
+{
+public:
+    ~LegacyString() { free(buf); }
+
+    size_t length() const { return buf ? strlen(buf) : 0; }
+
+    LegacyString &operator+=(const char *s)
+    {
+        size_t len = strlen(s), slen = length();
+        if (reserve(slen + len))
+            strcat(buf, s);
+        return *this;
+    }
+
+    LegacyString &operator+=(char c)
+    {
+        size_t slen = length();
+        if (reserve(slen + 1))
+        {
+            buf[slen] = c;
+            buf[slen + 1] = 0;
+        }
+        return *this;
+    }
+
+    LegacyString &operator+=(int v)
+    {
+        char num[12];
+        snprintf(num, sizeof(num), "%d", v);
+        return *this += num;
+    }
+
+private:
+    char *buf = nullptr;
+    size_t bufLen = 0;
+
+    bool reserve(size_t len)
+    {
+        size_t n = (len + 1 + 3) / 4 * 4;
+        if (n <= bufLen)
+            return true;
+
+        char *p = (char *)realloc(buf, n);
+        if (!p)
+            return false;
+        if (!buf)
+            p[0] = 0;
+        buf = p;
+        bufLen = n;
+        return true;
+    }
+};
+
+static size_t stdLength(const std::string &s) { return s.length(); }
+template <typename T>
+static size_t stdLength(const T &s) { return s.length(); }
+
+static std::string &appendInt(std::string &s, int v) { return s += std::to_string(v); }
+template <typename T>
+static T &appendInt(T &s, int v) { return s += v; }
+
+// 20000 single characters into one string
+template <typename T>
+static size_t appendChars()
+{
+    T s;
+    for (int i = 0; i < 20000; i++)
+        s += (char)('a' + i % 26);
+    return stdLength(s);
+}
+
+// 2000 tokens of the JSON payload into one string
+template <typename T>
+static size_t appendTokens()
+{
+    T s;
+    for (int i = 0; i < 2000; i++)
+    {
+        s += "\"key\":";
+        appendInt(s, i);
+        s += ',';
+    }
+    return stdLength(s);
+}
+
+// the short path strings that are created and destroyed
+template <typename T>
+static size_t shortStrings()
+{
+    size_t total = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        T s;
+        s += "/users/";
+        appendInt(s, i % 1000);
+        total += stdLength(s);
+    }
+    return total;
+}
+
+template <typename T>
+static void run(const char *name, const char *type, size_t (*fn)(), size_t expected, int rounds)
+{
+    size_t len = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+        len = fn();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    HOST_CHECK(len == expected);
+    printf("%-14s %-12s %10.1f us/round\n", name, type, (double)us / rounds);
+}
+
+template <typename T>
+static void runAll(const char *type, int rounds)
+{
+    run<T>("chars", type, appendChars<T>, 20000, rounds);
+    run<T>("tokens", type, appendTokens<T>, appendTokens<std::string>(), rounds);
+    run<T>("short strings", type, shortStrings<T>, shortStrings<std::string>(), rounds);
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             runAll<LegacyString>("legacy", 20);
+                             runAll<MB_String>("MB_String", 200);
+                             runAll<std::string>("std::string", 200);
+                         });
+}
@@ -0,0 +1,131 @@
+/**
+ * The wake-ups, CPU time and event latency of the stream task with 8 streams.
+ *
+ * The readiness wait (poll on the stream sockets) is compared with the polling loop that the task
+ * falls back to when the sockets are hidden, each stream is read every stream_task_delay_ms (10 ms).
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include "loopback.h"
+#include <chrono>
+#include <time.h>
+
+#define STREAMS 8
+
+FirebaseData fbdo[STREAMS];
+SocketClient clients[STREAMS];
+std::atomic<int> received(0);
+std::atomic<long long> sentAt(0), latency(0);
+
+static long long nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpuMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+template <int I>
+static void networkStatus() { fbdo[I].setNetworkStatus(true); }
+
+template <int I>
+static void setClients()
+{
+    fbdo[I].setGenericClient(&clients[I], [] {}, networkStatus<I>);
+    setClients<I + 1>();
+}
+
+template <>
+void setClients<STREAMS>() {}
+
+static void streamCallback(FIREBASE_STREAM_CLASS data)
+{
+    if (strcmp(data.eventType().c_str(), "put") == 0)
+    {
+        latency += nowUs() - sentAt;
+        received++;
+    }
+}
+
+static size_t totalPolls()
+{
+    size_t n = 0;
+    for (int i = 0; i < STREAMS; i++)
+        n += clients[i].polls();
+    return n;
+}
+
+static void run(const char *type, StreamServer &server, bool waitable)
+{
+    for (int i = 0; i < STREAMS; i++)
+        clients[i].setWaitable(waitable);
+    delay(1200);
+
+    // idle streams
+    size_t polls = totalPolls();
+    double cpu = cpuMs();
+    delay(3000);
+    cpu = cpuMs() - cpu;
+    polls = totalPolls() - polls;
+
+    // the events at random times, the data is changed as the callback is not called for the same data
+    const int events = 100;
+    received = 0;
+    latency = 0;
+    for (int i = 0; i < events; i++)
+    {
+        char path[8], data[48];
+        snprintf(path, sizeof(path), "/s%d", i % STREAMS);
+        snprintf(data, sizeof(data), "{\"path\":\"/\",\"data\":%d}", i + (waitable ? events : 0));
+        sentAt = nowUs();
+        HOST_CHECK(server.send(path, "put", data));
+        unsigned long ms = millis();
+        while (received <= i && millis() - ms < 2000)
+            delayMicroseconds(50);
+        delay(random(0, 20));
+    }
+    HOST_CHECK(received == events);
+
+    printf("%-10s idle %7.1f reads/s %7.2f ms cpu/s   event latency %7.3f ms\n", type, polls / 3.0, cpu / 3.0,
+           received > 0 ? latency / 1000.0 / received : 0.0);
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             StreamServer server;
+
+                             // the config and auth are deleted with Firebase at exit
+                             FirebaseConfig *config = new FirebaseConfig();
+                             config->database_url = "mock.firebaseio.com";
+                             config->signer.tokens.legacy_token = "secret";
+                             Firebase.begin(config, new FirebaseAuth());
+
+                             setClients<0>();
+
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 clients[i].setPort(server.port());
+                                 char path[8];
+                                 snprintf(path, sizeof(path), "/s%d", i);
+                                 HOST_CHECK(Firebase.beginStream(fbdo[i], path));
+                                 Firebase.setStreamCallback(fbdo[i], streamCallback, nullptr);
+                             }
+
+                             run("polling", server, false);
+                             run("readiness", server, true);
+
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 Firebase.removeStreamCallback(fbdo[i]);
+                                 Firebase.endStream(fbdo[i]);
+                             }
+                             delay(FIREBASE_STREAM_IDLE_CHECK_INTERVAL + 200);
+                         });
+}
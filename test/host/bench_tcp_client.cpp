@@ -0,0 +1,84 @@
+/**
+ * The line read throughput of Firebase_TCP_Client.
+ *
+ * The buffered readLine is compared with the model of the previous reader that took each byte by
+ * a read call through the SSL client. The stream events are delivered in the segments of TCP size.
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include "mock_client.h"
+#include <chrono>
+#include <string>
+
+// The stream of put events, about 1 MB
+static std::string events()
+{
+    std::string s;
+    for (int i = 0; i < 10000; i++)
+    {
+        s += "event: put\n";
+        s += "data: {\"path\":\"/sensors/" + std::to_string(i % 100) + "\",\"data\":{\"t\":" + std::to_string(i) +
+             ",\"h\":45.5,\"name\":\"living room\"}}\n\n";
+    }
+    return s;
+}
+
+static int byteReadLine(ESP_SSLClient *client, MB_String &buf)
+{
+    int idx = 0;
+    while (client->available())
+    {
+        int c = client->read();
+        if (c < 0)
+            break;
+        buf += (char)c;
+        idx++;
+        if (c == '\n')
+            break;
+    }
+    return idx;
+}
+
+static int bufferedReadLine(Firebase_TCP_Client *tcp, MB_String &buf) { return tcp->readLine(buf); }
+
+template <typename T>
+static void run(const char *type, T *client, MockClient &mock, const std::string &data, int (*fn)(T *, MB_String &), int rounds)
+{
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        mock.push(data);
+        MB_String s;
+        int n;
+        while ((n = fn(client, s)) > 0)
+        {
+            total += n;
+            s.clear();
+        }
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    HOST_CHECK(total == data.length() * rounds);
+    printf("%-14s %-12s %10.1f us/MB\n", "read lines", type, (double)us / rounds * 1048576 / data.length());
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             std::string data = events();
+
+                             MockClient mock;
+                             mock.setSegmentSize(1460);
+
+                             Firebase_TCP_Client tcp;
+                             tcp.setClient(&mock, [] {}, [] {});
+                             tcp.setNetworkStatus(true);
+                             HOST_CHECK(tcp.connect("mock", 80));
+
+                             run("byte read", tcp.client(), mock, data, byteReadLine, 5);
+                             run("readLine", &tcp, mock, data, bufferedReadLine, 20);
+                         });
+}
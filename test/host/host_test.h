@@ -0,0 +1,110 @@
+/**
+ * The helpers for the host tests and benchmarks.
+ *
+ * The library keeps the object addresses in 32-bit integers as on the 32-bit devices. To run it on
+ * the 64-bit host, the executables are linked without PIE, the heap is kept in the program break
+ * (below 4 GB) and the test threads run on the stacks that were mapped below 2 GB.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <pthread.h>
+#include <malloc.h>
+#include <sys/mman.h>
+
+#define HOST_TEST_STACK_SIZE (1024 * 1024)
+
+static std::atomic<int> host_test_failures(0);
+
+#define HOST_CHECK(cond)                                                            \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            host_test_failures++;                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                           \
+    } while (0)
+
+// Keep all allocations in the main heap arena that grows from the program break.
+static void host_test_init_heap()
+{
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_ARENA_MAX, 1);
+}
+
+static void *host_test_thread_entry(void *arg)
+{
+    std::function<void()> *fn = reinterpret_cast<std::function<void()> *>(arg);
+    (*fn)();
+    return nullptr;
+}
+
+/** The thread that runs on the stack below 2 GB.
+ */
+class HostThread
+{
+public:
+    HostThread(std::function<void()> fn) : fn(new std::function<void()>(fn))
+    {
+        stack = mmap(nullptr, HOST_TEST_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+        if (stack == MAP_FAILED)
+        {
+            perror("mmap");
+            exit(1);
+        }
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstack(&attr, stack, HOST_TEST_STACK_SIZE);
+        if (pthread_create(&thread, &attr, host_test_thread_entry, this->fn) != 0)
+        {
+            perror("pthread_create");
+            exit(1);
+        }
+        pthread_attr_destroy(&attr);
+    }
+
+    ~HostThread() { join(); }
+
+    void join()
+    {
+        if (!fn)
+            return;
+        pthread_join(thread, nullptr);
+        munmap(stack, HOST_TEST_STACK_SIZE);
+        delete fn;
+        fn = nullptr;
+    }
+
+private:
+    pthread_t thread;
+    void *stack = nullptr;
+    std::function<void()> *fn = nullptr;
+};
+
+/** Run the test body on the low stack thread and return the process exit code.
+ */
+static int host_test_run(std::function<void()> body)
+{
+    host_test_init_heap();
+    {
+        HostThread t(body);
+    }
+
+    if (host_test_failures > 0)
+    {
+        fprintf(stderr, "FAILED: %d check(s)\n", (int)host_test_failures);
+        return 1;
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * The socket Client and the event stream server on the loopback interface for the host tests and
+ * benchmarks of the stream task.
+ *
+ * The server answers each request with the event stream headers and keeps the connection, the
+ * events are sent to the stream of the request path.
+ */
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class SocketClient : public Client
+{
+public:
+    // The client connects to the loopback port whatever the host is.
+    SocketClient(uint16_t port = 0) : port(port) {}
+    ~SocketClient() { stop(); }
+
+    void setPort(uint16_t p) { port = p; }
+
+    // Hide the socket from the stream task which then falls back to the polling delay.
+    void setWaitable(bool enable) { waitable = enable; }
+
+    // The number of available calls, the reads of the session by the stream task.
+    size_t polls() const { return pollCount; }
+
+    int connect(IPAddress, uint16_t) override { return connect("", 0); }
+    int connect(const char *, uint16_t) override
+    {
+        stop();
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock < 0)
+            return 0;
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            stop();
+            return 0;
+        }
+
+        int one = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return 1;
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        if (sock < 0)
+            return 0;
+        ssize_t n = send(sock, buf, size, MSG_NOSIGNAL);
+        return n > 0 ? n : 0;
+    }
+
+    int available() override
+    {
+        pollCount++;
+        int n = 0;
+        if (sock < 0 || ioctl(sock, FIONREAD, &n) != 0)
+            return 0;
+        return n;
+    }
+
+    int read() override
+    {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+
+    int read(uint8_t *buf, size_t size) override
+    {
+        if (sock < 0)
+            return -1;
+        ssize_t n = recv(sock, buf, size, MSG_DONTWAIT);
+        return n > 0 ? n : -1;
+    }
+
+    int peek() override
+    {
+        uint8_t c;
+        return sock >= 0 && recv(sock, &c, 1, MSG_DONTWAIT | MSG_PEEK) == 1 ? c : -1;
+    }
+
+    void flush() override {}
+
+    void stop() override
+    {
+        if (sock >= 0)
+            ::close(sock);
+        sock = -1;
+    }
+
+    uint8_t connected() override
+    {
+        if (sock < 0)
+            return 0;
+        uint8_t c;
+        ssize_t n = recv(sock, &c, 1, MSG_DONTWAIT | MSG_PEEK);
+        return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+    }
+
+    operator bool() override { return connected(); }
+
+    int fd() const override { return waitable ? sock : -1; }
+
+private:
+    int sock = -1;
+    uint16_t port;
+    bool waitable = true;
+    std::atomic<size_t> pollCount{0};
+};
+
+class StreamServer
+{
+public:
+    StreamServer()
+    {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (listener < 0 || bind(listener, (struct sockaddr *)&addr, len) != 0 || listen(listener, 16) != 0 ||
+            getsockname(listener, (struct sockaddr *)&addr, &len) != 0)
+        {
+            perror("StreamServer");
+            exit(1);
+        }
+        listenPort = ntohs(addr.sin_port);
+        thread = std::thread([this] { run(); });
+    }
+
+    ~StreamServer()
+    {
+        running = false;
+        thread.join();
+        ::close(listener);
+        for (auto &c : streams)
+            ::close(c.second);
+    }
+
+    uint16_t port() const { return listenPort; }
+
+    // The number of streams that were connected.
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return streams.size();
+    }
+
+    // Send the event to the stream of path, returns false when the stream is not connected.
+    bool send(const std::string &path, const std::string &event, const std::string &data)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = streams.find(path);
+        if (it == streams.end())
+            return false;
+        std::string s = "event: " + event + "\ndata: " + data + "\n\n";
+        return ::send(it->second, s.data(), s.length(), MSG_NOSIGNAL) == (ssize_t)s.length();
+    }
+
+private:
+    int listener = -1;
+    uint16_t listenPort = 0;
+    std::atomic<bool> running{true};
+    std::thread thread;
+    std::mutex mutex;
+    std::map<std::string, int> streams;
+
+    void run()
+    {
+        while (running)
+        {
+            struct pollfd pfd = {listener, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0)
+                continue;
+
+            int sock = accept(listener, nullptr, nullptr);
+            if (sock < 0)
+                continue;
+
+            int one = 1;
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            // GET /path.json?... HTTP/1.1
+            std::string request;
+            char buf[512];
+            while (request.find("\r\n\r\n") == std::string::npos)
+            {
+                ssize_t n = recv(sock, buf, sizeof(buf), 0);
+                if (n <= 0)
+                    break;
+                request.append(buf, n);
+            }
+
+            size_t begin = request.find(' ') + 1, end = request.find(".json", begin);
+            if (begin == 0 || end == std::string::npos)
+            {
+                ::close(sock);
+                continue;
+            }
+
+            std::string header = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                                 "Cache-Control: no-cache\r\n\r\n";
+            ::send(sock, header.data(), header.length(), MSG_NOSIGNAL);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string path = request.substr(begin, end - begin);
+            if (streams.count(path))
+                ::close(streams[path]);
+            streams[path] = sock;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * The Client that replies the canned HTTP responses for the host tests and benchmarks.
+ *
+ * The request is passed to the handler when its headers and Content-Length body were written,
+ * the response is read back in the segments of the given size as the TCP stack delivers.
+ * The server can close the connection after the response while its bytes are still readable.
+ */
+
+#ifndef MOCK_CLIENT_H
+#define MOCK_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <functional>
+#include <mutex>
+#include <string>
+
+class MockClient : public Client
+{
+public:
+    // Returns the response of request, the empty string for no response.
+    typedef std::function<std::string(const std::string &request)> handler_t;
+
+    MockClient(handler_t handler = nullptr) : handler(handler) {}
+
+    void setHandler(handler_t h)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        handler = h;
+    }
+
+    // The largest number of bytes that each available and read returns, 0 for no limit.
+    void setSegmentSize(size_t size) { segment = size; }
+
+    // Close the connection (from server) after the response.
+    void setCloseAfterResponse(bool close) { closeAfterResponse = close; }
+
+    // Refuse the connections and close the current one.
+    void setOffline(bool enable)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        offline = enable;
+        if (offline)
+            open = false;
+    }
+
+    // Queue the data to read as it was sent by the server.
+    void push(const std::string &data, bool close = false)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        rx += data;
+        if (close)
+            open = false;
+    }
+
+    // Close the connection from server, the queued data is still readable.
+    void close()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        open = false;
+    }
+
+    size_t connections() const { return connects; }
+    size_t requests() const { return handled; }
+
+    int connect(IPAddress, uint16_t) override { return connect("", 0); }
+    int connect(const char *, uint16_t) override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (offline)
+            return 0;
+        rx.clear();
+        rxPos = 0;
+        tx.clear();
+        open = true;
+        connects++;
+        return 1;
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (!open)
+            return 0;
+
+        tx.append((const char *)buf, size);
+        while (handler && completeRequest())
+            ;
+        return size;
+    }
+
+    int available() override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        size_t n = rx.length() - rxPos;
+        return segment > 0 && n > segment ? segment : n;
+    }
+
+    int read() override
+    {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+
+    int read(uint8_t *buf, size_t size) override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        size_t n = available();
+        if (n == 0)
+            return -1;
+        if (n > size)
+            n = size;
+        memcpy(buf, rx.data() + rxPos, n);
+        rxPos += n;
+        if (rxPos == rx.length())
+        {
+            rx.clear();
+            rxPos = 0;
+        }
+        return n;
+    }
+
+    int peek() override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return rxPos < rx.length() ? (uint8_t)rx[rxPos] : -1;
+    }
+
+    void flush() override {}
+
+    void stop() override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        open = false;
+        rx.clear();
+        rxPos = 0;
+    }
+
+    uint8_t connected() override
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        return open;
+    }
+
+    operator bool() override { return connected(); }
+
+private:
+    handler_t handler;
+    std::recursive_mutex mutex;
+    std::string rx, tx;
+    size_t rxPos = 0;
+    size_t segment = 0;
+    size_t connects = 0;
+    size_t handled = 0;
+    bool open = false;
+    bool closeAfterResponse = false;
+    bool offline = false;
+
+    // Pass the complete request in tx to handler.
+    bool completeRequest()
+    {
+        size_t end = tx.find("\r\n\r\n");
+        if (end == std::string::npos)
+            return false;
+
+        size_t len = 0;
+        size_t p = tx.find("Content-Length:");
+        if (p == std::string::npos)
+            p = tx.find("content-length:");
+        if (p != std::string::npos && p < end)
+            len = strtoul(tx.c_str() + p + 15, nullptr, 10);
+
+        if (tx.length() < end + 4 + len)
+            return false;
+
+        std::string request = tx.substr(0, end + 4 + len);
+        tx.erase(0, end + 4 + len);
+        handled++;
+
+        std::string response = handler(request);
+        rx += response;
+        if (closeAfterResponse)
+            open = false;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * The requests of separate FirebaseData objects in parallel threads with the stream task and the
+ * error queue processing.
+ *
+ * Each session has its own mock client of the in-memory database, the stream is served by the
+ * loopback event stream server.
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include "mock_client.h"
+#include "loopback.h"
+#include <map>
+
+#define WORKERS 4
+#define ROUNDS 200
+#define QUEUED 10
+
+// The database that answers the PUT and GET of the integer values.
+class MemoryDatabase
+{
+public:
+    std::string handle(const std::string &request)
+    {
+        size_t begin = request.find(' ') + 1, end = request.find(".json", begin);
+        std::string method = request.substr(0, begin - 1), path = request.substr(begin, end - begin);
+        std::string body = request.substr(request.find("\r\n\r\n") + 4);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (method == "PUT")
+            values[path] = body;
+        else if (values.count(path))
+            body = values[path];
+        else
+            body = "null";
+
+        return "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nConnection: keep-alive\r\n"
+               "Content-Length: " +
+               std::to_string(body.length()) + "\r\n\r\n" + body;
+    }
+
+    std::string get(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return values.count(path) ? values[path] : "";
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::string> values;
+};
+
+MemoryDatabase db;
+
+// the workers, the stream and the queue sessions
+FirebaseData fbdo[WORKERS + 2];
+MockClient clients[WORKERS + 1];
+SocketClient streamClient;
+
+FirebaseData &queueData = fbdo[WORKERS];
+FirebaseData &streamData = fbdo[WORKERS + 1];
+
+std::atomic<int> streamEvents(0), streamLast(-1);
+
+template <int I>
+static void networkStatus() { fbdo[I].setNetworkStatus(true); }
+
+template <int I>
+static void setClients()
+{
+    if (I < WORKERS + 1)
+    {
+        clients[I].setHandler([](const std::string &request) { return db.handle(request); });
+        fbdo[I].setGenericClient(&clients[I], [] {}, networkStatus<I>);
+    }
+    else
+        fbdo[I].setGenericClient(&streamClient, [] {}, networkStatus<I>);
+    setClients<I + 1>();
+}
+
+template <>
+void setClients<WORKERS + 2>() {}
+
+static void streamCallback(FIREBASE_STREAM_CLASS data)
+{
+    if (strcmp(data.eventType().c_str(), "put") == 0 && data.intData() > streamLast)
+    {
+        streamLast = data.intData();
+        streamEvents++;
+    }
+}
+
+static void worker(int id)
+{
+    FirebaseData &f = fbdo[id];
+    for (int k = 0; k < ROUNDS; k++)
+    {
+        MB_String path = "/w";
+        path += id;
+        path += "/";
+        path += k % 5;
+
+        if (!Firebase.setInt(f, path.c_str(), k * WORKERS + id))
+        {
+            HOST_CHECK(false);
+            fprintf(stderr, "worker %d set: %s\n", id, f.errorReason().c_str());
+            return;
+        }
+
+        HOST_CHECK(Firebase.getInt(f, path.c_str()));
+        HOST_CHECK(f.intData() == k * WORKERS + id);
+    }
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             StreamServer server;
+                             streamClient.setPort(server.port());
+
+                             // the config and auth are deleted with Firebase at exit
+                             FirebaseConfig *config = new FirebaseConfig();
+                             config->database_url = "mock.firebaseio.com";
+                             config->signer.tokens.legacy_token = "secret";
+                             Firebase.begin(config, new FirebaseAuth());
+
+                             setClients<0>();
+
+                             // the writes while offline are kept in the error queue
+                             Firebase.setMaxRetry(queueData, 1);
+                             Firebase.setMaxErrorQueue(queueData, QUEUED);
+                             clients[WORKERS].setOffline(true);
+                             for (int i = 0; i < QUEUED; i++)
+                             {
+                                 MB_String path = "/q/";
+                                 path += i;
+                                 HOST_CHECK(!Firebase.setInt(queueData, path.c_str(), i));
+                             }
+                             HOST_CHECK(Firebase.errorQueueCount(queueData) == QUEUED);
+                             clients[WORKERS].setOffline(false);
+
+                             HOST_CHECK(Firebase.beginStream(streamData, "/stream"));
+                             Firebase.setStreamCallback(streamData, streamCallback, nullptr);
+
+                             {
+                                 std::vector<HostThread *> threads;
+                                 for (int i = 0; i < WORKERS; i++)
+                                     threads.push_back(new HostThread([i] { worker(i); }));
+
+                                 // the error queue is processed in parallel with the workers
+                                 threads.push_back(new HostThread([]
+                                                                  {
+                                                                      unsigned long ms = millis();
+                                                                      while (Firebase.errorQueueCount(queueData) > 0 && millis() - ms < 10000)
+                                                                      {
+                                                                          Firebase.processErrorQueue(queueData);
+                                                                          delay(1);
+                                                                      }
+                                                                  }));
+
+                                 // the stream events while the requests are running
+                                 for (int i = 0; i < 50; i++)
+                                 {
+                                     MB_String data = "{\"path\":\"/\",\"data\":";
+                                     data += i;
+                                     data += "}";
+                                     HOST_CHECK(server.send("/stream", "put", data.c_str()));
+                                     delay(2);
+                                 }
+
+                                 for (HostThread *t : threads)
+                                     delete t;
+                             }
+
+                             HOST_CHECK(Firebase.errorQueueCount(queueData) == 0);
+                             for (int i = 0; i < QUEUED; i++)
+                                 HOST_CHECK(db.get("/q/" + std::to_string(i)) == std::to_string(i));
+
+                             for (int id = 0; id < WORKERS; id++)
+                             {
+                                 for (int k = ROUNDS - 5; k < ROUNDS; k++)
+                                     HOST_CHECK(db.get("/w" + std::to_string(id) + "/" + std::to_string(k % 5)) ==
+                                                std::to_string(k * WORKERS + id));
+                             }
+
+                             // the events may be merged when they arrived together, the last one is delivered
+                             unsigned long ms = millis();
+                             while (streamLast != 49 && millis() - ms < 3000)
+                                 delay(1);
+                             HOST_CHECK(streamLast == 49);
+                             HOST_CHECK(streamEvents > 0);
+
+                             Firebase.removeStreamCallback(streamData);
+                             Firebase.endStream(streamData);
+                             delay(FIREBASE_STREAM_IDLE_CHECK_INTERVAL + 200);
+                         });
+}
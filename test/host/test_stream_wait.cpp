@@ -0,0 +1,128 @@
+/**
+ * The stream task of host build that waits for the stream sockets with poll.
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include "loopback.h"
+
+#define STREAMS 8
+
+FirebaseData fbdo[STREAMS];
+SocketClient clients[STREAMS];
+std::atomic<int> received[STREAMS];
+std::atomic<int> lastValue[STREAMS];
+
+template <int I>
+static void networkStatus() { fbdo[I].setNetworkStatus(true); }
+
+template <int I>
+static void setClients()
+{
+    fbdo[I].setGenericClient(&clients[I], [] {}, networkStatus<I>);
+    setClients<I + 1>();
+}
+
+template <>
+void setClients<STREAMS>() {}
+
+static void streamCallback(FIREBASE_STREAM_CLASS data)
+{
+    int i = atoi(data.streamPath().c_str() + 2);
+    if (i >= 0 && i < STREAMS && strcmp(data.eventType().c_str(), "put") == 0)
+    {
+        lastValue[i] = data.intData();
+        received[i]++;
+    }
+}
+
+static bool waitFor(std::function<bool()> cond, int ms)
+{
+    unsigned long start = millis();
+    while (!cond())
+    {
+        if (millis() - start > (unsigned long)ms)
+            return false;
+        delay(1);
+    }
+    return true;
+}
+
+static size_t totalPolls()
+{
+    size_t n = 0;
+    for (int i = 0; i < STREAMS; i++)
+        n += clients[i].polls();
+    return n;
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             StreamServer server;
+
+                             // the config and auth are deleted with Firebase at exit
+                             FirebaseConfig *config = new FirebaseConfig();
+                             config->database_url = "mock.firebaseio.com";
+                             config->signer.tokens.legacy_token = "secret";
+                             Firebase.begin(config, new FirebaseAuth());
+
+                             setClients<0>();
+
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 clients[i].setPort(server.port());
+                                 MB_String path = "/s";
+                                 path += i;
+                                 HOST_CHECK(Firebase.beginStream(fbdo[i], path.c_str()));
+                                 Firebase.setStreamCallback(fbdo[i], streamCallback, nullptr);
+                             }
+
+                             HOST_CHECK(waitFor([&] { return server.size() == STREAMS; }, 2000));
+
+                             // the events of all streams are delivered
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 MB_String path = "/s";
+                                 path += i;
+                                 MB_String data = "{\"path\":\"/\",\"data\":";
+                                 data += i + 100;
+                                 data += "}";
+                                 HOST_CHECK(server.send(path.c_str(), "put", data.c_str()));
+                             }
+
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 HOST_CHECK(waitFor([&] { return received[i] > 0; }, 2000));
+                                 HOST_CHECK(lastValue[i] == i + 100);
+                             }
+
+                             // The idle streams are read once per idle check interval (1 s) instead of each
+                             // polling delay (10 ms), the client of 8 streams was polled about 3200 times in 2 s
+                             // by the polling loop.
+                             size_t polls = totalPolls();
+                             delay(2000);
+                             polls = totalPolls() - polls;
+                             HOST_CHECK(polls < 200);
+
+                             // the event wakes the stream task before the idle check interval
+                             int count = received[3];
+                             unsigned long ms = millis();
+                             HOST_CHECK(server.send("/s3", "put", "{\"path\":\"/\",\"data\":7}"));
+                             HOST_CHECK(waitFor([&] { return received[3] > count; }, 2000));
+                             HOST_CHECK(millis() - ms < FIREBASE_STREAM_IDLE_CHECK_INTERVAL / 2);
+                             HOST_CHECK(lastValue[3] == 7);
+
+                             // the stream task exits when no stream left
+                             for (int i = 0; i < STREAMS; i++)
+                             {
+                                 Firebase.removeStreamCallback(fbdo[i]);
+                                 Firebase.endStream(fbdo[i]);
+                             }
+                             delay(100);
+                             polls = totalPolls();
+                             delay(FIREBASE_STREAM_IDLE_CHECK_INTERVAL + 200);
+                             HOST_CHECK(totalPolls() == polls);
+                         });
+}
@@ -0,0 +1,172 @@
+/**
+ * The receive buffer of Firebase_TCP_Client with the canned responses of mock client.
+ */
+
+#include <Firebase.h>
+#include "host_test.h"
+#include "mock_client.h"
+
+static const char *lines[] = {"HTTP/1.1 200 OK\r\n", "Content-Type: application/json\r\n", "\r\n",
+                              "event: put\n", "data: {\"path\":\"/\",\"data\":1}\n", "\n"};
+
+static std::string joined()
+{
+    std::string s;
+    for (const char *l : lines)
+        s += l;
+    return s;
+}
+
+static void connectClient(Firebase_TCP_Client &tcp, MockClient &mock)
+{
+    tcp.setClient(&mock, [] {}, [] {});
+    tcp.setNetworkStatus(true);
+    HOST_CHECK(tcp.connect("mock", 80));
+}
+
+// The lines are read in full whatever the segment and buffer sizes are.
+static void testReadLine(size_t segment, int bufSize)
+{
+    MockClient mock;
+    Firebase_TCP_Client tcp;
+    tcp.setReadBufferSize(bufSize);
+    connectClient(tcp, mock);
+    mock.setSegmentSize(segment);
+    mock.push(joined());
+
+    for (const char *l : lines)
+    {
+        MB_String s;
+        int n = tcp.readLine(s);
+        HOST_CHECK(n == (int)strlen(l));
+        HOST_CHECK(strcmp(s.c_str(), l) == 0);
+    }
+    HOST_CHECK(tcp.available() == 0);
+}
+
+// The line longer than the caller buffer is returned in parts.
+static void testReadLineLimit()
+{
+    MockClient mock;
+    Firebase_TCP_Client tcp;
+    connectClient(tcp, mock);
+    mock.setSegmentSize(5);
+    mock.push("0123456789abcdef\nxy\n");
+
+    char buf[8];
+    HOST_CHECK(tcp.readLine(buf, 8) == 8 && memcmp(buf, "01234567", 8) == 0);
+    HOST_CHECK(tcp.readLine(buf, 8) == 8 && memcmp(buf, "89abcdef", 8) == 0);
+    HOST_CHECK(tcp.readLine(buf, 8) == 1 && buf[0] == '\n');
+    HOST_CHECK(tcp.readLine(buf, 8) == 3 && memcmp(buf, "xy\n", 3) == 0);
+}
+
+// The buffered bytes, the large reads that bypass the buffer and the single byte reads keep the order.
+static void testReadBytes()
+{
+    MockClient mock;
+    Firebase_TCP_Client tcp;
+    tcp.setReadBufferSize(64);
+    connectClient(tcp, mock);
+
+    std::string data;
+    for (int i = 0; i < 1000; i++)
+        data += (char)('a' + i % 26);
+    mock.push(data);
+
+    std::string out;
+    uint8_t buf[300];
+
+    HOST_CHECK(tcp.peek() == 'a');
+    out += (char)tcp.read();
+
+    int n = tcp.readBytes(buf, 10);
+    out.append((const char *)buf, n);
+
+    while (tcp.available() > 0)
+    {
+        n = tcp.readBytes(buf, sizeof(buf));
+        HOST_CHECK(n > 0);
+        out.append((const char *)buf, n);
+    }
+
+    HOST_CHECK(out == data);
+}
+
+// The server closed the connection while its last bytes are still readable.
+static void testClosedWithBufferedData()
+{
+    MockClient mock;
+    Firebase_TCP_Client tcp;
+    connectClient(tcp, mock);
+    mock.setSegmentSize(7);
+    mock.push("event: cancel\ndata: null\n\n", true);
+
+    HOST_CHECK(!tcp.connected());
+    HOST_CHECK(tcp.available() > 0);
+
+    MB_String s;
+    tcp.readLine(s);
+    HOST_CHECK(strcmp(s.c_str(), "event: cancel\n") == 0);
+
+    // the rest was moved into the receive buffer
+    HOST_CHECK(tcp.available() > 0);
+    s.clear();
+    tcp.readLine(s);
+    HOST_CHECK(strcmp(s.c_str(), "data: null\n") == 0);
+    s.clear();
+    tcp.readLine(s);
+    HOST_CHECK(strcmp(s.c_str(), "\n") == 0);
+    HOST_CHECK(tcp.available() == 0);
+}
+
+FirebaseData fbdo;
+
+// The server of get requests that closes the connection after each response.
+MockClient server([](const std::string &request)
+                  {
+                      HOST_CHECK(request.compare(0, 12, "GET /x.json?") == 0);
+                      return std::string("HTTP/1.1 200 OK\r\nConnection: close\r\n"
+                                         "Content-Type: application/json; charset=utf-8\r\n"
+                                         "Content-Length: 2\r\n\r\n42");
+                  });
+
+// The response that the server sent before closing the connection is handled.
+static void testResponseAfterClose(size_t segment)
+{
+    server.setSegmentSize(segment);
+    size_t requests = server.requests();
+
+    for (int i = 0; i < 3; i++)
+    {
+        HOST_CHECK(Firebase.getInt(fbdo, "/x"));
+        HOST_CHECK(fbdo.intData() == 42);
+    }
+    HOST_CHECK(server.requests() == requests + 3);
+}
+
+int main()
+{
+    return host_test_run([]
+                         {
+                             testReadLine(0, 1024);
+                             testReadLine(1, 1024);
+                             testReadLine(7, 64);
+                             testReadLine(1500, 64);
+                             testReadLineLimit();
+                             testReadBytes();
+                             testClosedWithBufferedData();
+
+                             // the config and auth are deleted with Firebase at exit
+                             FirebaseConfig *config = new FirebaseConfig();
+                             config->database_url = "mock.firebaseio.com";
+                             config->signer.tokens.legacy_token = "secret";
+                             Firebase.begin(config, new FirebaseAuth());
+
+                             // the same client is used by fbdo until it was destroyed
+                             server.setCloseAfterResponse(true);
+                             fbdo.setGenericClient(&server, [] {}, [] { fbdo.setNetworkStatus(true); });
+
+                             testResponseAfterClose(0);
+                             testResponseAfterClose(3);
+                         });
+}